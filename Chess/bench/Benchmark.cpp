@@ -0,0 +1,115 @@
+#include "Benchmark.h"
+#include <chrono>
+#include <iomanip>
+#include <thread>
+
+//======================================================================
+BenchmarkRunner::BenchmarkRunner(double minSeconds)
+    : m_minSeconds(minSeconds), m_checksum(0)
+{
+}
+
+//======================================================================
+// one measurement right away tells which events the kernel allows
+bool BenchmarkRunner::enableHardwareCounters(std::string& error)
+{
+    m_hardwareCounters = std::make_unique<HardwareCounters>();
+    bool isAllowed = m_hardwareCounters->start();
+    m_hardwareCounters->stop();
+    m_countersError = error = m_hardwareCounters->getError();
+    if (!isAllowed) {
+        m_hardwareCounters.reset();
+    }
+    return isAllowed;
+}
+
+//======================================================================
+void BenchmarkRunner::add(const std::string& name, Operation operation)
+{
+    m_benchmarks.push_back({ name, std::move(operation) });
+}
+
+//======================================================================
+// doubles the batch until it runs for the minimum time, that batch is the result
+void BenchmarkRunner::run(const std::string& filter)
+{
+    m_results.clear();
+    for (const Benchmark& benchmark : m_benchmarks) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        for (uint64_t iterations = 1;; iterations *= 2) {
+            if (m_hardwareCounters) {
+                m_hardwareCounters->start();
+            }
+            auto start = std::chrono::steady_clock::now();
+            m_checksum += benchmark.operation(iterations);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (m_hardwareCounters) {
+                result.counters = m_hardwareCounters->stop();
+            }
+            if (elapsed.count() >= m_minSeconds) {
+                result.iterations = iterations;
+                result.nsPerOperation = elapsed.count() * 1e9 / iterations;
+                result.operationsPerSecond = iterations / elapsed.count();
+                break;
+            }
+        }
+        m_results.push_back(result);
+    }
+}
+
+//======================================================================
+const std::vector<BenchmarkResult>& BenchmarkRunner::getResults() const
+{
+    return m_results;
+}
+
+//======================================================================
+void BenchmarkRunner::writeJson(std::ostream& output) const
+{
+    output << "{\n  \"context\": {\"min_time_s\": " << m_minSeconds << ", \"hardware_threads\": "
+        << std::thread::hardware_concurrency() << ", \"checksum\": " << m_checksum;
+    if (!m_countersError.empty()) {
+        output << ", \"counters_left_out\": \"" << escapeJson(m_countersError) << "\"";
+    }
+    output << "},\n"
+        << "  \"benchmarks\": [";
+    for (size_t i = 0; i < m_results.size(); i++) {
+        const BenchmarkResult& result = m_results[i];
+        output << (i > 0 ? "," : "") << "\n    {\"name\": \"" << escapeJson(result.name)
+            << "\", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << std::fixed
+            << std::setprecision(2) << result.nsPerOperation << ", \"ops_per_sec\": " << std::setprecision(0)
+            << result.operationsPerSecond;
+        if (result.counters.hasAny()) {
+            output << ", \"counters\": {" << std::setprecision(2);
+            const char* separator = "";
+            for (int event = 0; event < HARDWARE_EVENT_COUNT; event++) {
+                if (result.counters.isAvailable[event]) {
+                    output << separator << "\"" << HardwareCounts::getEventName(static_cast<HardwareEvent>(event))
+                        << "_per_op\": " << static_cast<double>(result.counters.values[event]) / result.iterations;
+                    separator = ", ";
+                }
+            }
+            output << "}";
+        }
+        output << "}" << std::defaultfloat;
+    }
+    output << "\n  ]\n}\n";
+}
+
+//======================================================================
+std::string BenchmarkRunner::escapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Utils/HardwareCounters.h"
+
+// Timing of one benchmark: the last batch, which ran for at least the minimum time
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOperation = 0;
+    double operationsPerSecond = 0;
+    // Counts of that batch, when counters are on and the kernel allows them
+    HardwareCounts counters;
+};
+
+/*
+* class BenchmarkRunner
+* =====================
+* Small in-tree harness in the spirit of Google Benchmark. A benchmark is a
+* function running a given number of operations and returning a checksum
+* of their results, so the compiler can't drop the work. The batch size
+* doubles from 1 until a batch takes the minimum time; that batch gives
+* the time per operation.
+*/
+class BenchmarkRunner {
+public:
+    // Runs iterations operations, returns a value depending on all of them
+    using Operation = std::function<uint64_t(uint64_t iterations)>;
+
+    explicit BenchmarkRunner(double minSeconds = 0.5);
+
+    // Counts perf_event counters around each batch, false with the reason when none is allowed
+    bool enableHardwareCounters(std::string& error);
+
+    void add(const std::string& name, Operation operation);
+
+    // Runs the benchmarks whose name contains filter (all when empty), in the order added
+    void run(const std::string& filter = "");
+
+    const std::vector<BenchmarkResult>& getResults() const;
+
+    // {"context": {...}, "benchmarks": [{"name", "iterations", "ns_per_op", "ops_per_sec"}, ...]},
+    // each benchmark with "counters": {"<event>_per_op", ...} when counted
+    void writeJson(std::ostream& output) const;
+
+private:
+    struct Benchmark {
+        std::string name;
+        Operation operation;
+    };
+
+    double m_minSeconds;
+    std::vector<Benchmark> m_benchmarks;
+    std::vector<BenchmarkResult> m_results;
+    uint64_t m_checksum;
+    std::unique_ptr<HardwareCounters> m_hardwareCounters;
+    std::string m_countersError;
+
+    static std::string escapeJson(const std::string& text);
+};
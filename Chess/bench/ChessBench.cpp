@@ -0,0 +1,188 @@
+#include "Benchmark.h"
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/FastRandom.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "PieceFactory/PieceFactory.h"
+#include "PriorityQueue.h"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    // Opening, middlegame with castling rights, tactical middlegame, pawn endgame
+    const char* POSITIONS[] = {
+        ChessUtils::START_FEN,
+        "r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    const int RECOMMEND_DEPTH = 2;
+    const char PIECE_SYMBOLS[] = "KQRBNPkqrbnp";
+    const size_t QUEUE_MOVE_COUNT = 256;
+    // Pushes between two clears, so the queue sees both accepted and rejected moves
+    const uint64_t PUSHES_PER_CLEAR = 64;
+
+    // The board's notation: row letter, column digit (see Board::notationToCoordinates)
+    std::string toNotation(int row, int col) {
+        return { static_cast<char>('A' + row), static_cast<char>('1' + col) };
+    }
+
+    // One fixed position with its legal moves, and a recommender searching it
+    struct BenchPosition {
+        std::unique_ptr<Board> board;
+        std::vector<BoardMove> moves;
+        // The legal moves, then the same moves backwards, which are mostly illegal
+        std::vector<BoardMove> candidates;
+        std::vector<ChessMove> chessMoves;
+        std::unique_ptr<MoveRecommender> recommender;
+    };
+
+    std::vector<BenchPosition> buildPositions() {
+        std::vector<BenchPosition> positions;
+        for (const char* fen : POSITIONS) {
+            BenchPosition position;
+            position.board = std::make_unique<Board>(Fen::parse(fen));
+            position.board->generateLegalMoves(position.moves);
+            position.candidates = position.moves;
+            for (const BoardMove& move : position.moves) {
+                position.candidates.push_back({ move.destRow, move.destCol, move.srcRow, move.srcCol });
+                position.chessMoves.emplace_back(toNotation(move.srcRow, move.srcCol),
+                    toNotation(move.destRow, move.destCol), position.board->getIsWhiteTurn());
+            }
+            position.recommender = std::make_unique<MoveRecommender>(*position.board, RECOMMEND_DEPTH);
+            position.recommender->setRandomnessEnabled(false);
+            positions.push_back(std::move(position));
+        }
+        return positions;
+    }
+
+    // Calls operation(position, move index) round robin over every legal move of every position
+    template <typename PerMove>
+    uint64_t forEachMove(std::vector<BenchPosition>& positions, uint64_t iterations, PerMove&& perMove) {
+        uint64_t checksum = 0;
+        size_t positionIndex = 0;
+        size_t moveIndex = 0;
+        for (uint64_t i = 0; i < iterations; i++) {
+            BenchPosition& position = positions[positionIndex];
+            checksum += perMove(position, moveIndex);
+            if (++moveIndex == position.moves.size()) {
+                moveIndex = 0;
+                positionIndex = (positionIndex + 1) % positions.size();
+            }
+        }
+        return checksum;
+    }
+
+    void addBenchmarks(BenchmarkRunner& runner, std::vector<BenchPosition>& positions) {
+        runner.add("Board::validateMove", [&positions](uint64_t iterations) {
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < iterations; i++) {
+                BenchPosition& position = positions[i % positions.size()];
+                const BoardMove& move = position.candidates[i / positions.size() % position.candidates.size()];
+                checksum += position.board->validateMove(move.srcRow, move.srcCol, move.destRow, move.destCol);
+            }
+            return checksum;
+        });
+
+        runner.add("Board::makeMove+undoMove", [&positions](uint64_t iterations) {
+            return forEachMove(positions, iterations, [](BenchPosition& position, size_t i) {
+                position.board->makeMove(position.moves[i]);
+                uint64_t hash = position.board->getHash();
+                position.board->undoMove();
+                return hash;
+            });
+        });
+
+        runner.add("Board::saveState+restoreState", [&positions](uint64_t iterations) {
+            return forEachMove(positions, iterations, [](BenchPosition& position, size_t) {
+                BoardState state = position.board->saveState();
+                position.board->restoreState(state);
+                return position.board->getHash();
+            });
+        });
+
+        runner.add("Board::isKingInCheck", [&positions](uint64_t iterations) {
+            return forEachMove(positions, iterations, [](BenchPosition& position, size_t i) {
+                return static_cast<uint64_t>(position.board->isKingInCheck(i % 2 == 0));
+            });
+        });
+
+        runner.add("PieceFactory::createPiece", [](uint64_t iterations) {
+            const size_t symbolCount = sizeof(PIECE_SYMBOLS) - 1;
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < iterations; i++) {
+                checksum += PieceFactory::createPiece(PIECE_SYMBOLS[i % symbolCount], 0, 0)->getSymbol();
+            }
+            return checksum;
+        });
+
+        runner.add("PriorityQueue::push", [](uint64_t iterations) {
+            FastRandom random(1);
+            std::vector<ChessMove> moves;
+            for (size_t i = 0; i < QUEUE_MOVE_COUNT; i++) {
+                moves.emplace_back(toNotation(i % 8, i / 8 % 8), toNotation(i / 8 % 8, i % 8), true,
+                    random.nextInt(1000));
+            }
+            PriorityQueue<ChessMove, ChessMoveComparator> queue(ChessUtils::MAX_QUEUE_SIZE);
+            uint64_t checksum = 0;
+            for (uint64_t i = 0; i < iterations; i++) {
+                if (i % PUSHES_PER_CLEAR == 0) {
+                    queue.clear();
+                }
+                checksum += queue.push(moves[i % QUEUE_MOVE_COUNT]);
+            }
+            return checksum;
+        });
+
+        runner.add("MoveRecommender::evaluatePosition", [&positions](uint64_t iterations) {
+            return forEachMove(positions, iterations, [](BenchPosition& position, size_t i) {
+                return static_cast<uint64_t>(position.recommender->evaluateMove(*position.board,
+                    position.chessMoves[i]));
+            });
+        });
+
+        runner.add("MoveRecommender::recommendMoves/depth:" + std::to_string(RECOMMEND_DEPTH),
+            [&positions](uint64_t iterations) {
+                uint64_t checksum = 0;
+                for (uint64_t i = 0; i < iterations; i++) {
+                    BenchPosition& position = positions[i % positions.size()];
+                    position.recommender->recommendMoves();
+                    checksum += position.recommender->getRecommendations().size();
+                }
+                return checksum;
+            });
+    }
+}
+
+// chess_bench [--filter <text>] [--min-time <seconds>] [--counters], JSON results on stdout
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    double minSeconds = 0.5;
+    bool isCounting = false;
+    for (int i = 1; i < argc; i++) {
+        isCounting |= std::string(argv[i]) == "--counters";
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--filter") {
+            filter = argv[i + 1];
+        }
+        else if (std::string(argv[i]) == "--min-time") {
+            minSeconds = std::stod(argv[i + 1]);
+        }
+    }
+
+    std::vector<BenchPosition> positions = buildPositions();
+    BenchmarkRunner runner(minSeconds);
+    std::string countersError;
+    if (isCounting && !runner.enableHardwareCounters(countersError)) {
+        std::cerr << "Counters unavailable: " << countersError << std::endl;
+    }
+    addBenchmarks(runner, positions);
+    runner.run(filter);
+    runner.writeJson(std::cout);
+    return 0;
+}
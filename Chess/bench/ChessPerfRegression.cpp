@@ -0,0 +1,160 @@
+#include "PerfRegression.h"
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Epd/EpdRunner.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef CHESS_BUILD_TYPE
+#define CHESS_BUILD_TYPE ""
+#endif
+
+namespace {
+    // Leaf counts of the move generator: position and depth
+    const std::pair<const char*, int> PERFT_POSITIONS[] = {
+        { ChessUtils::START_FEN, 3 },
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2 },
+        { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3 }
+    };
+    const int RECOMMEND_DEPTH = 2;
+    const int BOARD_CONSTRUCTIONS = 2000;
+    // ctest skips the test on this exit code, see the top-level CMakeLists.txt
+    const int SKIP_EXIT_CODE = 77;
+
+    struct RecommendPosition {
+        std::unique_ptr<Board> board;
+        std::unique_ptr<MoveRecommender> recommender;
+    };
+
+    std::vector<std::string> loadFens(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Error: positions file " + path + " not found");
+        }
+        std::vector<std::string> fens;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                fens.push_back(EpdRunner::parseLine(line).fen);
+            }
+        }
+        return fens;
+    }
+
+    void addWorkloads(PerfRegressionRunner& runner, const std::vector<std::string>& fens,
+        std::vector<RecommendPosition>& positions) {
+        runner.add("perft", []() {
+            uint64_t nodes = 0;
+            for (const auto& [fen, depth] : PERFT_POSITIONS) {
+                Board board(Fen::parse(fen));
+                nodes += board.perft(depth);
+            }
+            return nodes;
+        });
+
+        runner.add("recommend/depth:" + std::to_string(RECOMMEND_DEPTH), [&positions]() {
+            uint64_t nodes = 0;
+            for (RecommendPosition& position : positions) {
+                position.recommender->recommendMoves();
+                nodes += position.recommender->getSearchStats().nodes;
+            }
+            return nodes;
+        });
+
+        runner.add("board construction", [&fens]() {
+            uint64_t boards = 0;
+            for (int i = 0; i < BOARD_CONSTRUCTIONS; i++) {
+                Board startBoard(ChessUtils::START_BOARD);
+                Board fenBoard(Fen::parse(fens[i % fens.size()]));
+                boards += 2;
+            }
+            return boards;
+        });
+    }
+
+    int run(int argc, char* argv[]) {
+        std::string baselinePath = "bench/perf/baseline.json";
+        std::string epdPath = "bench/perf/recommend.epd";
+        int repetitions = 5;
+        double minTolerance = 0.3;
+        bool isUpdate = false;
+        for (int i = 1; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--update") {
+                isUpdate = true;
+            }
+            else if (i + 1 < argc && option == "--baseline") {
+                baselinePath = argv[++i];
+            }
+            else if (i + 1 < argc && option == "--epd") {
+                epdPath = argv[++i];
+            }
+            else if (i + 1 < argc && option == "--repetitions") {
+                repetitions = std::stoi(argv[++i]);
+            }
+            else if (i + 1 < argc && option == "--tolerance") {
+                minTolerance = std::stod(argv[++i]);
+            }
+        }
+
+        std::string buildType = CHESS_BUILD_TYPE;
+        if (buildType.empty()) {
+            buildType = "default";
+        }
+
+        std::vector<std::string> fens = loadFens(epdPath);
+        std::vector<RecommendPosition> positions;
+        for (const std::string& fen : fens) {
+            RecommendPosition position;
+            position.board = std::make_unique<Board>(Fen::parse(fen));
+            position.recommender = std::make_unique<MoveRecommender>(*position.board, RECOMMEND_DEPTH);
+            position.recommender->setRandomnessEnabled(false);
+            positions.push_back(std::move(position));
+        }
+
+        PerfRegressionRunner runner(repetitions, minTolerance);
+        addWorkloads(runner, fens, positions);
+        runner.run();
+
+        if (isUpdate) {
+            PerfBaseline baseline;
+            if (std::ifstream(baselinePath)) {
+                baseline = PerfRegressionRunner::loadBaseline(baselinePath);
+            }
+            runner.storeInto(baseline, buildType);
+            PerfRegressionRunner::saveBaseline(baseline, baselinePath);
+            std::cout << "baseline of the " << buildType << " build written to " << baselinePath << std::endl;
+            return 0;
+        }
+
+        PerfBaseline baseline = PerfRegressionRunner::loadBaseline(baselinePath);
+        auto entry = baseline.find(buildType);
+        if (entry == baseline.end()) {
+            std::cout << "no baseline for the " << buildType << " build in " << baselinePath
+                << ", record one with --update" << std::endl;
+            return SKIP_EXIT_CODE;
+        }
+        std::cout << "build " << buildType << ", " << repetitions << " runs per workload\n";
+        int regressionCount = runner.compare(entry->second, std::cout);
+        std::cout << (regressionCount == 0 ? "no regression" : std::to_string(regressionCount) + " regression(s)")
+            << std::endl;
+        return regressionCount == 0 ? 0 : 1;
+    }
+}
+
+// perf_regression [--baseline <json>] [--epd <file>] [--repetitions <n>] [--tolerance <fraction>] [--update]
+// Exit code 0 without regression, 1 on a regression or an error, 77 without a baseline for this build type
+int main(int argc, char* argv[])
+{
+    try {
+        return run(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
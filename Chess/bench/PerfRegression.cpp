@@ -0,0 +1,302 @@
+#include "PerfRegression.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    const uint64_t CALIBRATION_OPERATIONS = 5000000;
+    // Tolerance in measured noise units, a relative speed within 4 deviations isn't a regression
+    const double NOISE_MULTIPLIER = 4;
+
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    // Integer mixing that doesn't touch memory, stands for the speed of the machine and build
+    uint64_t runCalibration() {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (uint64_t i = 0; i < CALIBRATION_OPERATIONS; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            state += i;
+        }
+        // The result is used, so the loop can't be removed
+        return CALIBRATION_OPERATIONS + (state == 0 ? 1 : 0);
+    }
+
+    double getSeconds(const std::function<uint64_t()>& workload, uint64_t& work) {
+        auto start = std::chrono::steady_clock::now();
+        work = workload();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::max(elapsed.count(), 1e-9);
+    }
+
+    // Reader of the baseline file: objects, strings and numbers only
+    class BaselineParser {
+    public:
+        explicit BaselineParser(const std::string& text) : m_text(text), m_position(0) {}
+
+        PerfBaseline parse() {
+            PerfBaseline baseline;
+            parseObject([&](const std::string& buildType) {
+                parseObject([&](const std::string& workload) {
+                    parseObject([&](const std::string& metric) {
+                        baseline[buildType][workload][metric] = parseNumber();
+                    });
+                });
+            });
+            skipSpace();
+            if (m_position != m_text.size()) {
+                fail("unexpected text after the baseline");
+            }
+            return baseline;
+        }
+
+    private:
+        const std::string& m_text;
+        size_t m_position;
+
+        void parseObject(const std::function<void(const std::string&)>& parseValue) {
+            expect('{');
+            skipSpace();
+            if (peek() == '}') {
+                m_position++;
+                return;
+            }
+            while (true) {
+                std::string key = parseString();
+                expect(':');
+                parseValue(key);
+                skipSpace();
+                if (peek() == ',') {
+                    m_position++;
+                    continue;
+                }
+                expect('}');
+                return;
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+            size_t end = m_text.find('"', m_position);
+            if (end == std::string::npos) {
+                fail("unterminated string");
+            }
+            std::string value = m_text.substr(m_position, end - m_position);
+            m_position = end + 1;
+            return value;
+        }
+
+        double parseNumber() {
+            skipSpace();
+            size_t length = 0;
+            double value = 0;
+            try {
+                value = std::stod(m_text.substr(m_position), &length);
+            }
+            catch (const std::exception&) {
+                fail("number expected");
+            }
+            m_position += length;
+            return value;
+        }
+
+        void expect(char c) {
+            skipSpace();
+            if (peek() != c) {
+                fail(std::string("'") + c + "' expected");
+            }
+            m_position++;
+        }
+
+        char peek() const {
+            return m_position < m_text.size() ? m_text[m_position] : '\0';
+        }
+
+        void skipSpace() {
+            while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+                m_position++;
+            }
+        }
+
+        [[noreturn]] void fail(const std::string& message) const {
+            throw std::runtime_error("Error: baseline file, offset " + std::to_string(m_position) + ": " + message);
+        }
+    };
+}
+
+//======================================================================
+PerfRegressionRunner::PerfRegressionRunner(int repetitions, double minTolerance)
+    : m_repetitions(std::max(1, repetitions)), m_minTolerance(minTolerance)
+{
+}
+
+//======================================================================
+void PerfRegressionRunner::add(const std::string& name, Workload workload)
+{
+    m_workloads.push_back({ name, std::move(workload) });
+}
+
+//======================================================================
+// rounds of every workload, each timed run right after a timed calibration run
+void PerfRegressionRunner::run()
+{
+    // Untimed first runs, so caches and lazily built tables don't count
+    runCalibration();
+    for (const Entry& entry : m_workloads) {
+        entry.workload();
+    }
+
+    std::vector<std::vector<Run>> runs(m_workloads.size());
+    for (int round = 0; round < m_repetitions; round++) {
+        for (size_t i = 0; i < m_workloads.size(); i++) {
+            Run run{};
+            uint64_t calibrationWork = 0;
+            run.calibrationSeconds = getSeconds(runCalibration, calibrationWork);
+            run.seconds = getSeconds(m_workloads[i].workload, run.work);
+            runs[i].push_back(run);
+        }
+    }
+
+    m_measurements.clear();
+    for (size_t i = 0; i < m_workloads.size(); i++) {
+        m_measurements.push_back(summarize(m_workloads[i].name, runs[i]));
+    }
+}
+
+//======================================================================
+const std::vector<PerfMeasurement>& PerfRegressionRunner::getMeasurements() const
+{
+    return m_measurements;
+}
+
+//======================================================================
+// medians over the runs; the fastest run is reported, but only the relative speed is compared
+PerfMeasurement PerfRegressionRunner::summarize(const std::string& name, const std::vector<Run>& runs)
+{
+    PerfMeasurement measurement;
+    measurement.name = name;
+    std::vector<double> calibrationPerSecond;
+    std::vector<double> relativeSpeeds;
+    for (const Run& run : runs) {
+        measurement.work = run.work;
+        double workPerSecond = run.work / run.seconds;
+        if (workPerSecond > measurement.workPerSecond) {
+            measurement.workPerSecond = workPerSecond;
+            measurement.wallMs = run.seconds * 1000;
+        }
+        calibrationPerSecond.push_back(CALIBRATION_OPERATIONS / run.calibrationSeconds);
+        relativeSpeeds.push_back(workPerSecond / calibrationPerSecond.back());
+    }
+
+    measurement.calibrationPerSecond = median(calibrationPerSecond);
+    measurement.relativeSpeed = median(relativeSpeeds);
+    std::vector<double> deviations;
+    for (double value : relativeSpeeds) {
+        deviations.push_back(std::abs(value - measurement.relativeSpeed));
+    }
+    measurement.noise = median(deviations) / measurement.relativeSpeed;
+    return measurement;
+}
+
+//======================================================================
+// each workload's baseline is scaled by the speed of its own calibration runs
+int PerfRegressionRunner::compare(const std::map<std::string, std::map<std::string, double>>& baseline,
+    std::ostream& output) const
+{
+    int regressionCount = 0;
+    output << std::fixed;
+    for (const PerfMeasurement& measurement : m_measurements) {
+        auto entry = baseline.find(measurement.name);
+        if (entry == baseline.end() || !entry->second.count("relative") ||
+            !entry->second.count("calibration_per_sec")) {
+            output << measurement.name << ": not in the baseline, run with --update\n";
+            continue;
+        }
+        const std::map<std::string, double>& metrics = entry->second;
+        double speedRatio = measurement.calibrationPerSecond / metrics.at("calibration_per_sec");
+        double expectedPerSecond = metrics.at("per_sec") * speedRatio;
+        double expectedWallMs = metrics.at("wall_ms") / speedRatio;
+        double noise = std::max(measurement.noise, metrics.count("noise") ? metrics.at("noise") : 0.0);
+        double tolerance = std::max(m_minTolerance, NOISE_MULTIPLIER * noise);
+        double change = measurement.relativeSpeed / metrics.at("relative") - 1;
+        bool isRegression = change < -tolerance;
+        regressionCount += isRegression ? 1 : 0;
+
+        output << std::setprecision(0) << measurement.name << ": " << measurement.workPerSecond << "/s (expected "
+            << expectedPerSecond << "/s), wall " << measurement.wallMs << " ms (expected " << expectedWallMs
+            << " ms), machine " << std::setprecision(2) << speedRatio << "x, relative speed " << std::showpos
+            << std::setprecision(1) << change * 100 << "%" << std::noshowpos << ", tolerance " << tolerance * 100
+            << "% " << (isRegression ? "REGRESSION" : "ok") << "\n";
+        if (static_cast<uint64_t>(metrics.at("work")) != measurement.work) {
+            output << "  note: " << measurement.work << " units of work, the baseline has "
+                << static_cast<uint64_t>(metrics.at("work")) << "; the workload changed, run with --update\n";
+        }
+    }
+    output << std::defaultfloat;
+    return regressionCount;
+}
+
+//======================================================================
+void PerfRegressionRunner::storeInto(PerfBaseline& baseline, const std::string& buildType) const
+{
+    std::map<std::string, std::map<std::string, double>>& entry = baseline[buildType];
+    entry.clear();
+    for (const PerfMeasurement& measurement : m_measurements) {
+        entry[measurement.name] = { { "work", static_cast<double>(measurement.work) },
+            { "per_sec", measurement.workPerSecond }, { "wall_ms", measurement.wallMs },
+            { "calibration_per_sec", measurement.calibrationPerSecond },
+            { "relative", measurement.relativeSpeed }, { "noise", measurement.noise } };
+    }
+}
+
+//======================================================================
+PerfBaseline PerfRegressionRunner::loadBaseline(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Error: baseline file " + path + " not found");
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string contents = text.str();
+    return BaselineParser(contents).parse();
+}
+
+//======================================================================
+// {"<build type>": {"<workload>": {"calibration_per_sec": .., "noise": .., "per_sec": .., ...}}}
+void PerfRegressionRunner::saveBaseline(const PerfBaseline& baseline, const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Error: can't write baseline file " + path);
+    }
+    file << std::setprecision(10) << "{";
+    const char* buildSeparator = "\n";
+    for (const auto& [buildType, workloads] : baseline) {
+        file << buildSeparator << "  \"" << buildType << "\": {";
+        const char* workloadSeparator = "\n";
+        for (const auto& [workload, metrics] : workloads) {
+            file << workloadSeparator << "    \"" << workload << "\": {";
+            const char* metricSeparator = "";
+            for (const auto& [metric, value] : metrics) {
+                file << metricSeparator << "\"" << metric << "\": " << value;
+                metricSeparator = ", ";
+            }
+            file << "}";
+            workloadSeparator = ",\n";
+        }
+        file << "\n  }";
+        buildSeparator = ",\n";
+    }
+    file << "\n}\n";
+}
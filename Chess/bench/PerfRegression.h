@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// The repeated runs of one workload, each measured against the calibration loop run just before it
+struct PerfMeasurement {
+    std::string name;
+    // Units of work of one run (nodes, boards), the same every run of a fixed workload
+    uint64_t work = 0;
+    // Fastest run
+    double wallMs = 0;
+    double workPerSecond = 0;
+    // Median speed of the calibration runs next to this workload's runs
+    double calibrationPerSecond = 0;
+    // Median over the runs of the throughput divided by the calibration speed, what is compared
+    double relativeSpeed = 0;
+    // Median absolute deviation of the relative speed over the runs, relative to its median
+    double noise = 0;
+};
+
+// Baseline metrics by build type, then by workload: "work", "per_sec", "wall_ms",
+// "calibration_per_sec", "relative" and "noise"
+using PerfBaseline = std::map<std::string, std::map<std::string, std::map<std::string, double>>>;
+
+/*
+* class PerfRegressionRunner
+* =====================
+* Runs fixed workloads a few times each and compares them with a stored
+* baseline. Every timed run of a workload directly follows a run of a
+* calibration loop that doesn't touch the engine, and the runs go in rounds
+* (each workload once per round), so a machine that speeds up or slows down
+* during the test moves both. A workload regresses when its median speed
+* relative to its calibration runs falls below the baseline's by more than
+* the tolerance: the larger of the minimum tolerance and a multiple of the
+* spread of that ratio over the rounds.
+*/
+class PerfRegressionRunner {
+public:
+    // Runs the workload once, returns its units of work
+    using Workload = std::function<uint64_t()>;
+
+    PerfRegressionRunner(int repetitions, double minTolerance);
+
+    void add(const std::string& name, Workload workload);
+    void run();
+
+    const std::vector<PerfMeasurement>& getMeasurements() const;
+
+    // Prints one line per workload, returns the number of regressions
+    int compare(const std::map<std::string, std::map<std::string, double>>& baseline, std::ostream& output) const;
+    // Replaces the entry of the build type with the current measurements
+    void storeInto(PerfBaseline& baseline, const std::string& buildType) const;
+
+    // Throws std::runtime_error on a missing or malformed file
+    static PerfBaseline loadBaseline(const std::string& path);
+    static void saveBaseline(const PerfBaseline& baseline, const std::string& path);
+
+private:
+    struct Entry {
+        std::string name;
+        Workload workload;
+    };
+
+    int m_repetitions;
+    double m_minTolerance;
+    std::vector<Entry> m_workloads;
+    std::vector<PerfMeasurement> m_measurements;
+
+    // One timed run of a workload and of the calibration loop before it
+    struct Run {
+        uint64_t work;
+        double seconds;
+        double calibrationSeconds;
+    };
+
+    static PerfMeasurement summarize(const std::string& name, const std::vector<Run>& runs);
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Nnue/NnueNetwork.h"
+#include "Utils/ThreadPool.h"
+
+// STATIC: the static evaluation of MoveRecommender (material, piece-square, pawn structure,
+//         king shelter, or the NNUE network when one is set).
+// SEARCH: best move score of a MoveRecommender search at the given depth.
+enum class BatchMode {
+    STATIC,
+    SEARCH
+};
+
+/*
+* class BatchEvaluator
+* =====================
+* Scores many positions at once for offline jobs. Positions are either a
+* 64 symbol board string (as taken by Board, optionally followed by " w" or
+* " b") or a FEN string, whose castling rights, en passant square and
+* clocks are kept. The work is split across a thread pool: each thread
+* parses its chunk into the position columns (structure of arrays), then
+* loads them one by one into a single Board and scores it with the same
+* MoveRecommender evaluation the engine uses, so offline scores match the
+* engine's. Each score, from the side to move's point of view, goes to the
+* output span.
+*/
+class BatchEvaluator {
+public:
+    // 0 threads means one per hardware thread
+    BatchEvaluator(size_t threadCount = 0, int searchDepth = 1);
+
+    // Throws std::runtime_error on a malformed position or a size mismatch
+    void evaluate(std::span<const std::string> positions, std::span<int> scores, BatchMode mode);
+
+    // Evaluates with an NNUE network from now on, nullptr for the hand-tuned terms
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+
+    // Throughput of the last evaluate call
+    double getPositionsPerSecond() const;
+    size_t getThreadCount() const;
+
+    // Parses a board string or FEN (see Fen::parse); a board string has no castling or en passant
+    static FenPosition parsePosition(const std::string& text);
+
+private:
+    // One entry per position, the fields of FenPosition
+    struct PositionColumns {
+        std::vector<std::string> boardStrings;
+        std::vector<uint8_t> isWhiteTurn;
+        std::vector<int> castlingRights;
+        std::vector<int> enPassantSquares;
+        std::vector<int> halfmoveClocks;
+        std::vector<int> fullmoveNumbers;
+
+        void resize(size_t count);
+    };
+
+    ThreadPool m_pool;
+    // The search only uses the board it is given, this one just satisfies the c-tor
+    Board m_referenceBoard;
+    MoveRecommender m_recommender;
+    std::shared_ptr<const NnueNetwork> m_network;
+    PositionColumns m_columns;
+    double m_positionsPerSecond;
+
+    void loadColumns(std::span<const std::string> positions, size_t begin, size_t end);
+    void evaluateChunk(std::span<int> scores, BatchMode mode, size_t begin, size_t end);
+};
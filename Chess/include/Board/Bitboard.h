@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "MoveRecommender/ChessUtils.h"
+
+/*
+* Bitboard helpers
+* =====================
+* A bitboard holds one bit per square, square index = row * 8 + col.
+* White pawns move towards higher rows, black pawns towards lower rows,
+* matching Pawn::getForwardDirection.
+*/
+using Bitboard = uint64_t;
+
+namespace Bitboards {
+
+    const int WHITE = 0;
+    const int BLACK = 1;
+    const int COLOR_COUNT = 2;
+}
+
+// One bitboard per color and piece type
+using PieceBitboards = std::array<std::array<Bitboard, ChessUtils::PIECE_TYPE_COUNT>, Bitboards::COLOR_COUNT>;
+
+namespace Bitboards {
+
+    constexpr int squareIndex(int row, int col) {
+        return row * ChessUtils::BOARD_SIZE + col;
+    }
+
+    constexpr int squareRow(int square) {
+        return square / ChessUtils::BOARD_SIZE;
+    }
+
+    constexpr int squareCol(int square) {
+        return square % ChessUtils::BOARD_SIZE;
+    }
+
+    constexpr Bitboard squareBit(int square) {
+        return Bitboard(1) << square;
+    }
+
+    constexpr bool isOnBoard(int row, int col) {
+        return row >= 0 && row < ChessUtils::BOARD_SIZE && col >= 0 && col < ChessUtils::BOARD_SIZE;
+    }
+
+    // Index of the lowest set bit, the board must not be empty
+    inline int lowestSquare(Bitboard board) {
+        return std::countr_zero(board);
+    }
+
+    // Removes and returns the lowest set bit
+    inline int popLowestSquare(Bitboard& board) {
+        int square = std::countr_zero(board);
+        board &= board - 1;
+        return square;
+    }
+
+    inline int countSquares(Bitboard board) {
+        return std::popcount(board);
+    }
+
+    // Builds the attack set of a leaping piece from a list of offsets
+    template <size_t N>
+    constexpr std::array<Bitboard, ChessUtils::SQUARE_COUNT> buildLeaperAttacks(const int (&offsets)[N][2]) {
+        std::array<Bitboard, ChessUtils::SQUARE_COUNT> attacks{};
+        for (int square = 0; square < ChessUtils::SQUARE_COUNT; square++) {
+            for (const auto& offset : offsets) {
+                int row = squareRow(square) + offset[0];
+                int col = squareCol(square) + offset[1];
+                if (isOnBoard(row, col)) {
+                    attacks[square] |= squareBit(squareIndex(row, col));
+                }
+            }
+        }
+        return attacks;
+    }
+
+    constexpr int KNIGHT_OFFSETS[8][2] = {
+        {2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+    };
+    constexpr int KING_OFFSETS[8][2] = {
+        {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+    };
+    constexpr int WHITE_PAWN_OFFSETS[2][2] = { {1, 1}, {1, -1} };
+    constexpr int BLACK_PAWN_OFFSETS[2][2] = { {-1, 1}, {-1, -1} };
+
+    constexpr int ROOK_DIRECTIONS[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    constexpr int BISHOP_DIRECTIONS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    constexpr std::array<Bitboard, ChessUtils::SQUARE_COUNT> KNIGHT_ATTACKS = buildLeaperAttacks(KNIGHT_OFFSETS);
+    constexpr std::array<Bitboard, ChessUtils::SQUARE_COUNT> KING_ATTACKS = buildLeaperAttacks(KING_OFFSETS);
+    constexpr std::array<std::array<Bitboard, ChessUtils::SQUARE_COUNT>, COLOR_COUNT> PAWN_ATTACKS = {
+        buildLeaperAttacks(WHITE_PAWN_OFFSETS), buildLeaperAttacks(BLACK_PAWN_OFFSETS)
+    };
+
+    // Walks each direction until the first occupied square (included)
+    inline Bitboard slidingAttacks(int square, Bitboard occupancy, const int (&directions)[4][2]) {
+        Bitboard attacks = 0;
+        for (const auto& direction : directions) {
+            int row = squareRow(square) + direction[0];
+            int col = squareCol(square) + direction[1];
+            while (isOnBoard(row, col)) {
+                Bitboard bit = squareBit(squareIndex(row, col));
+                attacks |= bit;
+                if (occupancy & bit) {
+                    break;
+                }
+                row += direction[0];
+                col += direction[1];
+            }
+        }
+        return attacks;
+    }
+
+    inline Bitboard rookAttacks(int square, Bitboard occupancy) {
+        return slidingAttacks(square, occupancy, ROOK_DIRECTIONS);
+    }
+
+    inline Bitboard bishopAttacks(int square, Bitboard occupancy) {
+        return slidingAttacks(square, occupancy, BISHOP_DIRECTIONS);
+    }
+
+    constexpr int colorIndex(bool isWhite) {
+        return isWhite ? WHITE : BLACK;
+    }
+
+    // Mirrors a square vertically, so black sees its pieces from white's side
+    constexpr int mirrorSquare(int square) {
+        return square ^ (ChessUtils::SQUARE_COUNT - ChessUtils::BOARD_SIZE);
+    }
+
+    // Every square of one column
+    constexpr std::array<Bitboard, ChessUtils::BOARD_SIZE> buildColumnMasks() {
+        std::array<Bitboard, ChessUtils::BOARD_SIZE> masks{};
+        for (int col = 0; col < ChessUtils::BOARD_SIZE; col++) {
+            for (int row = 0; row < ChessUtils::BOARD_SIZE; row++) {
+                masks[col] |= squareBit(squareIndex(row, col));
+            }
+        }
+        return masks;
+    }
+
+    constexpr std::array<Bitboard, ChessUtils::BOARD_SIZE> COLUMN_MASKS = buildColumnMasks();
+
+    // Squares ahead of a pawn on its own and neighbouring columns, an enemy pawn
+    // there can stop or capture it
+    constexpr std::array<std::array<Bitboard, ChessUtils::SQUARE_COUNT>, COLOR_COUNT> buildPassedPawnMasks() {
+        std::array<std::array<Bitboard, ChessUtils::SQUARE_COUNT>, COLOR_COUNT> masks{};
+        for (int color = 0; color < COLOR_COUNT; color++) {
+            int direction = color == WHITE ? 1 : -1;
+            for (int square = 0; square < ChessUtils::SQUARE_COUNT; square++) {
+                for (int row = squareRow(square) + direction; row >= 0 && row < ChessUtils::BOARD_SIZE; row += direction) {
+                    for (int col = squareCol(square) - 1; col <= squareCol(square) + 1; col++) {
+                        if (isOnBoard(row, col)) {
+                            masks[color][square] |= squareBit(squareIndex(row, col));
+                        }
+                    }
+                }
+            }
+        }
+        return masks;
+    }
+
+    constexpr std::array<std::array<Bitboard, ChessUtils::SQUARE_COUNT>, COLOR_COUNT> PASSED_PAWN_MASKS =
+        buildPassedPawnMasks();
+}
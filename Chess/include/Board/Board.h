@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 
 #include <vector>
 #include <string>
@@ -7,6 +7,11 @@
 #include "PieceFactory/PieceFactory.h"
 #include "Pieces/King.h"
 #include "Board/BoardState.h"
+#include "Board/BoardMove.h"
+#include "Board/Bitboard.h"
+#include "Board/Zobrist.h"
+#include "Board/Fen.h"
+#include "Nnue/NnueNetwork.h"
 
 
 
@@ -22,10 +27,25 @@
 class Board {
 
 public:
-    Board(const std::string& initialBoard);
+    // 64 symbols, row by row from row A ('#' = empty), optionally with black to move
+    Board(const std::string& initialBoard, bool isWhiteTurn = true);
+    // Position and game state of a parsed FEN, see Fen::parse
+    explicit Board(const FenPosition& position);
+    // Deep copy (pieces included), for searching the same position on several threads
+    Board(const Board& other);
+    Board& operator=(const Board&) = delete;
+    // Replaces the position and game state, the move history is dropped. Reusing one Board
+    // this way keeps its storage and the pieces that stand on the same squares.
+    void setPosition(const FenPosition& position);
     
     int validateMove(const std::string& source, const std::string& dest);
+    int validateMove(int srcRow, int srcCol, int destRow, int destCol);
     void makeMove(const std::string& source, const std::string& dest);
+    // A pawn reaching the last row becomes the given piece, a king moving two columns castles
+    void makeMove(int srcRow, int srcCol, int destRow, int destCol,
+        int promotionIndex = ChessUtils::QUEEN_INDEX);
+    void makeMove(const BoardMove& move);
+    void undoMove();
     
     std::shared_ptr<Piece> getPieceAt(int row, int col) const; 
 
@@ -35,8 +55,49 @@ public:
     int getBlackKingCol() const;
 
     bool getIsWhiteTurn() const;
+    // Fen castling right bits, en passant target square or Fen::NO_SQUARE
+    int getCastlingRights() const;
+    int getEnPassantSquare() const;
+    // Plies since the last capture or pawn move
+    int getHalfmoveClock() const;
+    // Current position as FEN, the game state fields included
+    std::string toFen() const;
     std::pair<int, int> notationToCoordinates(std::string notation);
 
+    bool isKingInCheck(bool isWhiteKing);
+
+    // Incremental evaluation terms, kept up to date by makeMove/undoMove
+    int getMaterialScore() const;
+    int getPositionalScore() const;
+    int getPhaseWeight() const;
+    int getEvaluation(bool forWhite) const;
+
+    // Optional NNUE evaluator, its accumulator follows makeMove/undoMove
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+    bool hasNetwork() const;
+    // From the side to move's point of view, the one the network is trained for
+    int getNetworkEvaluation() const;
+    const NnueAccumulator& getAccumulator() const;
+
+    // Zobrist keys of the whole position and of the pawns alone
+    uint64_t getHash() const;
+    uint64_t getPawnHash() const;
+
+    // Legal moves for the side to move
+    void generateLegalMoves(std::vector<BoardMove>& moves);
+    // Number of leaf positions depth plies down, checks the move generator
+    uint64_t perft(int depth);
+
+    // Piece sets, kept up to date by makeMove/undoMove
+    Bitboard getPieces(bool isWhite, int pieceIndex) const;
+    Bitboard getColorPieces(bool isWhite) const;
+    Bitboard getOccupancy() const;
+    Bitboard getAttackersTo(int square, Bitboard occupancy) const;
+
+    // Static exchange evaluation, in piece values
+    int staticExchangeEvaluation(int square, bool attackerIsWhite) const;
+    int staticExchangeEvaluation(const BoardMove& move) const;
+
 
     // State management for move evaluation
     BoardState saveState() const;
@@ -50,16 +111,48 @@ private:
     int m_whiteKingRow, m_whiteKingCol;
     int m_blackKingRow, m_blackKingCol;
 
+    // FEN game state, updated by makeMove and restored by undoMove
+    int m_castlingRights;
+    int m_enPassantSquare;
+    int m_halfmoveClock;
+    int m_fullmoveNumber;
+
+    // White minus black, updated on every make/undo
+    int m_materialScore;
+    PhaseScores m_positionalScores;
+    // Remaining non-pawn material, selects the piece-square table blend
+    int m_phaseWeight;
+    std::vector<MoveRecord> m_history;
+
+    PieceBitboards m_pieceBitboards;
+    std::array<Bitboard, Bitboards::COLOR_COUNT> m_colorBitboards;
+
+    uint64_t m_hash;
+    uint64_t m_pawnHash;
+
+    // One accumulator per position in m_history plus the current one
+    std::shared_ptr<const NnueNetwork> m_network;
+    std::vector<NnueAccumulator> m_accumulators;
+
     int validateBasicRules(int srcRow, int srcCol, int  destRow, int destCol) const;
     int validatePieceMovement(int srcRow, int srcCol, int destRow, int destCol)const;
+    bool isCastlingMove(int srcRow, int srcCol, int destRow, int destCol) const;
+    bool isEnPassantMove(int srcRow, int srcCol, int destRow, int destCol) const;
+    int validateCastling(int srcRow, int srcCol, int destRow, int destCol);
+    int validateByPlaying(int srcRow, int srcCol, int destRow, int destCol);
+    void moveCastlingRook(int row, int srcCol, int destCol);
+    uint64_t getGameStateKey() const;
     bool isKingMoving(std::shared_ptr<Piece> piece)const;
     void updateKingPos(std::shared_ptr<Piece> piece, int& oldKingRow,
         int& oldKingCol, const int& destRow, const int& destCol);
     void restoreBoardPos(std::shared_ptr<Piece> piece, std::shared_ptr<Piece> capturedPiece,
         int srcRow, int srcCol, int destRow, int destCol, bool isKingMoving);
-    
-    bool isKingInCheck(bool isWhiteKing);
-    
+    void addPieceTerms(const std::shared_ptr<Piece>& piece, int row, int col, int sign);
+    void refreshAccumulator(NnueAccumulator& accumulator, int perspective) const;
+    void pushAccumulator(const MoveRecord& record, const std::shared_ptr<Piece>& piece);
+    Bitboard getCandidateTargets(int row, int col) const;
+    int resolveExchange(int square, int fromSquare, bool isWhite, Bitboard occupancy) const;
+    int getLeastValuableAttacker(Bitboard attackers, bool isWhite, int& pieceIndex) const;
 };
 
 
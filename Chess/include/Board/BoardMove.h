@@ -0,0 +1,20 @@
+#pragma once
+
+#include "MoveRecommender/ChessUtils.h"
+
+// A move in board coordinates, as produced by Board::generateLegalMoves
+struct BoardMove {
+    int srcRow;
+    int srcCol;
+    int destRow;
+    int destCol;
+    // Piece index a pawn reaching the last row becomes, ChessUtils::NO_PROMOTION otherwise
+    int promotionIndex = ChessUtils::NO_PROMOTION;
+
+    // Promotions other than to a queen, which the console game can't enter
+    bool isUnderpromotion() const {
+        return promotionIndex != ChessUtils::NO_PROMOTION && promotionIndex != ChessUtils::QUEEN_INDEX;
+    }
+
+    bool operator==(const BoardMove& other) const = default;
+};
@@ -1,6 +1,10 @@
 #pragma once
 #include<vector>
 #include "Pieces/Piece.h"
+#include "MoveRecommender/ChessUtils.h"
+
+// Piece-square totals per game phase (white minus black)
+using PhaseScores = std::array<int, ChessUtils::PHASE_COUNT>;
 
 
 // Structure to save board state
@@ -16,4 +20,39 @@ struct BoardState {
     int whiteKingCol;
     int blackKingRow;
     int blackKingCol;
-};
\ No newline at end of file
+
+    // FEN game state, see Board/Fen.h
+    int castlingRights;
+    int enPassantSquare;
+    int halfmoveClock;
+    int fullmoveNumber;
+
+    // Incrementally maintained evaluation terms
+    int materialScore;
+    PhaseScores positionalScores;
+    int phaseWeight;
+
+    // Number of moves that can still be undone
+    size_t historySize;
+};
+
+// Structure to undo a single move made with Board::makeMove
+struct MoveRecord {
+    int srcRow;
+    int srcCol;
+    int destRow;
+    int destCol;
+
+    // Piece removed by the move (nullptr for quiet moves), from capturedRow and destCol:
+    // the destination square, or the square beside the source for en passant
+    std::shared_ptr<Piece> capturedPiece;
+    int capturedRow;
+
+    // The pawn a promotion replaced (nullptr for other moves)
+    std::shared_ptr<Piece> promotedPawn;
+
+    // FEN game state before the move (the fullmove number is derived from the turn)
+    int castlingRights;
+    int enPassantSquare;
+    int halfmoveClock;
+};
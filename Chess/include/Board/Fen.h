@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include "Board/Bitboard.h"
+
+/*
+* FEN positions
+* =====================
+* Forsyth-Edwards Notation: piece placement from rank 8 down to rank 1,
+* side to move, castling rights, en passant square, halfmove clock and
+* fullmove number. FEN ranks are the board's rows (rank 1 = row 0) and FEN
+* files are its columns, so "e3" is row 2, column 4.
+*
+* Board carries the last four fields: the castling rights and en passant
+* square decide which special moves are legal, and toFen() round-trips all
+* of them.
+*/
+namespace Fen {
+
+    // Castling right bits
+    const int WHITE_KINGSIDE = 1;
+    const int WHITE_QUEENSIDE = 2;
+    const int BLACK_KINGSIDE = 4;
+    const int BLACK_QUEENSIDE = 8;
+
+    const int NO_SQUARE = -1;
+
+    // Rights lost when a piece leaves or lands on the square (king and rook home squares)
+    constexpr std::array<int, ChessUtils::SQUARE_COUNT> buildCastlingMasks() {
+        std::array<int, ChessUtils::SQUARE_COUNT> masks{};
+        masks[Bitboards::squareIndex(0, 4)] = WHITE_KINGSIDE | WHITE_QUEENSIDE;
+        masks[Bitboards::squareIndex(0, 7)] = WHITE_KINGSIDE;
+        masks[Bitboards::squareIndex(0, 0)] = WHITE_QUEENSIDE;
+        masks[Bitboards::squareIndex(7, 4)] = BLACK_KINGSIDE | BLACK_QUEENSIDE;
+        masks[Bitboards::squareIndex(7, 7)] = BLACK_KINGSIDE;
+        masks[Bitboards::squareIndex(7, 0)] = BLACK_QUEENSIDE;
+        return masks;
+    }
+
+    constexpr std::array<int, ChessUtils::SQUARE_COUNT> CASTLING_MASKS = buildCastlingMasks();
+}
+
+// A parsed FEN, boardString is in the 64 symbol format Board takes
+struct FenPosition {
+    std::string boardString;
+    bool isWhiteTurn = true;
+    int castlingRights = 0;
+    int enPassantSquare = Fen::NO_SQUARE;
+    int halfmoveClock = 0;
+    int fullmoveNumber = 1;
+};
+
+namespace Fen {
+
+    // Only the placement is required, missing fields take the FenPosition defaults.
+    // Throws std::runtime_error on a malformed FEN or a side without exactly one king.
+    FenPosition parse(const std::string& fen);
+
+    std::string format(const FenPosition& position);
+
+    // "e3" <-> square index, parseSquare returns NO_SQUARE for "-" and throws on anything else
+    int parseSquare(const std::string& text);
+    std::string formatSquare(int square);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include "Board/BoardMove.h"
+
+/*
+* Long algebraic notation
+* =====================
+* The move format of UCI, EPD results and the embedding API: source and
+* destination squares, file then rank ("e2e4"), and a lowercase promotion
+* letter ("e7e8q"). The board's squares are row then column:
+* row = rank - 1, column = file.
+*/
+namespace MoveNotation {
+
+    std::string format(const BoardMove& move);
+
+    // False for anything but two squares and an optional q, r, b or n; legality isn't checked
+    bool parse(const std::string& text, BoardMove& move);
+}
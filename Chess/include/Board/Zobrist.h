@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Board/Bitboard.h"
+
+/*
+* Zobrist keys
+* =====================
+* One random 64 bit key per (color, piece type, square), one for the side
+* to move, one per set of castling rights and one per en passant column. A position's hash is the XOR of the keys of everything on it, so
+* Board can update it incrementally. The keys are generated at compile time
+* with splitmix64, which keeps hashes identical across builds and runs.
+*/
+namespace Zobrist {
+
+    const uint64_t SEED = 0x9E3779B97F4A7C15ULL;
+
+    constexpr uint64_t splitMix64(uint64_t& state) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t value = state;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    using PieceKeys = std::array<std::array<std::array<uint64_t, ChessUtils::SQUARE_COUNT>,
+        ChessUtils::PIECE_TYPE_COUNT>, Bitboards::COLOR_COUNT>;
+
+    const int CASTLING_RIGHTS_COUNT = 16;
+
+    struct Keys {
+        PieceKeys pieces;
+        uint64_t blackToMove;
+        std::array<uint64_t, CASTLING_RIGHTS_COUNT> castling;
+        std::array<uint64_t, ChessUtils::BOARD_SIZE> enPassant;
+    };
+
+    constexpr Keys buildKeys() {
+        Keys keys{};
+        uint64_t state = SEED;
+        for (auto& colorKeys : keys.pieces) {
+            for (auto& pieceKeys : colorKeys) {
+                for (auto& key : pieceKeys) {
+                    key = splitMix64(state);
+                }
+            }
+        }
+        keys.blackToMove = splitMix64(state);
+        // No rights hash to 0, so boards without castling keep their old keys
+        for (int rights = 1; rights < CASTLING_RIGHTS_COUNT; rights++) {
+            keys.castling[rights] = splitMix64(state);
+        }
+        for (auto& key : keys.enPassant) {
+            key = splitMix64(state);
+        }
+        return keys;
+    }
+
+    constexpr Keys KEYS = buildKeys();
+
+    constexpr uint64_t pieceKey(int colorIndex, int pieceIndex, int square) {
+        return KEYS.pieces[colorIndex][pieceIndex][square];
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "Board/Board.h"
+#include "Board/BoardMove.h"
+#include "Utils/MappedFile.h"
+
+namespace Polyglot {
+    // Layout of the Random64 key table
+    const int KEY_COUNT = 781;
+    const int CASTLING_KEYS = 768;
+    const int EN_PASSANT_KEYS = 772;
+    const int TURN_KEY = 780;
+
+    // Book entry, big endian: uint64 key, uint16 move, uint16 weight, uint32 learn
+    const size_t ENTRY_SIZE = 16;
+    const size_t MOVE_OFFSET = 8;
+    const size_t WEIGHT_OFFSET = 10;
+
+    // Hash of the start position, checks that the key table is the published one
+    const uint64_t START_POSITION_KEY = 0x463b96181691fc9cULL;
+}
+
+// BEST: the highest weighted move. WEIGHTED: a move drawn in proportion to its weight.
+enum class BookSelection {
+    BEST,
+    WEIGHTED
+};
+
+/*
+* class OpeningBook
+* =====================
+* Polyglot opening book (.bin). The book is memory mapped and never copied:
+* its entries are sorted by position key, so a probe is a binary search
+* followed by a walk over the entries of that key, with no allocations.
+*
+* Polyglot keys come from its fixed Random64 table of 781 numbers, which is
+* not shipped here. readKeys reads it from a text file holding the table as
+* published (the hex literals of the C array, anything around them is
+* ignored) and checks it against the known hash of the start position. A
+* table the caller already holds is passed to the constructor as is.
+*/
+class OpeningBook {
+public:
+    // Throws std::runtime_error if a file can't be read or the key table is wrong
+    OpeningBook(const std::string& bookPath, const std::string& keysPath);
+    // The key table is used unchecked
+    OpeningBook(const std::string& bookPath, const std::array<uint64_t, Polyglot::KEY_COUNT>& keys);
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    // Polyglot hash of the position
+    uint64_t getKey(const Board& board) const;
+
+    // The book move for the position, false when it is out of book. randomValue
+    // draws the WEIGHTED move. The move is not checked against the board.
+    bool probe(const Board& board, BookSelection selection, uint64_t randomValue, BoardMove& move) const;
+
+    size_t getEntryCount() const;
+
+    // Throws std::runtime_error if the file can't be read or isn't the Random64 table
+    static std::array<uint64_t, Polyglot::KEY_COUNT> readKeys(const std::string& keysPath);
+
+private:
+    MappedFile m_file;
+    size_t m_entryCount;
+    std::array<uint64_t, Polyglot::KEY_COUNT> m_keys;
+
+    uint64_t getEntryKey(size_t entry) const;
+    uint16_t getEntryValue(size_t entry, size_t offset) const;
+    BoardMove decodeMove(const Board& board, uint16_t rawMove) const;
+};
@@ -1,41 +1,35 @@
 #pragma once
 #include <iostream>
-#ifdef _WIN32
-#include <Windows.h>
-#endif
 
 #include <string>
 #include <functional>
+#include "Board/Board.h"
+#include "Renderer/ConsoleRenderer.h"
 using std::cout;
 using std::cin; 
 using std::endl;
 using std::string; 
 
-const int _SIZE = 21;
-
 class Chess {
-	unsigned char m_board[_SIZE][_SIZE] = { 0 };
-	bool m_turn = true;
-	string m_boardString;
+	// the board is drawn straight from the game board, which main updates
+	const Board& m_gameBoard;
+	ConsoleRenderer m_renderer;
 	string m_input;
 	string m_msg = "\n";
 	string m_errorMsg = "\n";
 	int m_codeResponse;
+	// the first prompt has no move to report yet
+	bool m_isFirstInput = true;
 
-	void clear() const;
-	void setFrames();
-	void setPieces();
-	void show() const;
-	void displayBoard() const;
-	void showAskInput() const;
+	void displayBoard(const string& extraText);
+	string getAskInput() const;
 	bool isSame() const;
 	bool isValid() const;
 	bool isExit() const;
-	void excute();
 	void doTurn();
 
 public:
-	Chess(const string& start = "RNBQKBNRPPPPPPPP################################pppppppprnbqkbnr");
+	Chess(const Board& gameBoard);
 	Chess(const Chess&)=delete;
 	Chess& operator=(const Chess&) = delete;
 	string getInput(std::function<void()> printFunc);
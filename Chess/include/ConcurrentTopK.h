@@ -0,0 +1,45 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "PriorityQueue.h"
+
+
+// ConcurrentTopK class template
+// Collects the maxSize highest priority elements pushed from several threads.
+// Every thread pushes into its own PriorityQueue, on its own cache line, so a
+// push takes no lock and most rejections never leave the thread's queue.
+// mergeInto() combines the queues once every thread is done. When the
+// comparator never ties two different elements, the result is the same as
+// pushing everything into one PriorityQueue, whatever the thread split.
+template <typename T, typename Comparator = DefaultComparator<T>>
+class ConcurrentTopK {
+private:
+    struct alignas(64) LocalQueue {
+        PriorityQueue<T, Comparator> queue;
+    };
+
+    std::vector<LocalQueue> m_localQueues;
+
+public:
+    ConcurrentTopK(size_t maxSize, size_t threadCount, const Comparator& comparator = Comparator()) {
+        m_localQueues.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++) {
+            m_localQueues.push_back(LocalQueue{ PriorityQueue<T, Comparator>(maxSize, comparator) });
+        }
+    }
+
+    // Each thread passes its own index, in [0, threadCount)
+    bool push(size_t threadIndex, const T& element) { return m_localQueues[threadIndex].queue.push(element); }
+    bool push(size_t threadIndex, T&& element) { return m_localQueues[threadIndex].queue.push(std::move(element)); }
+
+    // Not thread-safe, call after every pushing thread finished
+    void mergeInto(PriorityQueue<T, Comparator>& queue) const {
+        for (const LocalQueue& local : m_localQueues) {
+            for (const T& element : local.queue.getList()) {
+                queue.push(element);
+            }
+        }
+    }
+
+    size_t getThreadCount() const { return m_localQueues.size(); }
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+* chess_core C API
+* =====================
+* Stable C interface to ChessEngine for services that embed the engine in
+* process. A chess_position owns one position and its search caches, which
+* stay warm across calls. Moves are in long algebraic notation ("e2e4",
+* "e7e8q"). Functions returning int give CHESS_OK on success, otherwise
+* chess_last_error() describes the failure on the calling thread. One
+* position must not be used by two threads at once.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define CHESS_CORE_API __attribute__((visibility("default")))
+#else
+#define CHESS_CORE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHESS_OK 0
+#define CHESS_ERROR (-1)
+#define CHESS_ILLEGAL_MOVE (-2)
+
+/* Mate in n plies scores CHESS_MATE_SCORE - n, being mated scores the negation */
+#define CHESS_MATE_SCORE 32000
+
+typedef struct chess_position chess_position;
+
+/* Zero fields are no limit; no limit at all searches to depth 1 */
+typedef struct chess_limits {
+    int depth;
+    uint64_t nodes;
+    int64_t movetime_ms;
+} chess_limits;
+
+typedef struct chess_recommendation {
+    /* Empty string when the side to move has no legal move */
+    char best_move[6];
+    /* Engine units from the side to move's point of view */
+    int score;
+    int depth;
+    uint64_t nodes;
+    int64_t elapsed_ms;
+} chess_recommendation;
+
+/* fen may be NULL for the starting position, hash_mb 0 for the default table size.
+   Returns NULL on a malformed FEN. */
+CHESS_CORE_API chess_position* chess_position_create(const char* fen, size_t hash_mb);
+CHESS_CORE_API void chess_position_free(chess_position* position);
+
+/* Replaces the position, keeping the caches */
+CHESS_CORE_API int chess_position_set_fen(chess_position* position, const char* fen);
+/* CHESS_ILLEGAL_MOVE leaves the position unchanged */
+CHESS_CORE_API int chess_position_apply_move(chess_position* position, const char* move);
+/* Writes the FEN with its terminating zero, CHESS_ERROR if it doesn't fit in size bytes */
+CHESS_CORE_API int chess_position_get_fen(const chess_position* position, char* buffer, size_t size);
+
+CHESS_CORE_API int chess_recommend(chess_position* position, const chess_limits* limits,
+    chess_recommendation* recommendation);
+
+/* Message of the last failure on this thread, "" if none */
+CHESS_CORE_API const char* chess_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
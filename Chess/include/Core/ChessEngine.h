@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Limits of ChessEngine::recommend, zero fields are no limit
+struct RecommendLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t moveTimeMs = 0;
+};
+
+// Result of ChessEngine::recommend, moves in long algebraic notation
+struct Recommendation {
+    // Empty when the side to move has no legal move
+    std::string bestMove;
+    // Engine units from the side to move's point of view, see ChessEngine::MATE_SCORE
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t elapsedMs = 0;
+    std::vector<std::string> principalVariation;
+};
+
+/*
+* class ChessEngine
+* =====================
+* Embedding API of chess_core: one position, the moves played from it and
+* a recommender whose transposition table and evaluation caches stay warm
+* from one call to the next. Moves are in long algebraic notation ("e2e4",
+* "e7e8q"). One engine must not be used by two threads at once, separate
+* engines are independent. The engine's own types stay behind m_impl, so
+* this header only needs the standard library.
+*/
+class ChessEngine {
+public:
+    // Mate in n plies scores MATE_SCORE - n, being mated scores the negation
+    static const int MATE_SCORE = 32000;
+
+    static constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // hashMb 0 is the default table size. Throws std::runtime_error on a malformed FEN
+    explicit ChessEngine(const std::string& fen = START_FEN, size_t hashMb = 0);
+    ~ChessEngine();
+
+    ChessEngine(ChessEngine&&) noexcept;
+    ChessEngine& operator=(ChessEngine&&) noexcept;
+    ChessEngine(const ChessEngine&) = delete;
+    ChessEngine& operator=(const ChessEngine&) = delete;
+
+    // Replaces the position, the caches are kept. Throws std::runtime_error on a malformed FEN
+    void setPosition(const std::string& fen);
+    // False, with the position unchanged, for a malformed or illegal move
+    bool applyMove(const std::string& move);
+    std::string getFen() const;
+
+    // Iterative deepening search until the limits; a search nothing would stop goes to depth 1
+    Recommendation recommend(const RecommendLimits& limits);
+
+    // Search threads (1 = calling thread only, 0 = one per hardware thread)
+    void setThreadCount(size_t threadCount);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
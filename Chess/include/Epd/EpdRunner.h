@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Utils/ThreadPool.h"
+
+// SEARCH: depth limited search of every position, reports the best move.
+// PERFT: leaf count of the move generator, checked against a "D<depth>" operation.
+enum class EpdMode {
+    SEARCH,
+    PERFT
+};
+
+// One line of a suite: the position and its "opcode operand;" operations
+struct EpdPosition {
+    std::string fen;
+    std::vector<std::pair<std::string, std::string>> operations;
+
+    // Operand of the first operation with that opcode, empty if there is none
+    std::string getOperation(const std::string& opcode) const;
+};
+
+/*
+* class EpdRunner
+* =====================
+* Runs a test suite in EPD format: per line the first four FEN fields
+* (optionally followed by the two move counters), then operations such as
+* 'id "name";' or "D3 8902;". Each thread of the pool pulls the next
+* position, so long and short positions balance out. One line per position
+* is written in suite order: its id (or line number), the result, nodes,
+* time and nodes/sec.
+*/
+class EpdRunner {
+public:
+    // 0 threads means one per hardware thread
+    EpdRunner(std::ostream& output, size_t threadCount = 0);
+
+    // Throws std::runtime_error on a malformed line, before anything runs
+    void run(std::istream& input, EpdMode mode, int depth);
+
+    static EpdPosition parseLine(const std::string& line);
+
+    // Totals of the last run call
+    size_t getPositionCount() const;
+    size_t getFailureCount() const;
+    uint64_t getNodeCount() const;
+    double getElapsedSeconds() const;
+    double getNodesPerSecond() const;
+    size_t getThreadCount() const;
+
+private:
+    struct PositionResult {
+        std::string text;
+        uint64_t nodes = 0;
+        int64_t elapsedUs = 0;
+        bool isFailed = false;
+    };
+
+    std::ostream& m_output;
+    ThreadPool m_pool;
+    size_t m_positionCount;
+    size_t m_failureCount;
+    uint64_t m_nodeCount;
+    double m_elapsedSeconds;
+
+    static void runPerft(const EpdPosition& position, int depth, PositionResult& result);
+    static void runSearch(MoveRecommender& recommender, const EpdPosition& position, int depth,
+        PositionResult& result);
+};
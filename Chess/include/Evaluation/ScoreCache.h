@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class ScoreCache
+ *
+ * Direct-mapped hash table from a 64 bit position key to a score, used for
+ * the pawn structure table and the full evaluation cache.
+ *
+ * Entries are lock-free: each slot stores the score and the key XOR the score,
+ * so a slot torn by two threads writing at once simply fails the key check and
+ * reads as a miss. Hit and miss counters are relaxed atomics.
+ */
+class ScoreCache {
+public:
+    explicit ScoreCache(size_t sizeMb);
+
+    ScoreCache(const ScoreCache&) = delete;
+    ScoreCache& operator=(const ScoreCache&) = delete;
+
+    // Looks up the key, returns true and fills score on a hit
+    bool probe(uint64_t key, int& score);
+    void store(uint64_t key, int score);
+
+    // Drops all entries and counters, resizing the table
+    void resize(size_t sizeMb);
+    void clear();
+
+    size_t getEntryCount() const;
+    uint64_t getHits() const;
+    uint64_t getMisses() const;
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> checkedKey;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_mask;
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "Board/Board.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Nnue/NnueNetwork.h"
+#include "Search/SearchLimits.h"
+#include "Tablebase/Tablebases.h"
+#include "Utils/ThreadPool.h"
+
+// One side of a match: its search limits and what it evaluates with
+struct MatchEngine {
+    std::string name;
+    // depth, nodes and/or moveTimeMs, per move
+    SearchLimits limits;
+    size_t hashMb = ChessUtils::TRANSPOSITION_TABLE_SIZE_MB;
+    std::shared_ptr<const NnueNetwork> network;
+    std::shared_ptr<const Tablebases> tablebases;
+
+    // Comma separated "key=value" pairs: name, depth, nodes, movetime (ms),
+    // hash (MB), nnue (weights file), tablebases (directory). Throws
+    // std::runtime_error on an unknown key or a bad value.
+    static MatchEngine parse(const std::string& spec, const std::string& defaultName);
+};
+
+// Sequential probability ratio test of H0: elo = elo0 against H1: elo = elo1
+struct SprtSettings {
+    double elo0 = 0;
+    double elo1 = 5;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+enum class SprtStatus {
+    CONTINUE,
+    ACCEPT_H0,
+    ACCEPT_H1
+};
+
+struct MatchSettings {
+    size_t gameCount = 100;
+    // Random legal plies played from the start position before the engines take over
+    int openingPlies = 8;
+    uint64_t seed = 1;
+    // Longer games are adjudicated a draw
+    int maxPlies = 400;
+    SprtSettings sprt;
+    // Games not started yet are skipped once the SPRT has decided
+    bool isStoppedBySprt = true;
+};
+
+/*
+* class MatchRunner
+* =====================
+* Self-play match between two engine configurations in one process. Games
+* are played in pairs from the same random opening, each engine once with
+* white, which cancels most of the opening's bias. Each thread of the pool
+* pulls the next game and plays it on its own boards with its own two
+* recommenders, so nothing is shared between games. A line per finished
+* game is written as it ends, the totals (from the first engine's point of
+* view) give the Elo difference and the SPRT state.
+*
+* A game ends in mate, stalemate, threefold repetition, the fifty move
+* rule, insufficient material (no pawns, at most one minor piece) or at
+* maxPlies.
+*/
+class MatchRunner {
+public:
+    // 0 threads means one per hardware thread, one game runs per thread
+    MatchRunner(std::ostream& output, size_t threadCount = 0);
+
+    void run(const MatchEngine& first, const MatchEngine& second, const MatchSettings& settings);
+
+    // Totals of the last run call, from the first engine's point of view
+    size_t getWinCount() const;
+    size_t getLossCount() const;
+    size_t getDrawCount() const;
+    size_t getGameCount() const;
+    double getElo() const;
+    // Half width of the 95% confidence interval, in Elo
+    double getEloMargin() const;
+    double getLogLikelihoodRatio() const;
+    SprtStatus getSprtStatus() const;
+    double getGamesPerHour() const;
+    size_t getThreadCount() const;
+
+    // Elo of a score fraction, the score fraction of an Elo difference
+    static double scoreToElo(double score);
+    static double eloToScore(double elo);
+    // Log likelihood ratio of H1 against H0 for a win/draw/loss count (trinomial GSPRT)
+    static double computeLogLikelihoodRatio(size_t wins, size_t draws, size_t losses, const SprtSettings& sprt);
+
+private:
+    enum class GameResult {
+        WHITE_WINS,
+        BLACK_WINS,
+        DRAW
+    };
+
+    std::ostream& m_output;
+    ThreadPool m_pool;
+    std::mutex m_resultMutex;
+    size_t m_winCount;
+    size_t m_lossCount;
+    size_t m_drawCount;
+    double m_elapsedSeconds;
+    SprtSettings m_sprt;
+
+    // An engine with the recommender searching for it in the current game
+    struct Player {
+        const MatchEngine& engine;
+        MoveRecommender& recommender;
+    };
+
+    static std::string makeOpening(uint64_t seed, int plies);
+    static GameResult playGame(const Player& white, const Player& black, const std::string& openingFen,
+        int maxPlies, std::string& reason, int& plies);
+    static bool isInsufficientMaterial(const Board& board);
+    // Adds the game to the totals and writes its line, returns the SPRT state after it
+    SprtStatus recordResult(size_t gameNumber, const MatchEngine& first, const MatchEngine& second,
+        bool isFirstWhite, GameResult result, const std::string& reason, int plies);
+};
@@ -20,6 +20,10 @@ public:
     // Assignment operator
     ChessMove& operator=(const ChessMove& other);
 
+    // Move operations, so queue pushes don't copy the position strings
+    ChessMove(ChessMove&& other) noexcept = default;
+    ChessMove& operator=(ChessMove&& other) noexcept = default;
+
     // Equality operator
     bool operator==(const ChessMove& other) const;
 
@@ -37,9 +41,17 @@ public:
 };
 
 // Comparator for ChessMove objects based on their score
+// Equal scores fall back to the squares, so the order never depends on push order
 struct ChessMoveComparator {
     int operator()(const ChessMove& a, const ChessMove& b) const {
-        return a.getScore() - b.getScore(); // Prioritizes higher scores
+        if (a.getScore() != b.getScore()) {
+            return a.getScore() < b.getScore() ? -1 : 1; // Prioritizes higher scores
+        }
+        int sourceOrder = b.getSourcePos().compare(a.getSourcePos());
+        if (sourceOrder != 0) {
+            return sourceOrder; // Then lower source squares
+        }
+        return b.getDestPos().compare(a.getDestPos());
     }
 };
 
@@ -1,12 +1,19 @@
 
 #pragma once
+#include <array>
+
 namespace ChessUtils {
     // Board dimensions
     const int BOARD_SIZE = 8;
 
+    // Standard starting position, in Board's string format
+    constexpr const char* START_BOARD = "RNBQKBNRPPPPPPPP################################pppppppprnbqkbnr";
+    // and as FEN
+    constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
     // Move validation codes
-    const int VALID_MOVE = 41;
-    const int VALID_MOVE_CHECK = 42;
+    const int VALID_MOVE = 42;
+    const int VALID_MOVE_CHECK = 41;
 
     // Piece values
     const int PAWN_VALUE = 1;
@@ -27,16 +34,32 @@ namespace ChessUtils {
     const int CHECKMATE_SCORE = 1000;
     const int RANDOMNESS_RANGE = 3;
 
+    // Pawn structure and king safety
+    const int DOUBLED_PAWN_PENALTY = -10;
+    const int ISOLATED_PAWN_PENALTY = -8;
+    const int PASSED_PAWN_BONUS = 5;
+    const int KING_SHELTER_BONUS = 6;
+
     // Queue settings
     const int MAX_QUEUE_SIZE = 5;
+    // Book moves aren't searched, they are queued with this score
+    const int BOOK_MOVE_SCORE = 0;
+
+    // Cache sizes (MB)
+    const int PAWN_HASH_SIZE_MB = 1;
+    const int EVALUATION_CACHE_SIZE_MB = 2;
+    const int TRANSPOSITION_TABLE_SIZE_MB = 16;
+    // Largest table and thread count the front ends accept
+    const int MAX_TRANSPOSITION_TABLE_SIZE_MB = 4096;
+    const int MAX_THREAD_COUNT = 256;
 
     // Center squares (inner 4 squares)
-    const int CENTER_SQUARES_INNER[4][2] = {
+    constexpr int CENTER_SQUARES_INNER[4][2] = {
         {3, 3}, {3, 4}, {4, 3}, {4, 4}
     };
 
     // Extended center squares (12 additional squares around center)
-    const int CENTER_SQUARES_OUTER[12][2] = {
+    constexpr int CENTER_SQUARES_OUTER[12][2] = {
         {2, 2}, {2, 3}, {2, 4}, {2, 5},
         {3, 2}, {4, 2}, {5, 2}, {5, 3},
         {5, 4}, {5, 5}, {3, 5}, {4, 5}
@@ -45,6 +68,16 @@ namespace ChessUtils {
     // Search optimization
     const int ALPHA_BETA_CUTOFF = 500;
 
+    // Alpha-beta search (UCI): mate in n plies scores SEARCH_MATE_SCORE - n
+    const int SEARCH_MATE_SCORE = 32000;
+    const int MAX_SEARCH_PLY = 64;
+    // Tablebase mates may lie beyond the search horizon
+    const int MAX_MATE_PLY = 256;
+    const int MATE_THRESHOLD = SEARCH_MATE_SCORE - MAX_MATE_PLY;
+    const int SEARCH_INFINITY = SEARCH_MATE_SCORE + 1;
+    // Nodes between two checks of the time, node and stop limits
+    const int SEARCH_CHECK_INTERVAL = 512;
+
     enum class MoveType {
         NORMAL,
         CAPTURE,
@@ -60,4 +93,95 @@ namespace ChessUtils {
         QUEEN = 'q',
         KING = 'k'
     };
-}
+
+    // Piece-square table layout
+    const int SQUARE_COUNT = BOARD_SIZE * BOARD_SIZE;
+    const int PIECE_TYPE_COUNT = 6;
+    const int PAWN_INDEX = 0;
+    const int KNIGHT_INDEX = 1;
+    const int BISHOP_INDEX = 2;
+    const int ROOK_INDEX = 3;
+    const int QUEEN_INDEX = 4;
+    const int KING_INDEX = 5;
+    // Promotion piece of a move that doesn't promote
+    const int NO_PROMOTION = -1;
+
+    // Game phases, blended by the remaining non-pawn material
+    const int MIDDLEGAME = 0;
+    const int ENDGAME = 1;
+    const int PHASE_COUNT = 2;
+    constexpr int PHASE_WEIGHTS[PIECE_TYPE_COUNT] = { 0, 1, 1, 2, 4, 0 };
+    const int MAX_PHASE_WEIGHT = 24;
+
+    constexpr int PIECE_VALUES[PIECE_TYPE_COUNT] = {
+        PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE, ROOK_VALUE, QUEEN_VALUE, KING_VALUE
+    };
+
+    using PieceSquareTable = std::array<int, SQUARE_COUNT>;
+    using PieceSquareTables = std::array<std::array<PieceSquareTable, PIECE_TYPE_COUNT>, PHASE_COUNT>;
+
+    // Builds one table from the center bonuses, indexed by row * BOARD_SIZE + col
+    constexpr PieceSquareTable buildCenterTable() {
+        PieceSquareTable table{};
+        for (const auto& square : CENTER_SQUARES_OUTER) {
+            table[square[0] * BOARD_SIZE + square[1]] = CENTER_BONUS_OUTER;
+        }
+        for (const auto& square : CENTER_SQUARES_INNER) {
+            table[square[0] * BOARD_SIZE + square[1]] = CENTER_BONUS_INNER;
+        }
+        return table;
+    }
+
+    // Every piece type and phase starts from the center bonuses, tune entries here
+    constexpr PieceSquareTables buildPieceSquareTables() {
+        PieceSquareTables tables{};
+        for (auto& phaseTables : tables) {
+            for (auto& table : phaseTables) {
+                table = buildCenterTable();
+            }
+        }
+        return tables;
+    }
+
+    constexpr PieceSquareTables PIECE_SQUARE_TABLES = buildPieceSquareTables();
+
+    // Maps a piece symbol (either color) to its table index, -1 if unknown
+    constexpr int getPieceIndex(char pieceSymbol) {
+        switch (pieceSymbol | 0x20) {
+        case static_cast<char>(PieceType::PAWN):   return PAWN_INDEX;
+        case static_cast<char>(PieceType::KNIGHT): return KNIGHT_INDEX;
+        case static_cast<char>(PieceType::BISHOP): return BISHOP_INDEX;
+        case static_cast<char>(PieceType::ROOK):   return ROOK_INDEX;
+        case static_cast<char>(PieceType::QUEEN):  return QUEEN_INDEX;
+        case static_cast<char>(PieceType::KING):   return KING_INDEX;
+        default: return -1;
+        }
+    }
+
+    // Maps a table index back to the symbol of the given color
+    constexpr char getPieceSymbol(int pieceIndex, bool isWhite) {
+        constexpr char SYMBOLS[PIECE_TYPE_COUNT] = {
+            static_cast<char>(PieceType::PAWN), static_cast<char>(PieceType::KNIGHT),
+            static_cast<char>(PieceType::BISHOP), static_cast<char>(PieceType::ROOK),
+            static_cast<char>(PieceType::QUEEN), static_cast<char>(PieceType::KING)
+        };
+        return isWhite ? static_cast<char>(SYMBOLS[pieceIndex] - 0x20) : SYMBOLS[pieceIndex];
+    }
+
+    // Gets the numerical value of a chess piece
+    constexpr int getPieceValue(char pieceSymbol) {
+        int index = getPieceIndex(pieceSymbol);
+        return index < 0 ? 0 : PIECE_VALUES[index];
+    }
+
+    // Gets the piece-square bonus of a piece type on a square for one phase
+    constexpr int getPieceSquareBonus(int phase, int pieceIndex, int row, int col) {
+        return PIECE_SQUARE_TABLES[phase][pieceIndex][row * BOARD_SIZE + col];
+    }
+
+    // Blends middlegame and endgame scores by the remaining phase weight
+    constexpr int getTaperedScore(int middlegameScore, int endgameScore, int phaseWeight) {
+        int phase = phaseWeight < MAX_PHASE_WEIGHT ? phaseWeight : MAX_PHASE_WEIGHT;
+        return (middlegameScore * phase + endgameScore * (MAX_PHASE_WEIGHT - phase)) / MAX_PHASE_WEIGHT;
+    }
+}
\ No newline at end of file
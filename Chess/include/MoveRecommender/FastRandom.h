@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @class FastRandom
+ * Small xorshift64* generator. Each search thread owns one, so there is no
+ * shared state or lock (unlike rand()) and a fixed seed replays exactly.
+ */
+class FastRandom {
+public:
+    explicit FastRandom(uint64_t seed = 1) { setSeed(seed); }
+
+    // Any seed is valid, it is scrambled so that close seeds give unrelated streams
+    void setSeed(uint64_t seed) {
+        uint64_t state = seed + 0x9E3779B97F4A7C15ULL;
+        state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+        m_state = (state ^ (state >> 31)) | 1;
+    }
+
+    uint64_t next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Uniform value in [0, bound), bound must be positive
+    int nextInt(int bound) {
+        return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(bound)) >> 32);
+    }
+
+private:
+    uint64_t m_state;
+};
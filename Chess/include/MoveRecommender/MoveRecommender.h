@@ -4,10 +4,22 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <atomic>
+#include <chrono>
 #include "Board/Board.h"
+#include "Book/OpeningBook.h"
 #include "ChessMove.h"
 #include "PriorityQueue.h"
+#include "ConcurrentTopK.h"
 #include "ChessUtils.h"
+#include "Evaluation/ScoreCache.h"
+#include "SearchContext.h"
+#include "Search/SearchLimits.h"
+#include "Search/SearchStats.h"
+#include "Search/TranspositionTable.h"
+#include "Tablebase/Tablebases.h"
+#include "Utils/HardwareCounters.h"
+#include "Utils/ThreadPool.h"
 
 /**
  * @brief Simplified chess move recommender using minimax algorithm
@@ -19,25 +31,73 @@ private:
     bool m_isWhiteTurn;
     PriorityQueue<ChessMove, ChessMoveComparator> m_moveQueue;
 
+    // Shared by every search thread, entries are lock-free
+    ScoreCache m_pawnTable;
+    ScoreCache m_evaluationCache;
+
+    // Hands out one seed per search, each thread then draws from its own FastRandom
+    FastRandom m_seedGenerator;
+    bool m_isRandomnessEnabled;
+
+    // Root moves are scored on these threads, each on its own copy of the board
+    std::unique_ptr<ThreadPool> m_pool;
+
+    // Optional opening book, consulted before any search
+    std::shared_ptr<const OpeningBook> m_book;
+    BookSelection m_bookSelection;
+
+    // Optional endgame tables, positions they cover aren't searched
+    std::shared_ptr<const Tablebases> m_tablebases;
+
+    // Alpha-beta search state, shared by the threads of one search; the table
+    // may also be shared with other recommenders
+    std::shared_ptr<TranspositionTable> m_transpositionTable;
+    const SearchLimits* m_searchLimits;
+    std::atomic<bool> m_isSearchStopped;
+    std::atomic<uint64_t> m_searchNodes;
+    std::chrono::steady_clock::time_point m_searchStart;
+    int64_t m_timeBudgetMs;
+
+    // Counters of the last recommendMoves or search, optionally printed with the recommendations
+    SearchStats m_searchStats;
+    bool m_isStatsPrinted;
+    // Null unless hardware counters are on
+    std::unique_ptr<HardwareCounters> m_hardwareCounters;
+
     // Core helper functions
     std::string coordinatesToNotation(int row, int col) const;
     bool isMoveStillValid(const ChessMove& move) const;
-    int getPieceValue(char pieceSymbol) const;
 
     // Move generation and evaluation
+    bool probeBook();
     void refreshMoveQueue();
-    void evaluateMovesForPiece(int srcRow, int srcCol);
+    void scoreRootMoves(Board& board, const std::vector<BoardMove>& moves, size_t first, size_t stride,
+        uint64_t searchSeed, ConcurrentTopK<ChessMove, ChessMoveComparator>& collector, SearchStats& stats);
+    void orderMoves(const Board& board, std::vector<BoardMove>& moves) const;
 
     // Simplified minimax algorithm
-    int minimax(const ChessMove& move, int depth, bool isMaximizing);
+    int minimax(SearchContext& context, const ChessMove& move, int depth, bool isMaximizing);
 
     // Position evaluation functions
-    int evaluatePosition(const ChessMove& move);
-    int evaluateCenterControl(int row, int col) const;
-    int evaluateThreat(int row, int col, bool isWhite, int pieceValue);
+    int evaluatePosition(SearchContext& context, const ChessMove& move);
+    int getStaticEvaluation(const Board& board, bool forWhite);
+    int evaluatePawnStructure(const Board& board);
+    int evaluatePawnStructure(const Board& board, bool isWhite) const;
+    int evaluateKingShelter(const Board& board, bool isWhite) const;
+    int evaluateThreat(const Board& board, int row, int col, bool isWhite) const;
+
+    // Iterative deepening alpha-beta search
+    void iterativeDeepening(SearchContext& context, int firstDepth, int maxDepth,
+        const std::function<void(const SearchInfo&)>* onIteration, SearchInfo& result);
+    int alphaBeta(SearchContext& context, int depth, int ply, int alpha, int beta, PrincipalVariation& pv);
+    int quiescence(SearchContext& context, int ply, int alpha, int beta);
+    void orderSearchMoves(const Board& board, std::vector<BoardMove>& moves, const BoardMove& firstMove) const;
+    bool visitNode(SearchContext& context);
+    bool probeTablebases(const Board& board, int ply, int& score) const;
+    int64_t getElapsedMs() const;
 
     // Utility function for temporary moves
-    int makeTemporaryMoveAndEvaluate(const ChessMove& move, std::function<int()> evaluationFunc);
+    int makeTemporaryMoveAndEvaluate(Board& board, const ChessMove& move, std::function<int()> evaluationFunc);
 
 public:
     // Constructor
@@ -46,6 +106,53 @@ public:
     // Public interface
     void recommendMoves();
     void printRecommendations() const;
+    // Recommended moves, best first
+    const std::vector<ChessMove>& getRecommendations() const;
+    // Nodes, evaluations, cutoffs and timing of the last recommendMoves or search
+    const SearchStats& getSearchStats() const;
+    // printRecommendations adds the statistics of the search after the moves
+    void setStatsPrinted(bool isPrinted);
+    // Collects perf_event counters around each search into the statistics; where the
+    // kernel refuses them the search runs as usual and the reason is printed once
+    void setHardwareCountersEnabled(bool isEnabled);
+
+    // Best move score of any board for its side to move, thread-safe
+    int searchPosition(Board& board, uint64_t seed);
+    // Static evaluation of any board for its side to move, the one the search uses, thread-safe
+    int getStaticScore(const Board& board);
+    // Score of one move on any board as the root move scoring sees it, without searching deeper
+    int evaluateMove(Board& board, const ChessMove& move, uint64_t seed = 0);
+
+    // Deterministic mode: fixed seed and/or no random score variation
+    void setSeed(uint64_t seed);
+    void setRandomnessEnabled(bool isEnabled);
+
+    // Threads used to score the root moves (1 = current thread only, 0 = one per hardware thread)
+    void setThreadCount(size_t threadCount);
+
+    // Switches the static evaluation to an NNUE network (nullptr for the hand-tuned terms)
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+
+    // Book moves are recommended without a search while the game is in book (nullptr for none)
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book, BookSelection selection = BookSelection::WEIGHTED);
+
+    // Endgame tables probed by every search (nullptr for none)
+    void setTablebases(std::shared_ptr<const Tablebases> tablebases);
+
+    // Iterative deepening alpha-beta search of any board until the limits are
+    // reached, onIteration gets each completed depth. Uses the thread count of
+    // setThreadCount, the extra threads search copies of the board (lazy SMP).
+    SearchInfo search(Board& board, const SearchLimits& limits,
+        const std::function<void(const SearchInfo&)>& onIteration = nullptr);
+    void resizeTranspositionTable(size_t sizeMb);
+    void clearTranspositionTable();
+    // Searches from now on use this table, which any number of recommenders may share
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> table);
+
+    // Cache configuration and hit/miss counters
+    void resizeCaches(size_t pawnTableMb, size_t evaluationCacheMb);
+    const ScoreCache& getPawnTable() const;
+    const ScoreCache& getEvaluationCache() const;
 };
 
  // MOVERECOMMENDER_H
\ No newline at end of file
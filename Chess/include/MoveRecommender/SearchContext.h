@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Board/Board.h"
+#include "FastRandom.h"
+#include "Search/SearchStats.h"
+
+// Moves expected from one position on, best line first
+struct PrincipalVariation {
+    int length = 0;
+    std::array<BoardMove, ChessUtils::MAX_SEARCH_PLY> moves;
+};
+
+// Per-thread search state, passed down through minimax
+struct SearchContext {
+    Board& board;
+    FastRandom random;
+    // This thread's counters, merged into the recommender's when the search ends
+    SearchStats stats;
+    // Alpha-beta search: nodes not yet added to the shared count
+    uint64_t unreportedNodes = 0;
+
+    SearchContext(Board& board, FastRandom random)
+        : board(board), random(random)
+    {
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+/*
+* NNUE kernels
+* =====================
+* Vector routines used by NnueNetwork. The widest instruction set enabled at
+* compile time is used (see the CHESS_ENABLE_AVX2 / CHESS_ENABLE_SSE41 CMake
+* options), with a scalar fallback. Every length must be a multiple of 32.
+*/
+namespace NnueKernels {
+
+#if defined(__AVX2__)
+    const char* const INSTRUCTION_SET = "AVX2";
+#elif defined(__SSE4_1__)
+    const char* const INSTRUCTION_SET = "SSE4.1";
+#else
+    const char* const INSTRUCTION_SET = "scalar";
+#endif
+
+    // accumulator += weights
+    inline void addWeights(int16_t* accumulator, const int16_t* weights, int size) {
+#if defined(__AVX2__)
+        for (int i = 0; i < size; i += 16) {
+            __m256i sum = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulator + i), sum);
+        }
+#elif defined(__SSE4_1__)
+        for (int i = 0; i < size; i += 8) {
+            __m128i sum = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + i), sum);
+        }
+#else
+        for (int i = 0; i < size; i++) {
+            accumulator[i] = static_cast<int16_t>(accumulator[i] + weights[i]);
+        }
+#endif
+    }
+
+    // accumulator -= weights
+    inline void subtractWeights(int16_t* accumulator, const int16_t* weights, int size) {
+#if defined(__AVX2__)
+        for (int i = 0; i < size; i += 16) {
+            __m256i difference = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulator + i), difference);
+        }
+#elif defined(__SSE4_1__)
+        for (int i = 0; i < size; i += 8) {
+            __m128i difference = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulator + i), difference);
+        }
+#else
+        for (int i = 0; i < size; i++) {
+            accumulator[i] = static_cast<int16_t>(accumulator[i] - weights[i]);
+        }
+#endif
+    }
+
+    // output = clamp(input, 0, 127)
+    inline void clippedRelu(const int16_t* input, uint8_t* output, int size) {
+#if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        for (int i = 0; i < size; i += 32) {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 16));
+            // packs works per 128 bit lane, the permute restores the element order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_max_epi8(packed, zero));
+        }
+#elif defined(__SSE4_1__)
+        const __m128i zero = _mm_setzero_si128();
+        for (int i = 0; i < size; i += 16) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_max_epi8(_mm_packs_epi16(low, high), zero));
+        }
+#else
+        for (int i = 0; i < size; i++) {
+            output[i] = static_cast<uint8_t>(std::clamp<int>(input[i], 0, 127));
+        }
+#endif
+    }
+
+    // sum of input[i] * weights[i], inputs are 0..127 so the pairwise 16 bit sums never saturate
+    inline int32_t dotProduct(const uint8_t* input, const int8_t* weights, int size) {
+#if defined(__AVX2__)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < size; i += 32) {
+            __m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+#elif defined(__SSE4_1__)
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < size; i += 16) {
+            __m128i products = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i)));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < size; i++) {
+            sum += static_cast<int32_t>(input[i]) * weights[i];
+        }
+        return sum;
+#endif
+    }
+}
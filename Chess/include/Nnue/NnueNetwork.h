@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board/Bitboard.h"
+
+/*
+* NNUE evaluation
+* =====================
+* HalfKP feature set: for each side's point of view, one feature per
+* (own king square, non-king piece type and color, piece square). Squares are
+* mirrored for black so both sides see their own pieces on the low rows.
+*
+* Network: 2 x ACCUMULATOR_SIZE int16 accumulator -> clipped ReLU (uint8)
+*          -> HIDDEN1_SIZE -> HIDDEN2_SIZE -> 1, int8 weights, int32 biases.
+* The output divided by OUTPUT_SCALE is in centipawns for the side to move.
+*
+* Weights file, little endian:
+*   char[4] "CNUE", uint32 version, uint32 feature count, uint32 accumulator size,
+*   uint32 hidden1 size, uint32 hidden2 size,
+*   int16 feature biases[ACCUMULATOR_SIZE],
+*   int16 feature weights[FEATURE_COUNT][ACCUMULATOR_SIZE],
+*   int32 hidden1 biases[HIDDEN1_SIZE], int8 hidden1 weights[HIDDEN1_SIZE][2 * ACCUMULATOR_SIZE],
+*   int32 hidden2 biases[HIDDEN2_SIZE], int8 hidden2 weights[HIDDEN2_SIZE][HIDDEN1_SIZE],
+*   int32 output bias, int8 output weights[HIDDEN2_SIZE]
+*/
+namespace Nnue {
+    const uint32_t FILE_VERSION = 1;
+    const int PIECE_FEATURES = 10;
+    const int FEATURE_COUNT = ChessUtils::SQUARE_COUNT * PIECE_FEATURES * ChessUtils::SQUARE_COUNT;
+    const int ACCUMULATOR_SIZE = 256;
+    const int HIDDEN1_SIZE = 32;
+    const int HIDDEN2_SIZE = 32;
+    const int WEIGHT_SHIFT = 6;
+    const int OUTPUT_SCALE = 16;
+    const int CENTIPAWNS_PER_PAWN = 100;
+}
+
+// Per-perspective sums of the active feature weights
+struct NnueAccumulator {
+    alignas(32) std::array<std::array<int16_t, Nnue::ACCUMULATOR_SIZE>, Bitboards::COLOR_COUNT> values;
+};
+
+/**
+ * @class NnueNetwork
+ * Quantized network weights and the inference routines. Immutable once loaded,
+ * so one instance can be shared by every board and thread.
+ */
+class NnueNetwork {
+public:
+    // Loads the weights, throws std::runtime_error if the file is missing or malformed
+    explicit NnueNetwork(const std::string& path);
+
+    // Recomputes one perspective from scratch (needed after that side's king moved)
+    void refreshAccumulator(NnueAccumulator& accumulator, int perspective, int kingSquare,
+        const PieceBitboards& pieces) const;
+
+    // Adds or removes one piece from one perspective
+    void addFeature(NnueAccumulator& accumulator, int perspective, int kingSquare,
+        int colorIndex, int pieceIndex, int square) const;
+    void removeFeature(NnueAccumulator& accumulator, int perspective, int kingSquare,
+        int colorIndex, int pieceIndex, int square) const;
+
+    // Centipawns for the side to move, whose accumulator half goes first
+    int evaluate(const NnueAccumulator& accumulator, bool isWhiteToMove) const;
+
+private:
+    std::vector<int16_t> m_featureBiases;
+    std::vector<int16_t> m_featureWeights;
+    std::vector<int32_t> m_hidden1Biases;
+    std::vector<int8_t> m_hidden1Weights;
+    std::vector<int32_t> m_hidden2Biases;
+    std::vector<int8_t> m_hidden2Weights;
+    int32_t m_outputBias;
+    std::vector<int8_t> m_outputWeights;
+
+    static int getFeatureIndex(int perspective, int kingSquare, int colorIndex, int pieceIndex, int square);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Board/Board.h"
+#include "Board/BoardMove.h"
+#include "Utils/ThreadPool.h"
+
+// A game that could not be replayed
+struct PgnError {
+    // 1-based game number in the file, and the byte offset of its first line
+    uint64_t gameNumber;
+    size_t offset;
+    // 1-based ply of the bad move, 0 when the game's FEN tag is bad
+    int ply;
+    std::string token;
+};
+
+/*
+* class PgnReader
+* =====================
+* Validates PGN archives by replaying every game through Board. The file is
+* memory mapped and cut at game boundaries (a tag line after a blank line
+* or after movetext) into a few chunks per thread. The movetext is tokenised in place with
+* string_view: tags, comments, variations, NAGs and move numbers are
+* skipped, each SAN move is matched against the legal moves of the
+* position. Games with a [FEN] tag start from that position.
+*/
+class PgnReader {
+public:
+    // 0 threads means one per hardware thread
+    explicit PgnReader(size_t threadCount = 0);
+
+    // Throws std::runtime_error if the file can't be mapped
+    void read(const std::string& path);
+    void read(std::string_view contents);
+
+    // The move the SAN token ("Nbd7", "exd6", "e8=Q+", "O-O") names, false if
+    // it names no legal move or more than one
+    static bool parseSan(Board& board, std::string_view san, BoardMove& move);
+
+    // Results of the last read call, errors by game number
+    uint64_t getGameCount() const;
+    uint64_t getPlyCount() const;
+    const std::vector<PgnError>& getErrors() const;
+    double getGamesPerSecond() const;
+    double getPliesPerSecond() const;
+    size_t getThreadCount() const;
+
+private:
+    static const size_t CHUNKS_PER_THREAD = 4;
+
+    // What one chunk found, its game numbers start at 1
+    struct ChunkResult {
+        uint64_t gameCount = 0;
+        uint64_t plyCount = 0;
+        std::vector<PgnError> errors;
+    };
+
+    ThreadPool m_pool;
+    uint64_t m_gameCount;
+    uint64_t m_plyCount;
+    std::vector<PgnError> m_errors;
+    double m_elapsedSeconds;
+
+    static size_t findGameStart(std::string_view contents, size_t offset);
+    static void readChunk(std::string_view contents, size_t begin, size_t end, ChunkResult& result);
+    static void replayGame(Board& board, std::string_view movetext, size_t offset, ChunkResult& result);
+};
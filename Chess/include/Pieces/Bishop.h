@@ -20,6 +20,4 @@ public:
     bool isPathClear(int destRow, int destCol,
         const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const override;
     char getSymbol() const override;
-private:
-    static bool m_isRegistered;
 };
\ No newline at end of file
@@ -21,6 +21,4 @@ public:
         const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const override; 
 
     char getSymbol() const override;
-private:
-    static bool isRegistered;
 };
\ No newline at end of file
@@ -13,8 +13,6 @@ public:
     virtual char getSymbol() const override;
 
 private:
-    static bool isRegistered;
-
     
     bool isValidLShapeMove(int destRow, int destCol) const;
 };
\ No newline at end of file
@@ -14,8 +14,6 @@ public:
     virtual char getSymbol() const override;
 
 private:
-    static bool isRegistered;
-
     
     bool isValidForwardMove(int destRow, int destCol,
         const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const;
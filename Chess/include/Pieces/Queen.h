@@ -18,6 +18,4 @@ public:
     bool isValidMove(int destRow, int destCol, const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const override;
     bool isPathClear(int destRow, int destCol, const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const override;
     char getSymbol() const override;
-private:
-    static bool isRegistered;
 };
\ No newline at end of file
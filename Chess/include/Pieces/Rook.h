@@ -18,7 +18,4 @@ public:
     bool isPathClear(int destX, int destY,
         const std::vector<std::vector<std::shared_ptr<Piece>>>& board) const override;
 
-private:
-    
-    static bool isRegistered;
 };
\ No newline at end of file
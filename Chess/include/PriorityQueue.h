@@ -1,7 +1,9 @@
+#pragma once
 #include <iostream>
-#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "Exceptions/EmptyQueueException.h"
-#include "Exceptions/MoveScoreDontFit.h"
 
 
 // Generic comparator structure
@@ -15,81 +17,106 @@ struct DefaultComparator {
 };
 
 // PriorityQueue class template
+// Keeps the maxSize highest priority elements in a binary heap whose top is the
+// lowest kept element, so a push is O(log K) and a rejected push is one compare.
+// The storage is reserved once, pushes don't allocate.
 template <typename T, typename Comparator = DefaultComparator<T>>
 class PriorityQueue {
 private:
-    std::list<T> m_queue;
+    std::vector<T> m_heap;
     size_t m_maxSize;
     Comparator m_comparator;
 
+    // Elements sorted by priority, rebuilt by getList() after a change
+    mutable std::vector<T> m_sorted;
+    mutable bool m_isSorted;
+
+    // Heap order: "a goes below b" when a has the higher priority
+    bool isHigherPriority(const T& a, const T& b) const { return m_comparator(a, b) > 0; }
+    auto heapOrder() const { return [this](const T& a, const T& b) { return isHigherPriority(a, b); }; }
+
 public:
     // Constructor with optional max size parameter (0 means unlimited)
     PriorityQueue(size_t maxSize = 0, const Comparator& comparator = Comparator())
-        : m_maxSize(maxSize), m_comparator(comparator) {
+        : m_maxSize(maxSize), m_comparator(comparator), m_isSorted(true) {
+        m_heap.reserve(maxSize);
+        m_sorted.reserve(maxSize);
     }
 
-    // Push element to the queue in O(n) complexity
-    void push(const T& element);
+    // Push element in O(log K), returns false when a full queue rejects it
+    bool push(const T& element) { return push(T(element)); }
+    bool push(T&& element);
 
-    // Poll the highest priority element in O(1) complexity
+    template <typename... Args>
+    bool emplace(Args&&... args) { return push(T(std::forward<Args>(args)...)); }
+
+    // Poll the highest priority element in O(K) complexity
     T poll();
 
     // Check if queue is empty
-    bool isEmpty() const { return m_queue.empty(); }
+    bool isEmpty() const { return m_heap.empty(); }
 
     // Get current size of queue
-    size_t size() const { return m_queue.size(); }
+    size_t size() const { return m_heap.size(); }
+
+    // Empties the queue, keeping its storage
+    void clear() { m_heap.clear(); m_sorted.clear(); m_isSorted = true; }
 
-    // Get a const reference to the underlying list (for iteration)
-    const std::list<T>& getList() const { return m_queue; }
+    // Get the elements from the highest priority down (for iteration)
+    const std::vector<T>& getList() const;
 };
 
 
 template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::push(const T& element) {
-    try {
-        // If max size is enforced and already reached
-        if (m_maxSize > 0 && m_queue.size() == m_maxSize) {
-            // The queue is sorted, so the last element has the lowest priority
-            auto lowestIt = std::prev(m_queue.end());
-
-            // If the new element has lower or equal priority than the lowest one, skip insertion
-            if (m_comparator(element, *lowestIt) <= 0) {
-                throw MoveScoreDontFit();
-            }
-
-            // Else, remove the lowest element to make space
-            m_queue.erase(lowestIt);
+bool PriorityQueue<T, Comparator>::push(T&& element) {
+    // If max size is enforced and already reached
+    if (m_maxSize > 0 && m_heap.size() == m_maxSize) {
+        // The top is the lowest kept element, equal or lower priority is rejected
+        if (!isHigherPriority(element, m_heap.front())) {
+            return false;
         }
 
-        // Find correct insertion point to keep queue sorted by priority
-        auto it = m_queue.begin();
-        while (it != m_queue.end() && m_comparator(*it, element) >= 0) {
-            ++it;
-        }
-
-        // Insert element in the correct position
-        m_queue.insert(it, element);
+        // Else, drop the lowest element to make space
+        std::pop_heap(m_heap.begin(), m_heap.end(), heapOrder());
+        m_heap.back() = std::move(element);
     }
-    catch( const MoveScoreDontFit& e){
-        return;
+    else {
+        m_heap.push_back(std::move(element));
     }
-    
+
+    std::push_heap(m_heap.begin(), m_heap.end(), heapOrder());
+    m_isSorted = false;
+    return true;
 }
 
 
 template <typename T, typename Comparator>
 T PriorityQueue<T, Comparator>::poll() {
     if (isEmpty()) {
-        throw EmptyQueueException(); 
+        throw EmptyQueueException();
     }
 
-    // The front element is always the highest priority one
-    T result = m_queue.front();
-    m_queue.pop_front();
+    // The highest priority element is one of the heap leaves, K is small so scan
+    auto highestIt = std::min_element(m_heap.begin(), m_heap.end(), heapOrder());
+    T result = std::move(*highestIt);
+    *highestIt = std::move(m_heap.back());
+    m_heap.pop_back();
+    std::make_heap(m_heap.begin(), m_heap.end(), heapOrder());
+    m_isSorted = false;
     return result;
 }
 
+
+template <typename T, typename Comparator>
+const std::vector<T>& PriorityQueue<T, Comparator>::getList() const {
+    if (!m_isSorted) {
+        m_sorted.assign(m_heap.begin(), m_heap.end());
+        std::sort(m_sorted.begin(), m_sorted.end(), heapOrder());
+        m_isSorted = true;
+    }
+    return m_sorted;
+}
+
 template <typename T, typename Comparator>
 std::ostream& operator<<(std::ostream& os, const PriorityQueue<T, Comparator>& pq) {
     const auto& list = pq.getList();
@@ -99,7 +126,7 @@ std::ostream& operator<<(std::ostream& os, const PriorityQueue<T, Comparator>& p
         os << *it;
         os << '\n';
     }
-    
+
 
     return os;
-}
\ No newline at end of file
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "Board/Board.h"
+
+/*
+* class ConsoleRenderer
+* =====================
+* Draws the board frame and the text below it straight from a Board. Each
+* frame is built in memory and compared with the previous one, only the
+* changed cells are sent, placed with ANSI cursor moves, in one write.
+*/
+class ConsoleRenderer {
+public:
+    ConsoleRenderer();
+
+    // The text goes under the board, its last line is left for the user's input
+    void render(const Board& board, const std::string& text);
+
+    // The next render repaints the whole screen
+    void invalidate();
+
+private:
+    static const int FRAME_SIZE = 21;
+
+    std::vector<std::string> m_frame;
+    // What the terminal shows now
+    std::vector<std::string> m_previousFrame;
+    // Escape sequences and cells of one render, reused between renders
+    std::string m_output;
+    bool m_isFullRepaint;
+
+    static std::vector<std::string> buildBoardFrame();
+    void buildFrame(const Board& board, const std::string& text);
+    void appendChanges();
+    void appendCursorMove(size_t row, size_t col);
+    void writeOutput() const;
+};
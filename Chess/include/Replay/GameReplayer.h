@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "Board/Board.h"
+#include "MoveRecommender/MoveRecommender.h"
+
+/*
+* class GameReplayer
+* =====================
+* Headless replay of recorded games: one game per line, moves as 4 letter
+* tokens in the notation Chess::getInput accepts ("B5D5"). Every game starts
+* from the initial position; each move goes through Board::validateMove and,
+* when legal, Board::makeMove. Nothing is drawn, one line of result codes is
+* written per game, optionally with the best recommended move after each
+* legal move.
+*/
+class GameReplayer {
+public:
+    // Code reported for a token that is not a move at all
+    static const int INVALID_TOKEN = 0;
+
+    // recommendDepth 0 turns the recommendations off
+    GameReplayer(std::ostream& output, int recommendDepth = 0);
+
+    // Replays every non-empty line of the input
+    void replay(std::istream& input);
+
+    uint64_t getGameCount() const;
+    uint64_t getMoveCount() const;
+    uint64_t getIllegalMoveCount() const;
+    // Throughput of the last replay call
+    double getMovesPerSecond() const;
+
+private:
+    std::ostream& m_output;
+    Board m_board;
+    BoardState m_initialState;
+    std::unique_ptr<MoveRecommender> m_recommender;
+    uint64_t m_gameCount;
+    uint64_t m_moveCount;
+    uint64_t m_illegalMoveCount;
+    double m_movesPerSecond;
+
+    void replayGame(const std::string& line);
+    static bool isMoveToken(const std::string& token);
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Board/BoardMove.h"
+
+/*
+* Search limits and progress
+* =====================
+* Limits of one alpha-beta search, as given by a UCI "go" command. A zero
+* field means no limit of that kind.
+*/
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t moveTimeMs = 0;
+    int64_t whiteTimeMs = 0;
+    int64_t blackTimeMs = 0;
+    int64_t whiteIncrementMs = 0;
+    int64_t blackIncrementMs = 0;
+    bool isInfinite = false;
+
+    // Set by another thread to end the search, may be null
+    const std::atomic<bool>* stopRequested = nullptr;
+
+    // Time to spend on this move, 0 when the search has no deadline
+    int64_t getTimeBudgetMs(bool isWhiteTurn) const {
+        const int64_t MOVES_TO_GO = 30;
+        const int64_t SAFETY_MARGIN_MS = 50;
+
+        if (moveTimeMs > 0) {
+            return moveTimeMs;
+        }
+        int64_t remaining = isWhiteTurn ? whiteTimeMs : blackTimeMs;
+        int64_t increment = isWhiteTurn ? whiteIncrementMs : blackIncrementMs;
+        if (isInfinite || remaining <= 0) {
+            return 0;
+        }
+        int64_t budget = remaining / MOVES_TO_GO + increment * 3 / 4;
+        return std::max<int64_t>(1, std::min(budget, remaining - SAFETY_MARGIN_MS));
+    }
+};
+
+// Result of one completed iteration of the search
+struct SearchInfo {
+    int depth = 0;
+    // Engine units from the side to move's point of view, see ChessUtils::SEARCH_MATE_SCORE
+    int score = 0;
+    uint64_t nodes = 0;
+    int64_t elapsedMs = 0;
+    std::vector<BoardMove> principalVariation;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include "MoveRecommender/ChessUtils.h"
+#include "Utils/AllocationTracker.h"
+#include "Utils/HardwareCounters.h"
+
+/*
+* Search statistics
+* =====================
+* Counters of one search. Every search thread fills its own copy through its
+* SearchContext with plain increments, the copies are merged once the
+* threads are done.
+*/
+struct SearchStats {
+    uint64_t nodes = 0;
+    uint64_t leafEvaluations = 0;
+    // Board::validateMove calls, made only to check a book move
+    uint64_t validateMoveCalls = 0;
+    // Nodes whose moves were generated, and the moves then searched from them
+    uint64_t expandedNodes = 0;
+    uint64_t searchedChildren = 0;
+    uint64_t transpositionProbes = 0;
+    uint64_t transpositionHits = 0;
+    // Searches cut short at each ply, by the early exit of minimax or a beta cutoff
+    std::array<uint64_t, ChessUtils::MAX_SEARCH_PLY> cutoffsPerPly{};
+    int64_t elapsedUs = 0;
+    // Allocations of the whole process during the search, zero unless the build tracks them
+    Allocations::Counters allocations;
+    // perf_event counters of the search, when MoveRecommender::setHardwareCountersEnabled is on
+    HardwareCounts hardware;
+
+    void merge(const SearchStats& other);
+    void clear();
+
+    uint64_t getCutoffs() const;
+    // Moves searched per expanded node, after cutoffs
+    double getBranchingFactor() const;
+    double getNodesPerSecond() const;
+};
+
+// One summary line, the cutoffs of each ply that had any, then the allocations and the
+// hardware counters when they were collected
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats);
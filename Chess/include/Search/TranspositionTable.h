@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Board/BoardMove.h"
+
+// What a stored score says about the true score
+enum class ScoreBound : uint8_t {
+    EXACT = 0,
+    LOWER = 1,  // failed high, true score >= stored
+    UPPER = 2   // failed low, true score <= stored
+};
+
+// One transposition table hit
+struct TranspositionEntry {
+    int score;
+    int depth;
+    ScoreBound bound;
+    // srcRow < 0 when no move was stored
+    BoardMove move;
+};
+
+/**
+ * @class TranspositionTable
+ *
+ * Search results by position key, shared by every search thread. Uses the
+ * same lock-free scheme as ScoreCache: a slot stores its packed data and the
+ * key XOR the data, a slot torn by two writers fails the key check.
+ */
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t sizeMb);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(uint64_t key, TranspositionEntry& entry) const;
+    // Keeps the deeper result when a different position already uses the slot
+    void store(uint64_t key, const TranspositionEntry& entry);
+
+    // Drops all entries, resizing the table
+    void resize(size_t sizeMb);
+    void clear();
+
+    size_t getEntryCount() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> checkedKey;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+
+    static uint64_t pack(const TranspositionEntry& entry);
+    static TranspositionEntry unpack(uint64_t data);
+};
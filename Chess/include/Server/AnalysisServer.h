@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Board/Board.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Nnue/NnueNetwork.h"
+#include "Search/SearchLimits.h"
+#include "Search/TranspositionTable.h"
+#include "Tablebase/Tablebases.h"
+#include "Utils/ThreadPool.h"
+
+/*
+* class AnalysisServer
+* =====================
+* Serves analysis requests of many clients at once over a Unix-domain socket
+* or a loopback TCP port. One thread polls every connection; the searches
+* run on a shared pool, each on a recommender of its own, and all of them
+* share one transposition table. Line protocol, one command per line:
+*
+*   analyze <id> startpos | <fen> [moves <move> ...] [depth <n>] [nodes <n>] [movetime <ms>] [infinite]
+*     -> info <id> depth <n> score <score> nodes <n> time <ms> pv <move> ...   (every finished depth)
+*     -> bestmove <id> <move> depth <n> score <score> nodes <n> time <ms>
+*   cancel <id>  a queued request answers "cancelled <id>", a running one
+*                stops and sends its bestmove
+*   stats        -> stats sessions <n> queued <n> running <n> completed <n> cancelled <n>
+*                   wait_ms <mean> latency_ms <mean> max_latency_ms <max>
+*   quit         closes the session
+*
+* Moves are in UCI notation ("e2e4"), scores in engine units for the side
+* to move. A request without limits searches DEFAULT_MOVE_TIME_MS, depth is
+* at most ChessUtils::MAX_SEARCH_PLY. Errors come back as "error <id>
+* <message>" ("-" when there is no id); a search that fails ends with one
+* instead of its bestmove.
+*/
+class AnalysisServer {
+public:
+    static const int64_t DEFAULT_MOVE_TIME_MS = 1000;
+
+    // 0 threads means one per hardware thread, hashMb is the shared table
+    AnalysisServer(std::ostream& log, size_t threadCount = 0,
+        size_t hashMb = ChessUtils::TRANSPOSITION_TABLE_SIZE_MB);
+    ~AnalysisServer();
+
+    AnalysisServer(const AnalysisServer&) = delete;
+    AnalysisServer& operator=(const AnalysisServer&) = delete;
+
+    // Used by every request from now on, nullptr for none
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+    void setTablebases(std::shared_ptr<const Tablebases> tablebases);
+
+    // "unix:<path>" or "tcp:<port>" (bound to 127.0.0.1 only), throws
+    // std::runtime_error if the socket can't be opened
+    void listen(const std::string& address);
+    // Serves connections until stop() is called
+    void run();
+    // Thread-safe, run() returns once the running searches are told to stop
+    void stop();
+
+    size_t getThreadCount() const;
+
+private:
+    static const size_t MAX_LINE_LENGTH = 64 * 1024;
+    // Output a client may fall behind by before its session is closed
+    static const size_t MAX_OUTPUT_SIZE = 4 * 1024 * 1024;
+
+    struct Request;
+
+    // One client connection, kept alive by its requests until they finish.
+    // The socket is non-blocking: what it doesn't take at once waits in
+    // output until the poll thread sees it writable
+    struct Session {
+        int socket;
+        int wakeDescriptor;
+        std::string input;
+        std::atomic<bool> isClosed{ false };
+        std::mutex writeMutex;
+        std::string output;
+        std::mutex requestMutex;
+        std::unordered_map<std::string, std::shared_ptr<Request>> requests;
+
+        Session(int socket, int wakeDescriptor);
+        ~Session();
+        // Whole lines only and never blocks, a failed write closes the session
+        void send(const std::string& line);
+        // Writes what the socket takes now, false once the session is closed
+        bool flush();
+        bool hasOutput();
+        void cancelAll();
+
+    private:
+        // writeMutex held
+        void writeOutput();
+    };
+
+    struct Request {
+        std::string id;
+        std::shared_ptr<Session> session;
+        std::unique_ptr<Board> board;
+        SearchLimits limits;
+        std::atomic<bool> stopRequested{ false };
+        std::chrono::steady_clock::time_point receivedAt;
+        std::chrono::steady_clock::time_point startedAt;
+    };
+
+    // Takes an idle recommender for one search and gives it back however the search ends
+    class RecommenderLease {
+    public:
+        explicit RecommenderLease(AnalysisServer& server);
+        ~RecommenderLease();
+
+        RecommenderLease(const RecommenderLease&) = delete;
+        RecommenderLease& operator=(const RecommenderLease&) = delete;
+
+        MoveRecommender& get() const;
+
+    private:
+        AnalysisServer& m_server;
+        MoveRecommender* m_recommender;
+    };
+
+    std::ostream& m_log;
+    int m_listenSocket;
+    std::string m_socketPath;
+    int m_wakePipe[2];
+    std::atomic<bool> m_isStopping;
+    std::vector<std::shared_ptr<Session>> m_sessions;
+
+    // Every search uses one of the idle recommenders, all share the table
+    std::shared_ptr<TranspositionTable> m_transpositionTable;
+    Board m_referenceBoard;
+    std::vector<std::unique_ptr<MoveRecommender>> m_recommenders;
+    std::vector<MoveRecommender*> m_idleRecommenders;
+    std::mutex m_recommenderMutex;
+    std::shared_ptr<const NnueNetwork> m_network;
+
+    // Queue depth and latency, in milliseconds from the request's arrival
+    std::mutex m_metricsMutex;
+    size_t m_queuedCount;
+    size_t m_runningCount;
+    size_t m_completedCount;
+    size_t m_cancelledCount;
+    double m_totalWaitMs;
+    double m_totalLatencyMs;
+    double m_maxLatencyMs;
+
+    // Last, so its d-tor lets the searches finish while everything else exists
+    ThreadPool m_pool;
+
+    void acceptSession();
+    void closeSession(size_t index);
+    bool readSession(const std::shared_ptr<Session>& session);
+    void handleLine(const std::shared_ptr<Session>& session, const std::string& line);
+    void handleAnalyze(const std::shared_ptr<Session>& session, std::istringstream& arguments);
+    void handleCancel(Session& session, std::istringstream& arguments);
+    std::string formatStats();
+    void runRequest(const std::shared_ptr<Request>& request);
+    void finishRequest(const Request& request, bool wasStarted);
+    void closeSocket();
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Tablebase/TablebaseLayout.h"
+#include "Utils/ThreadPool.h"
+
+/*
+* class TablebaseGenerator
+* =====================
+* Builds tables by retrograde analysis. Mates and stalemates are marked
+* first, then each pass n marks the positions decided in n plies: a win
+* when some move reaches a loss in n - 1, a loss when every move reaches a
+* win of at most n - 1. A pass only looks at the predecessors (moves played
+* backwards) of the positions the previous pass decided, and at positions
+* with captures or promotions while the smaller tables they lead into still
+* have results that short. Those tables are generated first (KQKR needs
+* KQK and KRK, KPK needs KQK, KRK, KBK and KNK). The positions of a pass are
+* split over the thread pool; a pass only reads values of the previous
+* passes, so the result doesn't depend on the thread count. What stays
+* undecided is a draw.
+*/
+class TablebaseGenerator {
+public:
+    // 0 threads means one per hardware thread, progress goes to log
+    explicit TablebaseGenerator(std::ostream& log, size_t threadCount = 0);
+
+    // Generates the table and the ones it leads into, and writes each one to
+    // <directory>/<name>.dtm and .wdl. Throws std::runtime_error on a bad
+    // signature or a file that can't be written.
+    void generate(const std::string& signature, const std::string& directory);
+
+    size_t getThreadCount() const;
+
+private:
+    struct Table {
+        TablebaseLayout layout;
+        std::vector<uint8_t> values;
+        // Largest distance in the table, bounds the passes of the tables leading into it
+        int maxDistance = 0;
+    };
+
+    std::ostream& m_log;
+    ThreadPool m_pool;
+    std::unordered_map<uint32_t, std::unique_ptr<Table>> m_tables;
+
+    const Table& build(const TablebaseLayout& layout, const std::string& directory);
+    uint8_t initialValue(const Table& table, size_t index, bool& hasExit) const;
+    uint8_t passValue(const Table& table, size_t index, int distance) const;
+    uint8_t lookup(const Table& table, const TablebasePosition& child, bool isSameMaterial) const;
+    void markPredecessors(const Table& table, uint8_t decidedValue, std::vector<uint8_t>& flags);
+
+    // Calls onMove(child, isSameMaterial) for every legal move, returns false to stop early
+    template <typename OnMove>
+    static bool forEachMove(const TablebasePosition& position, OnMove&& onMove);
+    // Calls onPredecessor(parent) for every move that could have led here without capture or promotion
+    template <typename OnPredecessor>
+    static void forEachPredecessor(const TablebasePosition& position, OnPredecessor&& onPredecessor);
+    static bool isAttacked(const TablebasePosition& position, int square, bool byWhite);
+    static bool isKingAttacked(const TablebasePosition& position, bool isWhiteKing);
+    static bool isValid(const TablebasePosition& position);
+
+    static void writeTable(const Table& table, const std::string& directory);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "Board/Bitboard.h"
+
+/*
+* Endgame tablebases
+* =====================
+* One table per material signature of 3 or 4 men, written "KQKR": white's
+* men, then black's, each side starting with its king. Tables are stored
+* with the stronger side as white, a position of the other colors is
+* looked up with the colors swapped and the board flipped.
+*
+* Per position one DTM byte: DRAW, a win in 1..MAX_DISTANCE plies for the
+* side to move (odd), LOSS_BASE + n when it is mated in n plies (even), or
+* ILLEGAL. The WDL file holds the same outcome in 2 bits per position.
+* Castling and en passant are not part of a position.
+*
+* File layout (both files, little endian): char[4] magic, uint32 version,
+* uint64 position count, then the values in index order.
+*/
+namespace Tablebase {
+    const int MIN_MEN = 3;
+    const int MAX_MEN = 4;
+
+    const uint8_t DRAW = 0;
+    const uint8_t LOSS_BASE = 128;
+    const uint8_t ILLEGAL = 255;
+    const int MAX_DISTANCE = 125;
+
+    const int WDL_DRAW = 0;
+    const int WDL_WIN = 1;
+    const int WDL_LOSS = 2;
+    const int WDL_ILLEGAL = 3;
+    const int WDL_PER_BYTE = 4;
+
+    const char DTM_MAGIC[4] = { 'C', 'T', 'B', 'M' };
+    const char WDL_MAGIC[4] = { 'C', 'T', 'B', 'W' };
+    const uint32_t FILE_VERSION = 1;
+    const size_t HEADER_SIZE = 16;
+
+    constexpr bool isWin(uint8_t value) {
+        return value != DRAW && value < LOSS_BASE;
+    }
+
+    constexpr bool isLoss(uint8_t value) {
+        return value >= LOSS_BASE && value != ILLEGAL;
+    }
+
+    constexpr int toWdl(uint8_t value) {
+        return value == ILLEGAL ? WDL_ILLEGAL : isWin(value) ? WDL_WIN : isLoss(value) ? WDL_LOSS : WDL_DRAW;
+    }
+}
+
+// One man on the board
+struct TablebaseMan {
+    int pieceIndex;
+    bool isWhite;
+    int square;
+};
+
+// The men of a position, see TablebaseLayout::normalize for their order
+struct TablebasePosition {
+    std::array<TablebaseMan, Tablebase::MAX_MEN> men;
+    int count = 0;
+    bool isWhiteTurn = true;
+};
+
+/*
+* class TablebaseLayout
+* =====================
+* Index of the positions of one material signature. The white king is
+* brought into a1-d1-d4 by a board symmetry (a1-d8 with pawns, which only
+* allow the left-right mirror), the other men take 6 bits each:
+*   index = ((side to move * king slots + king slot) * 64 + square 2) * 64 + ...
+* A king on the a1-d4 diagonal leaves a choice, the first man off the
+* diagonal then goes below it, so all symmetric positions share one index.
+* Indexes no position maps to (two men on one square, pawns on the last
+* rows, the other side of the diagonal) are marked ILLEGAL by the generator.
+*/
+class TablebaseLayout {
+public:
+    // Any order of the sides ("KRKQ" is "KQKR"), throws std::runtime_error if
+    // it isn't 3-4 men with one king per side
+    explicit TablebaseLayout(const std::string& signature);
+    // The table of a normalized position's material
+    explicit TablebaseLayout(const TablebasePosition& position);
+
+    const std::string& getName() const;
+    uint32_t getMaterialKey() const;
+    size_t getPositionCount() const;
+    int getManCount() const;
+    const TablebaseMan& getMan(int slot) const;
+
+    // The position must be normalized and of this material
+    size_t getIndex(const TablebasePosition& position) const;
+    // Inverse of getIndex for the indexes positions map to
+    void getPosition(size_t index, TablebasePosition& position) const;
+
+    // Sorts the men (white first, king first, then queen down to pawn) and
+    // swaps the colors when black is the stronger side
+    static void normalize(TablebasePosition& position);
+    // Identifies the table of a normalized position
+    static uint32_t getMaterialKey(const TablebasePosition& position);
+
+private:
+    std::string m_name;
+    TablebasePosition m_men;
+    bool m_hasPawns;
+    int m_kingSlotCount;
+    size_t m_positionCount;
+    uint32_t m_materialKey;
+
+    void initialize();
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Board/Board.h"
+#include "Tablebase/TablebaseLayout.h"
+#include "Utils/MappedFile.h"
+
+// Outcome for the side to move (Tablebase::WDL_WIN, WDL_DRAW or WDL_LOSS)
+// and the plies to mate, 0 for a draw
+struct TablebaseResult {
+    int outcome = Tablebase::WDL_DRAW;
+    int distance = 0;
+};
+
+/*
+* class Tablebases
+* =====================
+* Read-only access to the tables of a directory written by
+* TablebaseGenerator. Both files of a table are memory mapped; a probe reads
+* the 2-bit outcome first and the DTM byte only for a decided position, so
+* draws touch the small file alone. Probes don't allocate and may run on
+* any number of threads.
+*/
+class Tablebases {
+public:
+    // Maps every .wdl/.dtm pair of the directory, throws std::runtime_error
+    // if a file is malformed
+    explicit Tablebases(const std::string& directory);
+
+    Tablebases(const Tablebases&) = delete;
+    Tablebases& operator=(const Tablebases&) = delete;
+
+    // False if no table covers the position (too many men, castling rights,
+    // an en passant square, or a missing table)
+    bool probe(const Board& board, TablebaseResult& result) const;
+
+    size_t getTableCount() const;
+
+private:
+    struct Table {
+        TablebaseLayout layout;
+        std::unique_ptr<MappedFile> wdlFile;
+        std::unique_ptr<MappedFile> dtmFile;
+    };
+
+    std::unordered_map<uint32_t, Table> m_tables;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "Board/Board.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Nnue/NnueNetwork.h"
+
+/*
+* class UciEngine
+* =====================
+* Universal Chess Interface front end for tournament managers and GUIs.
+* Commands are read on the calling thread, the search runs on its own thread
+* so "stop" and "isready" are answered at once.
+*
+* Supported: uci, isready, ucinewgame, position (startpos / fen, then moves),
+* go (wtime, btime, winc, binc, movetime, nodes, depth, infinite), stop,
+* setoption (Hash, Threads, TablebasePath), quit.
+*
+* Moves are in long algebraic notation, see Board/MoveNotation.h.
+*/
+class UciEngine {
+public:
+    UciEngine(std::istream& input, std::ostream& output);
+    ~UciEngine();
+
+    UciEngine(const UciEngine&) = delete;
+    UciEngine& operator=(const UciEngine&) = delete;
+
+    // Used by every position from now on, nullptr for the hand-tuned evaluation
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+    // Endgame tables for every search from now on, nullptr for none
+    void setTablebases(std::shared_ptr<const Tablebases> tablebases);
+
+    // Serves commands until "quit" or the end of the input
+    void run();
+
+private:
+    std::istream& m_input;
+    std::ostream& m_output;
+    std::mutex m_outputMutex;
+
+    // The recommender searches whichever board it is given, this one just satisfies the c-tor
+    Board m_referenceBoard;
+    MoveRecommender m_recommender;
+    std::unique_ptr<Board> m_board;
+    std::shared_ptr<const NnueNetwork> m_network;
+
+    std::thread m_searchThread;
+    std::atomic<bool> m_stopRequested;
+    SearchLimits m_limits;
+
+    void handlePosition(std::istringstream& arguments);
+    void handleGo(std::istringstream& arguments);
+    void handleSetOption(std::istringstream& arguments);
+    void stopSearch();
+    void send(const std::string& line);
+    std::string formatInfo(const SearchInfo& info) const;
+};
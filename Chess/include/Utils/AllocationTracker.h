@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+/*
+* Allocation accounting
+* =====================
+* In a build defining CHESS_ALLOCATION_TRACKING (cmake
+* -DCHESS_ENABLE_ALLOCATION_TRACKING=ON) the global operator new counts every
+* allocation and its bytes under the search phase the allocating thread is in.
+* CHESS_ALLOCATION_PHASE(PHASE) sets that phase for the enclosing scope, the
+* outer phase comes back when it ends. Without the definition the macro is
+* empty, operator new isn't replaced and the counters stay zero.
+*/
+#ifdef CHESS_ALLOCATION_TRACKING
+#define CHESS_ALLOCATION_CONCAT_(a, b) a##b
+#define CHESS_ALLOCATION_CONCAT(a, b) CHESS_ALLOCATION_CONCAT_(a, b)
+#define CHESS_ALLOCATION_PHASE(phase) \
+    Allocations::PhaseScope CHESS_ALLOCATION_CONCAT(allocationPhase, __LINE__)(Allocations::Phase::phase)
+#else
+#define CHESS_ALLOCATION_PHASE(phase) ((void)0)
+#endif
+
+namespace Allocations {
+    enum class Phase {
+        OTHER,
+        ROOT_SETUP,       // root move generation and threads of refreshMoveQueue
+        TREE_SEARCH,      // minimax / alpha-beta bookkeeping: moves, notation, std::function
+        MOVE_GENERATION,  // generateLegalMoves below the root
+        MOVE_ORDERING,
+        EVALUATION,       // evaluatePosition and the static evaluation
+        BOARD_STATE,      // saveState / restoreState
+        RESULT_QUEUE,     // top moves collection and merge
+        COUNT
+    };
+
+    const int PHASE_COUNT = static_cast<int>(Phase::COUNT);
+
+    const char* getPhaseName(Phase phase);
+
+    // Counts and bytes of the allocations made under each phase
+    struct Counters {
+        std::array<uint64_t, PHASE_COUNT> allocations{};
+        std::array<uint64_t, PHASE_COUNT> bytes{};
+
+        uint64_t getTotalAllocations() const;
+        uint64_t getTotalBytes() const;
+        // This minus an earlier snapshot
+        Counters operator-(const Counters& earlier) const;
+    };
+
+    // True when operator new is replaced
+    bool isCompiledIn();
+
+    // Process-wide totals since start, every thread included
+    Counters snapshot();
+
+    // Called by the replaced operator new
+    void recordAllocation(size_t size);
+
+    class PhaseScope {
+    public:
+        explicit PhaseScope(Phase phase);
+        ~PhaseScope();
+
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+
+    private:
+        Phase m_outerPhase;
+    };
+}
+
+// Phases with at least one allocation: "name count/bytes", per node when nodes > 0
+void printAllocations(std::ostream& os, const Allocations::Counters& counters, uint64_t nodes);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Counted events: CPU time across threads, then the hardware counters
+enum class HardwareEvent {
+    TASK_CLOCK,
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNT
+};
+
+const int HARDWARE_EVENT_COUNT = static_cast<int>(HardwareEvent::COUNT);
+
+// Counts of one measurement, an event the kernel refused is marked unavailable
+struct HardwareCounts {
+    std::array<uint64_t, HARDWARE_EVENT_COUNT> values{};
+    std::array<bool, HARDWARE_EVENT_COUNT> isAvailable{};
+
+    bool hasAny() const;
+    static const char* getEventName(HardwareEvent event);
+};
+
+/*
+* class HardwareCounters
+* =====================
+* Linux perf_event_open counters of the whole process, user space only.
+* start() opens one counter per event for every thread that exists at that
+* moment (threads they create are inherited), stop() reads and closes them.
+* Counts are scaled when the kernel multiplexed the counters. An event the
+* kernel or its perf_event_paranoid setting doesn't allow is left out, and
+* on other systems nothing is counted, so callers always get a result.
+*/
+class HardwareCounters {
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    // False when no event could be opened, getError() says why
+    bool start();
+    HardwareCounts stop();
+
+    // Why the last start() left events out, empty when all of them are counted
+    const std::string& getError() const;
+
+private:
+    // Descriptors of one event, one per thread
+    std::array<std::vector<int>, HARDWARE_EVENT_COUNT> m_descriptors;
+    std::string m_error;
+
+    void closeAll();
+};
+
+// "name count (count/node)" for each available event, per node when nodes > 0, and the IPC
+void printHardwareCounts(std::ostream& os, const HardwareCounts& counts, uint64_t nodes);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+* class MappedFile
+* =====================
+* Read-only memory mapping of a whole file (mmap, MapViewOfFile on Windows).
+* The contents stay valid for the lifetime of the object, so parsers can hand
+* out string_views into them instead of copying.
+*/
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file can't be opened or mapped. The access
+    // pattern only tunes the kernel read-ahead: front to back or scattered lookups.
+    explicit MappedFile(const std::string& path, bool isSequential = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view getContents() const;
+    size_t getSize() const;
+
+private:
+    const char* m_data;
+    size_t m_size;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+* class ThreadPool
+* =====================
+* Fixed set of worker threads fed from one task queue. wait() blocks until
+* every submitted task has finished and rethrows the first exception a task
+* threw, so errors surface on the calling thread.
+*/
+class ThreadPool {
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+
+    // Splits [0, count) into one chunk per thread, runs func(begin, end) on each and waits
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& func);
+
+    size_t getThreadCount() const;
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_allDone;
+    size_t m_pendingTasks;
+    bool m_isStopping;
+    std::exception_ptr m_firstError;
+
+    void workerLoop();
+};
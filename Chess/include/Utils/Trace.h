@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+* Hot path tracing
+* =====================
+* CHESS_TRACE_SCOPE("name") records the time spent in the enclosing scope as
+* one Chrome trace event. Each thread appends to its own preallocated buffer
+* without locking, TraceSession writes every buffer as trace-event JSON
+* (chrome://tracing, Perfetto) when it ends. Names must be string literals.
+*
+* The macro expands to nothing unless the build defines CHESS_TRACING
+* (cmake -DCHESS_ENABLE_TRACING=ON), so other builds don't pay for it.
+*/
+#ifdef CHESS_TRACING
+#define CHESS_TRACE_CONCAT_(a, b) a##b
+#define CHESS_TRACE_CONCAT(a, b) CHESS_TRACE_CONCAT_(a, b)
+#define CHESS_TRACE_SCOPE(name) Trace::ScopedEvent CHESS_TRACE_CONCAT(traceEvent, __LINE__)(name)
+#else
+#define CHESS_TRACE_SCOPE(name) ((void)0)
+#endif
+
+namespace Trace {
+    // True when the build records events
+    bool isCompiledIn();
+
+    inline int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Appends one complete event to the calling thread's buffer, dropped when the buffer is full
+    void record(const char* name, int64_t startNs, int64_t endNs);
+
+    // Every recorded event as {"traceEvents": [...]}, with the thread names and the dropped count.
+    // The recording threads must be idle.
+    void writeChromeTrace(std::ostream& output);
+
+    class ScopedEvent {
+    public:
+        explicit ScopedEvent(const char* name) : m_name(name), m_startNs(nowNs()) {}
+        ~ScopedEvent() { record(m_name, m_startNs, nowNs()); }
+
+        ScopedEvent(const ScopedEvent&) = delete;
+        ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    private:
+        const char* m_name;
+        int64_t m_startNs;
+    };
+}
+
+/*
+* class TraceSession
+* =====================
+* Writes the trace of the whole run to a file when it goes out of scope.
+* An empty path does nothing.
+*/
+class TraceSession {
+public:
+    // Throws std::runtime_error if the build has no tracing or the file can't be created
+    explicit TraceSession(const std::string& path);
+    ~TraceSession();
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+private:
+    std::string m_path;
+};
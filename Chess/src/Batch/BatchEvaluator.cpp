@@ -0,0 +1,146 @@
+#include "Batch/BatchEvaluator.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+//======================================================================
+// c-tor, the search runs without the random score variation so batches repeat
+BatchEvaluator::BatchEvaluator(size_t threadCount, int searchDepth)
+    : m_pool(threadCount), m_referenceBoard(ChessUtils::START_BOARD),
+    m_recommender(m_referenceBoard, searchDepth), m_positionsPerSecond(0)
+{
+    m_recommender.setRandomnessEnabled(false);
+}
+
+//======================================================================
+// parses and scores every position, each thread takes one contiguous chunk
+void BatchEvaluator::evaluate(std::span<const std::string> positions, std::span<int> scores, BatchMode mode)
+{
+    if (positions.size() != scores.size()) {
+        throw std::runtime_error("Error: batch needs one score slot per position");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    m_columns.resize(positions.size());
+    m_pool.parallelFor(positions.size(), [&](size_t begin, size_t end) {
+        loadColumns(positions, begin, end);
+        evaluateChunk(scores, mode, begin, end);
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_positionsPerSecond = elapsed.count() > 0 ? positions.size() / elapsed.count() : 0;
+}
+
+//======================================================================
+// the recommender's cached evaluations belong to the previous evaluation function
+void BatchEvaluator::setNetwork(std::shared_ptr<const NnueNetwork> network)
+{
+    m_network = network;
+    m_recommender.setNetwork(network);
+}
+
+//======================================================================
+double BatchEvaluator::getPositionsPerSecond() const
+{
+    return m_positionsPerSecond;
+}
+
+//======================================================================
+size_t BatchEvaluator::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
+
+//======================================================================
+// a FEN goes through Fen::parse, a board string is checked here
+FenPosition BatchEvaluator::parsePosition(const std::string& text)
+{
+    // Only a FEN placement has '/', the board string's fields are split without a stream
+    if (text.find('/') != std::string::npos) {
+        return Fen::parse(text);
+    }
+    const char* whitespace = " \t\r\n";
+    std::string_view view(text);
+    size_t placementStart = std::min(view.find_first_not_of(whitespace), view.size());
+    size_t placementEnd = std::min(view.find_first_of(whitespace, placementStart), view.size());
+    size_t sideStart = std::min(view.find_first_not_of(whitespace, placementEnd), view.size());
+    size_t sideEnd = std::min(view.find_first_of(whitespace, sideStart), view.size());
+    std::string_view placement = view.substr(placementStart, placementEnd - placementStart);
+    std::string_view side = view.substr(sideStart, sideEnd - sideStart);
+
+    bool isValid = placement.size() == ChessUtils::SQUARE_COUNT &&
+        std::all_of(placement.begin(), placement.end(), [](char symbol) {
+            return symbol == '#' || (std::isalpha(static_cast<unsigned char>(symbol)) &&
+                ChessUtils::getPieceIndex(symbol) >= 0);
+        });
+    if (!isValid) {
+        throw std::runtime_error("Error: bad board string " + text);
+    }
+    FenPosition position;
+    position.boardString.assign(placement);
+
+    if (side == "b") {
+        position.isWhiteTurn = false;
+    }
+    else if (!side.empty() && side != "w") {
+        throw std::runtime_error("Error: bad side to move in " + text);
+    }
+
+    // Board keeps track of both kings, so each side needs exactly one
+    if (std::count(placement.begin(), placement.end(), 'K') != 1 ||
+        std::count(placement.begin(), placement.end(), 'k') != 1) {
+        throw std::runtime_error("Error: position " + text + " needs one king per side");
+    }
+    return position;
+}
+
+//======================================================================
+void BatchEvaluator::PositionColumns::resize(size_t count)
+{
+    boardStrings.resize(count);
+    isWhiteTurn.resize(count);
+    castlingRights.resize(count);
+    enPassantSquares.resize(count);
+    halfmoveClocks.resize(count);
+    fullmoveNumbers.resize(count);
+}
+
+//======================================================================
+// parses the positions of one chunk, each field into its column
+void BatchEvaluator::loadColumns(std::span<const std::string> positions, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; i++) {
+        FenPosition position = parsePosition(positions[i]);
+        m_columns.boardStrings[i] = std::move(position.boardString);
+        m_columns.isWhiteTurn[i] = position.isWhiteTurn;
+        m_columns.castlingRights[i] = position.castlingRights;
+        m_columns.enPassantSquares[i] = position.enPassantSquare;
+        m_columns.halfmoveClocks[i] = position.halfmoveClock;
+        m_columns.fullmoveNumbers[i] = position.fullmoveNumber;
+    }
+}
+
+//======================================================================
+// one Board per chunk, reset to each position in turn; the recommender's caches are shared by every thread
+void BatchEvaluator::evaluateChunk(std::span<int> scores, BatchMode mode, size_t begin, size_t end)
+{
+    FenPosition position;
+    Board board(ChessUtils::START_BOARD);
+    if (m_network) {
+        board.setNetwork(m_network);
+    }
+    for (size_t i = begin; i < end; i++) {
+        position.boardString = m_columns.boardStrings[i];
+        position.isWhiteTurn = m_columns.isWhiteTurn[i];
+        position.castlingRights = m_columns.castlingRights[i];
+        position.enPassantSquare = m_columns.enPassantSquares[i];
+        position.halfmoveClock = m_columns.halfmoveClocks[i];
+        position.fullmoveNumber = m_columns.fullmoveNumbers[i];
+        board.setPosition(position);
+        scores[i] = mode == BatchMode::STATIC ? m_recommender.getStaticScore(board) :
+            m_recommender.searchPosition(board, i);
+    }
+}
@@ -1,33 +1,120 @@
 ﻿#include "Board/Board.h"
+#include "MoveRecommender/ChessUtils.h"
+#include "Utils/AllocationTracker.h"
+#include "Utils/Trace.h"
+#include <algorithm>
+#include <cstdlib>
 
 
 //builds the tools board matrics
-Board::Board(const std::string& initialBoard) 
+Board::Board(const std::string& initialBoard, bool isWhiteTurn) 
+    : Board(FenPosition{ initialBoard, isWhiteTurn })
 {
-    // Initialize an 8x8 board
-    m_board.resize(8, std::vector<std::shared_ptr<Piece>>(8, nullptr));
-    m_isWhiteTurn = true;
+}
+
+//=================================================================================================
+// builds the board of a parsed FEN, its game state included
+Board::Board(const FenPosition& position)
+    : m_board(8, std::vector<std::shared_ptr<Piece>>(8, nullptr))
+{
+    setPosition(position);
+}
+
+//=================================================================================================
+// replaces the position and game state in place, a piece already standing on its square is kept
+void Board::setPosition(const FenPosition& position)
+{
+    const std::string& initialBoard = position.boardString;
+
+    m_isWhiteTurn = position.isWhiteTurn;
+    m_castlingRights = position.castlingRights;
+    m_enPassantSquare = position.enPassantSquare;
+    m_halfmoveClock = position.halfmoveClock;
+    m_fullmoveNumber = position.fullmoveNumber;
+    m_materialScore = 0;
+    m_positionalScores = {};
+    m_phaseWeight = 0;
+    m_history.clear();
+    m_pieceBitboards = {};
+    m_colorBitboards = {};
+    m_hash = (m_isWhiteTurn ? 0 : Zobrist::KEYS.blackToMove) ^ getGameStateKey();
+    m_pawnHash = 0;
 
     // Initialize the board using the factory
     int index = 0;
     for (int row = 0; row < 8; row++) {
         for (int col = 0; col < 8; col++) {
             char symbol = initialBoard[index++]; // moving on the string
-            if (symbol != '#') {
-                m_board[row][col] = PieceFactory::createPiece(symbol, row, col);
+            std::shared_ptr<Piece>& piece = m_board[row][col];
+            if (symbol == '#') {
+                piece = nullptr;
+                continue;
+            }
+            if (!piece || piece->getSymbol() != symbol) {
+                piece = PieceFactory::createPiece(symbol, row, col);
+            }
+            addPieceTerms(piece, row, col, 1);
 
-                // Track kings' positions
-                if (symbol == 'K') {
-                    m_whiteKingRow = row;
-                    m_whiteKingCol = col;
-                }
-                else if (symbol == 'k') {
-                    m_blackKingRow = row;
-                    m_blackKingCol = col;
-                }
+            // Track kings' positions
+            if (symbol == 'K') {
+                m_whiteKingRow = row;
+                m_whiteKingCol = col;
+            }
+            else if (symbol == 'k') {
+                m_blackKingRow = row;
+                m_blackKingCol = col;
+            }
+        }
+    }
+
+    if (m_network) {
+        m_accumulators.resize(1);
+        refreshAccumulator(m_accumulators.back(), Bitboards::WHITE);
+        refreshAccumulator(m_accumulators.back(), Bitboards::BLACK);
+    }
+}
+
+//=================================================================================================
+// deep copy, every piece is recreated so the copy can be searched on another thread
+Board::Board(const Board& other)
+    : m_board(8, std::vector<std::shared_ptr<Piece>>(8, nullptr)),
+    m_isWhiteTurn(other.m_isWhiteTurn),
+    m_whiteKingRow(other.m_whiteKingRow), m_whiteKingCol(other.m_whiteKingCol),
+    m_blackKingRow(other.m_blackKingRow), m_blackKingCol(other.m_blackKingCol),
+    m_castlingRights(other.m_castlingRights),
+    m_enPassantSquare(other.m_enPassantSquare),
+    m_halfmoveClock(other.m_halfmoveClock),
+    m_fullmoveNumber(other.m_fullmoveNumber),
+    m_materialScore(other.m_materialScore),
+    m_positionalScores(other.m_positionalScores),
+    m_phaseWeight(other.m_phaseWeight),
+    m_history(other.m_history),
+    m_pieceBitboards(other.m_pieceBitboards),
+    m_colorBitboards(other.m_colorBitboards),
+    m_hash(other.m_hash),
+    m_pawnHash(other.m_pawnHash),
+    m_network(other.m_network),
+    m_accumulators(other.m_accumulators)
+{
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (other.m_board[row][col]) {
+                m_board[row][col] = PieceFactory::createPiece(other.m_board[row][col]->getSymbol(), row, col);
             }
         }
     }
+
+    // Captured and promoted pieces come back on undo, they must not be shared either
+    for (MoveRecord& record : m_history) {
+        if (record.capturedPiece) {
+            record.capturedPiece = PieceFactory::createPiece(record.capturedPiece->getSymbol(),
+                record.capturedRow, record.destCol);
+        }
+        if (record.promotedPawn) {
+            record.promotedPawn = PieceFactory::createPiece(record.promotedPawn->getSymbol(),
+                record.destRow, record.destCol);
+        }
+    }
 }
 
 //=================================================================================================
@@ -52,6 +139,11 @@ int Board::validateMove(const std::string& source, const std::string& dest) {
     auto [srcRow, srcCol] = notationToCoordinates(source);
     auto [destRow, destCol] = notationToCoordinates(dest);
 
+    return validateMove(srcRow, srcCol, destRow, destCol);
+}
+//=================================================================================================
+// same as above, on board coordinates
+int Board::validateMove(int srcRow, int srcCol, int destRow, int destCol) {
     int valid = 0;
 
     valid = this->validateBasicRules(srcRow, srcCol, destRow, destCol);
@@ -59,6 +151,14 @@ int Board::validateMove(const std::string& source, const std::string& dest) {
         return valid;
     }
 
+    // Castling and en passant move a second piece, the piece classes don't know them
+    if (isCastlingMove(srcRow, srcCol, destRow, destCol)) {
+        return validateCastling(srcRow, srcCol, destRow, destCol);
+    }
+    if (isEnPassantMove(srcRow, srcCol, destRow, destCol)) {
+        return validateByPlaying(srcRow, srcCol, destRow, destCol);
+    }
+
     valid = this->validatePieceMovement(srcRow, srcCol, destRow, destCol);
     if (valid != 0) {
         return valid;
@@ -102,7 +202,46 @@ void Board::makeMove(const std::string& source, const std::string& dest)
     auto [srcRow, srcCol] = notationToCoordinates(source);
     auto [destRow, destCol] = notationToCoordinates(dest);
 
+    makeMove(srcRow, srcCol, destRow, destCol);
+}
+//=================================================================================================
+// executes a generated move, promotion included
+void Board::makeMove(const BoardMove& move)
+{
+    makeMove(move.srcRow, move.srcCol, move.destRow, move.destCol, move.promotionIndex);
+}
+//=================================================================================================
+// executes the move on board coordinates and records what is needed to undo it
+void Board::makeMove(int srcRow, int srcCol, int destRow, int destCol, int promotionIndex)
+{
     std::shared_ptr<Piece> piece = m_board[srcRow][srcCol];
+    bool isPawnMove = ChessUtils::getPieceIndex(piece->getSymbol()) == ChessUtils::PAWN_INDEX;
+
+    // En passant takes the pawn beside the source, not the one on the destination
+    int capturedRow = isEnPassantMove(srcRow, srcCol, destRow, destCol) ? srcRow : destRow;
+    std::shared_ptr<Piece> capturedPiece = m_board[capturedRow][destCol];
+    m_history.push_back({ srcRow, srcCol, destRow, destCol, capturedPiece, capturedRow, nullptr,
+        m_castlingRights, m_enPassantSquare, m_halfmoveClock });
+    MoveRecord& record = m_history.back();
+
+    // Update the evaluation terms of the pieces that change squares
+    if (capturedPiece) {
+        addPieceTerms(capturedPiece, capturedRow, destCol, -1);
+        m_board[capturedRow][destCol] = nullptr;
+    }
+    addPieceTerms(piece, srcRow, srcCol, -1);
+
+    // A pawn reaching the last row is replaced, the pawn is kept for undo
+    if (isPawnMove && (destRow == 0 || destRow == ChessUtils::BOARD_SIZE - 1)) {
+        if (promotionIndex < ChessUtils::KNIGHT_INDEX || promotionIndex > ChessUtils::QUEEN_INDEX) {
+            promotionIndex = ChessUtils::QUEEN_INDEX;
+        }
+        record.promotedPawn = piece;
+        piece = PieceFactory::createPiece(ChessUtils::getPieceSymbol(promotionIndex, piece->getIsWhite()),
+            destRow, destCol);
+    }
+    addPieceTerms(piece, destRow, destCol, 1);
+
     m_board[destRow][destCol] = piece;
     m_board[srcRow][srcCol] = nullptr;
 
@@ -110,7 +249,7 @@ void Board::makeMove(const std::string& source, const std::string& dest)
     piece->setPosition(destRow, destCol);
 
     // Update king position if the king is moving
-    if (std::dynamic_pointer_cast<King>(piece)) {
+    if (isKingMoving(piece)) {
         if (piece->getIsWhite()) {
             m_whiteKingRow = destRow;
             m_whiteKingCol = destCol;
@@ -119,10 +258,168 @@ void Board::makeMove(const std::string& source, const std::string& dest)
             m_blackKingRow = destRow;
             m_blackKingCol = destCol;
         }
+
+        // Castling: the rook jumps to the square the king passed
+        if (std::abs(destCol - srcCol) == 2) {
+            moveCastlingRook(srcRow, destCol > srcCol ? ChessUtils::BOARD_SIZE - 1 : 0, (srcCol + destCol) / 2);
+        }
+    }
+
+    // Game state: a king or rook leaving home (or a rook captured there) drops castling rights,
+    // a pawn move or capture resets the fifty-move clock
+    m_hash ^= getGameStateKey();
+    m_castlingRights &= ~(Fen::CASTLING_MASKS[Bitboards::squareIndex(srcRow, srcCol)] |
+        Fen::CASTLING_MASKS[Bitboards::squareIndex(destRow, destCol)]);
+    m_enPassantSquare = isPawnMove && std::abs(destRow - srcRow) == 2 ?
+        Bitboards::squareIndex((srcRow + destRow) / 2, srcCol) : Fen::NO_SQUARE;
+    m_halfmoveClock = isPawnMove || capturedPiece ? 0 : m_halfmoveClock + 1;
+    if (!m_isWhiteTurn) {
+        m_fullmoveNumber++;
+    }
+    m_hash ^= getGameStateKey();
+
+    if (m_network) {
+        pushAccumulator(record, piece);
     }
 
     // Switch turn
     m_isWhiteTurn = !m_isWhiteTurn;
+    m_hash ^= Zobrist::KEYS.blackToMove;
+}
+//=================================================================================================
+// takes back the last move made with makeMove
+void Board::undoMove()
+{
+    if (m_history.empty()) {
+        return;
+    }
+
+    MoveRecord record = m_history.back();
+    m_history.pop_back();
+
+    // A promoted piece turns back into its pawn
+    std::shared_ptr<Piece> piece = m_board[record.destRow][record.destCol];
+    addPieceTerms(piece, record.destRow, record.destCol, -1);
+    if (record.promotedPawn) {
+        piece = record.promotedPawn;
+    }
+
+    bool isKing = isKingMoving(piece);
+    if (isKing && std::abs(record.destCol - record.srcCol) == 2) {
+        moveCastlingRook(record.srcRow, (record.srcCol + record.destCol) / 2,
+            record.destCol > record.srcCol ? ChessUtils::BOARD_SIZE - 1 : 0);
+    }
+    restoreBoardPos(piece, nullptr, record.srcRow, record.srcCol, record.destRow, record.destCol, isKing);
+
+    // Reverse the term updates made by makeMove
+    addPieceTerms(piece, record.srcRow, record.srcCol, 1);
+    if (record.capturedPiece) {
+        m_board[record.capturedRow][record.destCol] = record.capturedPiece;
+        addPieceTerms(record.capturedPiece, record.capturedRow, record.destCol, 1);
+    }
+    if (m_network) {
+        m_accumulators.pop_back();
+    }
+    m_hash ^= getGameStateKey();
+    m_castlingRights = record.castlingRights;
+    m_enPassantSquare = record.enPassantSquare;
+    m_halfmoveClock = record.halfmoveClock;
+    m_hash ^= getGameStateKey();
+    m_isWhiteTurn = !m_isWhiteTurn;
+    if (!m_isWhiteTurn) {
+        m_fullmoveNumber--;
+    }
+    m_hash ^= Zobrist::KEYS.blackToMove;
+}
+//=================================================================================================
+// a king moving two columns along its home row
+bool Board::isCastlingMove(int srcRow, int srcCol, int destRow, int destCol) const
+{
+    std::shared_ptr<Piece> piece = m_board[srcRow][srcCol];
+    int homeRow = piece->getIsWhite() ? 0 : ChessUtils::BOARD_SIZE - 1;
+    return isKingMoving(piece) && srcRow == homeRow && destRow == homeRow && srcCol == 4 &&
+        std::abs(destCol - srcCol) == 2;
+}
+//=================================================================================================
+// a pawn capturing diagonally onto the en passant square, past an enemy pawn
+bool Board::isEnPassantMove(int srcRow, int srcCol, int destRow, int destCol) const
+{
+    std::shared_ptr<Piece> piece = m_board[srcRow][srcCol];
+    if (m_enPassantSquare != Bitboards::squareIndex(destRow, destCol) ||
+        ChessUtils::getPieceIndex(piece->getSymbol()) != ChessUtils::PAWN_INDEX ||
+        destRow - srcRow != (piece->getIsWhite() ? 1 : -1) || std::abs(destCol - srcCol) != 1) {
+        return false;
+    }
+    std::shared_ptr<Piece> passedPawn = m_board[srcRow][destCol];
+    return passedPawn && passedPawn->getIsWhite() != piece->getIsWhite() &&
+        ChessUtils::getPieceIndex(passedPawn->getSymbol()) == ChessUtils::PAWN_INDEX;
+}
+//=================================================================================================
+// castling needs the right, its rook, empty squares between them and a king that
+// is not in check and does not pass an attacked square
+int Board::validateCastling(int srcRow, int srcCol, int destRow, int destCol)
+{
+    bool isWhite = m_board[srcRow][srcCol]->getIsWhite();
+    bool isKingside = destCol > srcCol;
+    int right = isWhite ? (isKingside ? Fen::WHITE_KINGSIDE : Fen::WHITE_QUEENSIDE) :
+        (isKingside ? Fen::BLACK_KINGSIDE : Fen::BLACK_QUEENSIDE);
+    int rookCol = isKingside ? ChessUtils::BOARD_SIZE - 1 : 0;
+    std::shared_ptr<Piece> rook = m_board[srcRow][rookCol];
+    if (!(m_castlingRights & right) || !rook || rook->getIsWhite() != isWhite ||
+        ChessUtils::getPieceIndex(rook->getSymbol()) != ChessUtils::ROOK_INDEX) {
+        return 21;
+    }
+
+    for (int col = std::min(srcCol, rookCol) + 1; col < std::max(srcCol, rookCol); col++) {
+        if (m_board[srcRow][col]) {
+            return 21;
+        }
+    }
+
+    Bitboard occupancy = getOccupancy();
+    Bitboard enemies = getColorPieces(!isWhite);
+    for (int col : { srcCol, (srcCol + destCol) / 2 }) {
+        if (getAttackersTo(Bitboards::squareIndex(srcRow, col), occupancy) & enemies) {
+            return 21;
+        }
+    }
+    return validateByPlaying(srcRow, srcCol, destRow, destCol);
+}
+//=================================================================================================
+// plays the move and takes it back to find its code, for the moves that move two pieces
+int Board::validateByPlaying(int srcRow, int srcCol, int destRow, int destCol)
+{
+    bool isWhite = m_isWhiteTurn;
+    makeMove(srcRow, srcCol, destRow, destCol);
+    bool selfCheck = isKingInCheck(isWhite);
+    bool causesCheck = isKingInCheck(!isWhite);
+    undoMove();
+
+    if (selfCheck) {
+        return 31;
+    }
+    return causesCheck ? 41 : 42;
+}
+//=================================================================================================
+// moves the castling rook along the given row, evaluation terms included
+void Board::moveCastlingRook(int row, int srcCol, int destCol)
+{
+    std::shared_ptr<Piece> rook = m_board[row][srcCol];
+    addPieceTerms(rook, row, srcCol, -1);
+    addPieceTerms(rook, row, destCol, 1);
+    m_board[row][destCol] = rook;
+    m_board[row][srcCol] = nullptr;
+    rook->setPosition(row, destCol);
+}
+//=================================================================================================
+// Zobrist keys of the castling rights and en passant column
+uint64_t Board::getGameStateKey() const
+{
+    uint64_t key = Zobrist::KEYS.castling[m_castlingRights];
+    if (m_enPassantSquare != Fen::NO_SQUARE) {
+        key ^= Zobrist::KEYS.enPassant[Bitboards::squareCol(m_enPassantSquare)];
+    }
+    return key;
 }
 //===============================================================
 // returns piece at given coordinates
@@ -174,11 +471,403 @@ bool Board::isKingInCheck(bool isWhiteKing)
     return false;
 }
 //=================================================================================================
+// material balance (white minus black) in piece values
+int Board::getMaterialScore() const
+{
+    return m_materialScore;
+}
+//=================================================================================================
+// piece-square balance (white minus black), blended between middlegame and endgame tables
+int Board::getPositionalScore() const
+{
+    return ChessUtils::getTaperedScore(m_positionalScores[ChessUtils::MIDDLEGAME],
+        m_positionalScores[ChessUtils::ENDGAME], m_phaseWeight);
+}
+//=================================================================================================
+// non-pawn material left on the board, in phase weight units
+int Board::getPhaseWeight() const
+{
+    return m_phaseWeight;
+}
+//=================================================================================================
+// static evaluation of the position from the given side's point of view, O(1)
+int Board::getEvaluation(bool forWhite) const
+{
+    int evaluation = m_materialScore * ChessUtils::CAPTURE_MULTIPLIER + getPositionalScore();
+    return forWhite ? evaluation : -evaluation;
+}
+//=================================================================================================
+// attaches (or detaches, with nullptr) an NNUE network and builds the current accumulator
+void Board::setNetwork(std::shared_ptr<const NnueNetwork> network)
+{
+    m_network = network;
+    m_accumulators.clear();
+    if (m_network) {
+        m_accumulators.resize(1);
+        refreshAccumulator(m_accumulators.back(), Bitboards::WHITE);
+        refreshAccumulator(m_accumulators.back(), Bitboards::BLACK);
+    }
+}
+//=================================================================================================
+bool Board::hasNetwork() const
+{
+    return m_network != nullptr;
+}
+//=================================================================================================
+// network evaluation in engine units, only valid while a network is attached
+int Board::getNetworkEvaluation() const
+{
+    int centipawns = m_network->evaluate(m_accumulators.back(), m_isWhiteTurn);
+    return centipawns * ChessUtils::PAWN_VALUE * ChessUtils::CAPTURE_MULTIPLIER / Nnue::CENTIPAWNS_PER_PAWN;
+}
+//=================================================================================================
+// accumulator of the current position, only valid while a network is attached
+const NnueAccumulator& Board::getAccumulator() const
+{
+    return m_accumulators.back();
+}
+//=================================================================================================
+// rebuilds one perspective of the accumulator from the piece sets
+void Board::refreshAccumulator(NnueAccumulator& accumulator, int perspective) const
+{
+    int kingRow = perspective == Bitboards::WHITE ? m_whiteKingRow : m_blackKingRow;
+    int kingCol = perspective == Bitboards::WHITE ? m_whiteKingCol : m_blackKingCol;
+    m_network->refreshAccumulator(accumulator, perspective, Bitboards::squareIndex(kingRow, kingCol), m_pieceBitboards);
+}
+//=================================================================================================
+// copies the accumulator and applies the move to it, a king move refreshes its own side
+void Board::pushAccumulator(const MoveRecord& record, const std::shared_ptr<Piece>& piece)
+{
+    m_accumulators.push_back(m_accumulators.back());
+    NnueAccumulator& accumulator = m_accumulators.back();
+
+    // Castling, en passant and promotions change more than two features, they are rare enough to rebuild
+    bool isCastling = isKingMoving(piece) && std::abs(record.destCol - record.srcCol) == 2;
+    if (isCastling || record.promotedPawn || record.capturedRow != record.destRow) {
+        refreshAccumulator(accumulator, Bitboards::WHITE);
+        refreshAccumulator(accumulator, Bitboards::BLACK);
+        return;
+    }
+
+    int movingColor = Bitboards::colorIndex(piece->getIsWhite());
+    int pieceIndex = ChessUtils::getPieceIndex(piece->getSymbol());
+    int srcSquare = Bitboards::squareIndex(record.srcRow, record.srcCol);
+    int destSquare = Bitboards::squareIndex(record.destRow, record.destCol);
+
+    for (int perspective = 0; perspective < Bitboards::COLOR_COUNT; perspective++) {
+        if (pieceIndex == ChessUtils::KING_INDEX && perspective == movingColor) {
+            refreshAccumulator(accumulator, perspective);
+            continue;
+        }
+
+        int kingRow = perspective == Bitboards::WHITE ? m_whiteKingRow : m_blackKingRow;
+        int kingCol = perspective == Bitboards::WHITE ? m_whiteKingCol : m_blackKingCol;
+        int kingSquare = Bitboards::squareIndex(kingRow, kingCol);
+
+        if (record.capturedPiece) {
+            m_network->removeFeature(accumulator, perspective, kingSquare, 1 - movingColor,
+                ChessUtils::getPieceIndex(record.capturedPiece->getSymbol()), destSquare);
+        }
+        if (pieceIndex != ChessUtils::KING_INDEX) {
+            m_network->removeFeature(accumulator, perspective, kingSquare, movingColor, pieceIndex, srcSquare);
+            m_network->addFeature(accumulator, perspective, kingSquare, movingColor, pieceIndex, destSquare);
+        }
+    }
+}
+//=================================================================================================
+// hash of the pieces and the side to move
+uint64_t Board::getHash() const
+{
+    return m_hash;
+}
+//=================================================================================================
+// hash of the pawns only, pawn structure terms depend on nothing else
+uint64_t Board::getPawnHash() const
+{
+    return m_pawnHash;
+}
+//=================================================================================================
+// adds (sign = 1) or removes (sign = -1) the evaluation terms of a piece standing on a square
+void Board::addPieceTerms(const std::shared_ptr<Piece>& piece, int row, int col, int sign)
+{
+    int pieceIndex = ChessUtils::getPieceIndex(piece->getSymbol());
+    int colorSign = piece->getIsWhite() ? sign : -sign;
+    int square = Bitboards::squareIndex(row, col);
+
+    // Adding and removing both flip the square's bit
+    int colorIndex = Bitboards::colorIndex(piece->getIsWhite());
+    m_pieceBitboards[colorIndex][pieceIndex] ^= Bitboards::squareBit(square);
+    m_colorBitboards[colorIndex] ^= Bitboards::squareBit(square);
+    m_hash ^= Zobrist::pieceKey(colorIndex, pieceIndex, square);
+    if (pieceIndex == ChessUtils::PAWN_INDEX) {
+        m_pawnHash ^= Zobrist::pieceKey(colorIndex, pieceIndex, square);
+    }
+
+    m_materialScore += colorSign * ChessUtils::PIECE_VALUES[pieceIndex];
+    m_phaseWeight += sign * ChessUtils::PHASE_WEIGHTS[pieceIndex];
+    for (int phase = 0; phase < ChessUtils::PHASE_COUNT; phase++) {
+        m_positionalScores[phase] += colorSign * ChessUtils::PIECE_SQUARE_TABLES[phase][pieceIndex][square];
+    }
+}
+//=================================================================================================
+// fills the list with every legal move of the side to move
+void Board::generateLegalMoves(std::vector<BoardMove>& moves)
+{
+    CHESS_ALLOCATION_PHASE(MOVE_GENERATION);
+    Bitboard pieces = getColorPieces(m_isWhiteTurn);
+    while (pieces) {
+        int square = Bitboards::popLowestSquare(pieces);
+        int srcRow = Bitboards::squareRow(square);
+        int srcCol = Bitboards::squareCol(square);
+
+        // Only squares the piece could reach go through the full validation
+        Bitboard targets = getCandidateTargets(srcRow, srcCol);
+        while (targets) {
+            int target = Bitboards::popLowestSquare(targets);
+            int destRow = Bitboards::squareRow(target);
+            int destCol = Bitboards::squareCol(target);
+
+            int moveCode = validateMove(srcRow, srcCol, destRow, destCol);
+            if (moveCode != ChessUtils::VALID_MOVE && moveCode != ChessUtils::VALID_MOVE_CHECK) {
+                continue;
+            }
+
+            // A pawn reaching the last row makes one move per promotion piece, queen first
+            bool isPromotion = (destRow == 0 || destRow == ChessUtils::BOARD_SIZE - 1) &&
+                ChessUtils::getPieceIndex(m_board[srcRow][srcCol]->getSymbol()) == ChessUtils::PAWN_INDEX;
+            if (!isPromotion) {
+                moves.push_back({ srcRow, srcCol, destRow, destCol });
+                continue;
+            }
+            for (int pieceIndex = ChessUtils::QUEEN_INDEX; pieceIndex >= ChessUtils::KNIGHT_INDEX; pieceIndex--) {
+                moves.push_back({ srcRow, srcCol, destRow, destCol, pieceIndex });
+            }
+        }
+    }
+}
+//=================================================================================================
+// counts the leaf positions depth plies down, every move made and taken back
+uint64_t Board::perft(int depth)
+{
+    if (depth <= 0) {
+        return 1;
+    }
+
+    std::vector<BoardMove> moves;
+    generateLegalMoves(moves);
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    uint64_t nodes = 0;
+    for (const BoardMove& move : moves) {
+        makeMove(move);
+        nodes += perft(depth - 1);
+        undoMove();
+    }
+    return nodes;
+}
+//=================================================================================================
+// squares the piece on the given square may move to, before legality checks
+Bitboard Board::getCandidateTargets(int row, int col) const
+{
+    std::shared_ptr<Piece> piece = m_board[row][col];
+    int square = Bitboards::squareIndex(row, col);
+    int colorIndex = Bitboards::colorIndex(piece->getIsWhite());
+    Bitboard occupancy = getOccupancy();
+    Bitboard targets = 0;
+
+    switch (ChessUtils::getPieceIndex(piece->getSymbol())) {
+    case ChessUtils::PAWN_INDEX: {
+        int direction = piece->getIsWhite() ? 1 : -1;
+        targets = Bitboards::PAWN_ATTACKS[colorIndex][square];
+        for (int step = 1; step <= 2; step++) {
+            int destRow = row + step * direction;
+            if (Bitboards::isOnBoard(destRow, col)) {
+                targets |= Bitboards::squareBit(Bitboards::squareIndex(destRow, col));
+            }
+        }
+        break;
+    }
+    case ChessUtils::KNIGHT_INDEX:
+        targets = Bitboards::KNIGHT_ATTACKS[square];
+        break;
+    case ChessUtils::BISHOP_INDEX:
+        targets = Bitboards::bishopAttacks(square, occupancy);
+        break;
+    case ChessUtils::ROOK_INDEX:
+        targets = Bitboards::rookAttacks(square, occupancy);
+        break;
+    case ChessUtils::QUEEN_INDEX:
+        targets = Bitboards::rookAttacks(square, occupancy) | Bitboards::bishopAttacks(square, occupancy);
+        break;
+    case ChessUtils::KING_INDEX:
+        targets = Bitboards::KING_ATTACKS[square];
+        // Castling squares, validateMove checks the rights and the path
+        if (col == 4 && (m_castlingRights & (piece->getIsWhite() ?
+            Fen::WHITE_KINGSIDE | Fen::WHITE_QUEENSIDE : Fen::BLACK_KINGSIDE | Fen::BLACK_QUEENSIDE))) {
+            targets |= Bitboards::squareBit(square + 2) | Bitboards::squareBit(square - 2);
+        }
+        break;
+    }
+
+    return targets & ~m_colorBitboards[colorIndex];
+}
+//=================================================================================================
+// squares of one piece type and color
+Bitboard Board::getPieces(bool isWhite, int pieceIndex) const
+{
+    return m_pieceBitboards[Bitboards::colorIndex(isWhite)][pieceIndex];
+}
+//=================================================================================================
+// squares of every piece of one color
+Bitboard Board::getColorPieces(bool isWhite) const
+{
+    return m_colorBitboards[Bitboards::colorIndex(isWhite)];
+}
+//=================================================================================================
+// squares of every piece on the board
+Bitboard Board::getOccupancy() const
+{
+    return m_colorBitboards[Bitboards::WHITE] | m_colorBitboards[Bitboards::BLACK];
+}
+//=================================================================================================
+// pieces of both colors attacking the square, sliders see through the given occupancy
+Bitboard Board::getAttackersTo(int square, Bitboard occupancy) const
+{
+    const auto& white = m_pieceBitboards[Bitboards::WHITE];
+    const auto& black = m_pieceBitboards[Bitboards::BLACK];
+
+    Bitboard knights = white[ChessUtils::KNIGHT_INDEX] | black[ChessUtils::KNIGHT_INDEX];
+    Bitboard kings = white[ChessUtils::KING_INDEX] | black[ChessUtils::KING_INDEX];
+    Bitboard queens = white[ChessUtils::QUEEN_INDEX] | black[ChessUtils::QUEEN_INDEX];
+    Bitboard rooks = white[ChessUtils::ROOK_INDEX] | black[ChessUtils::ROOK_INDEX] | queens;
+    Bitboard bishops = white[ChessUtils::BISHOP_INDEX] | black[ChessUtils::BISHOP_INDEX] | queens;
+
+    // A pawn attacks the square if a pawn of the other color on the square would attack it
+    return (Bitboards::PAWN_ATTACKS[Bitboards::BLACK][square] & white[ChessUtils::PAWN_INDEX]) |
+        (Bitboards::PAWN_ATTACKS[Bitboards::WHITE][square] & black[ChessUtils::PAWN_INDEX]) |
+        (Bitboards::KNIGHT_ATTACKS[square] & knights) |
+        (Bitboards::KING_ATTACKS[square] & kings) |
+        (Bitboards::rookAttacks(square, occupancy) & rooks) |
+        (Bitboards::bishopAttacks(square, occupancy) & bishops);
+}
+//=================================================================================================
+// material the given side wins by starting a capture sequence on the square with
+// its cheapest attacker, 0 if it has no attacker or the exchange does not pay
+int Board::staticExchangeEvaluation(int square, bool attackerIsWhite) const
+{
+    Bitboard occupancy = getOccupancy();
+    Bitboard attackers = getAttackersTo(square, occupancy) & getColorPieces(attackerIsWhite);
+
+    int pieceIndex = 0;
+    int fromSquare = getLeastValuableAttacker(attackers, attackerIsWhite, pieceIndex);
+    if (fromSquare < 0) {
+        return 0;
+    }
+    return std::max(0, resolveExchange(square, fromSquare, attackerIsWhite, occupancy));
+}
+//=================================================================================================
+// material won (or lost, if negative) by the move and the capture sequence it starts
+int Board::staticExchangeEvaluation(const BoardMove& move) const
+{
+    bool isWhite = m_board[move.srcRow][move.srcCol]->getIsWhite();
+    return resolveExchange(Bitboards::squareIndex(move.destRow, move.destCol),
+        Bitboards::squareIndex(move.srcRow, move.srcCol), isWhite, getOccupancy());
+}
+//=================================================================================================
+// swap algorithm: both sides recapture with their cheapest piece and may stop whenever
+// continuing loses material, removed pieces reveal the sliders behind them
+int Board::resolveExchange(int square, int fromSquare, bool isWhite, Bitboard occupancy) const
+{
+    // One entry per capture, there are never more captures than pieces
+    int gain[ChessUtils::SQUARE_COUNT];
+    int depth = 0;
+
+    std::shared_ptr<Piece> victim = m_board[Bitboards::squareRow(square)][Bitboards::squareCol(square)];
+    std::shared_ptr<Piece> attacker = m_board[Bitboards::squareRow(fromSquare)][Bitboards::squareCol(fromSquare)];
+    gain[0] = victim ? ChessUtils::getPieceValue(victim->getSymbol()) : 0;
+    int attackerValue = ChessUtils::getPieceValue(attacker->getSymbol());
+    bool side = isWhite;
+
+    while (true) {
+        depth++;
+        gain[depth] = attackerValue - gain[depth - 1];
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break;
+        }
+
+        occupancy &= ~Bitboards::squareBit(fromSquare);
+        Bitboard attackers = getAttackersTo(square, occupancy) & occupancy;
+        side = !side;
+
+        int pieceIndex = 0;
+        fromSquare = getLeastValuableAttacker(attackers, side, pieceIndex);
+        if (fromSquare < 0) {
+            break;
+        }
+        attackerValue = ChessUtils::PIECE_VALUES[pieceIndex];
+    }
+
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+//=================================================================================================
+// square of the cheapest attacker of the given color, -1 if there is none
+int Board::getLeastValuableAttacker(Bitboard attackers, bool isWhite, int& pieceIndex) const
+{
+    const auto& pieces = m_pieceBitboards[Bitboards::colorIndex(isWhite)];
+    for (pieceIndex = 0; pieceIndex < ChessUtils::PIECE_TYPE_COUNT; pieceIndex++) {
+        Bitboard candidates = attackers & pieces[pieceIndex];
+        if (candidates) {
+            return Bitboards::lowestSquare(candidates);
+        }
+    }
+    return -1;
+}
+//=================================================================================================
 // function returns true if its whight turn
 bool Board::getIsWhiteTurn() const
 {
     return m_isWhiteTurn;
 }
+//=================================================================================================
+int Board::getCastlingRights() const
+{
+    return m_castlingRights;
+}
+//=================================================================================================
+int Board::getEnPassantSquare() const
+{
+    return m_enPassantSquare;
+}
+//=================================================================================================
+int Board::getHalfmoveClock() const
+{
+    return m_halfmoveClock;
+}
+//=================================================================================================
+// current position and game state as FEN
+std::string Board::toFen() const
+{
+    FenPosition position;
+    position.boardString.assign(ChessUtils::SQUARE_COUNT, '#');
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (m_board[row][col]) {
+                position.boardString[Bitboards::squareIndex(row, col)] = m_board[row][col]->getSymbol();
+            }
+        }
+    }
+    position.isWhiteTurn = m_isWhiteTurn;
+    position.castlingRights = m_castlingRights;
+    position.enPassantSquare = m_enPassantSquare;
+    position.halfmoveClock = m_halfmoveClock;
+    position.fullmoveNumber = m_fullmoveNumber;
+    return Fen::format(position);
+}
 
 
 //=================================================================================================
@@ -271,6 +960,8 @@ void Board::restoreBoardPos(std::shared_ptr<Piece> piece, std::shared_ptr<Piece>
 
 // Save the complete state of the board
 BoardState Board::saveState() const {
+    CHESS_TRACE_SCOPE("Board::saveState");
+    CHESS_ALLOCATION_PHASE(BOARD_STATE);
     BoardState state;
 
     // Copy the entire board grid using deep copy of each piece
@@ -295,15 +986,48 @@ BoardState Board::saveState() const {
     state.blackKingRow = m_blackKingRow;
     state.blackKingCol = m_blackKingCol;
 
+    // Save the game state
+    state.castlingRights = m_castlingRights;
+    state.enPassantSquare = m_enPassantSquare;
+    state.halfmoveClock = m_halfmoveClock;
+    state.fullmoveNumber = m_fullmoveNumber;
+
+    // Save evaluation terms and undo history length
+    state.materialScore = m_materialScore;
+    state.positionalScores = m_positionalScores;
+    state.phaseWeight = m_phaseWeight;
+    state.historySize = m_history.size();
+
     return state;
 }
 
 // Restore the board to a previously saved state
 void Board::restoreState(const BoardState& state) {
-    // Restore the board grid
+    CHESS_TRACE_SCOPE("Board::restoreState");
+    CHESS_ALLOCATION_PHASE(BOARD_STATE);
+    // Restore the board grid, the piece sets and the hash keys
+    m_pieceBitboards = {};
+    m_colorBitboards = {};
+    m_hash = state.isWhiteTurn ? 0 : Zobrist::KEYS.blackToMove;
+    m_pawnHash = 0;
     for (int row = 0; row < 8; row++) {
         for (int col = 0; col < 8; col++) {
-            m_board[row][col] = state.boardGrid[row][col];
+            // Fresh pieces, so the state can be restored again after moves changed them
+            m_board[row][col] = nullptr;
+            if (state.boardGrid[row][col]) {
+                m_board[row][col] = PieceFactory::createPiece(state.boardGrid[row][col]->getSymbol(), row, col);
+                int colorIndex = Bitboards::colorIndex(m_board[row][col]->getIsWhite());
+                int pieceIndex = ChessUtils::getPieceIndex(m_board[row][col]->getSymbol());
+                Bitboard bit = Bitboards::squareBit(Bitboards::squareIndex(row, col));
+                m_pieceBitboards[colorIndex][pieceIndex] |= bit;
+                m_colorBitboards[colorIndex] |= bit;
+
+                uint64_t key = Zobrist::pieceKey(colorIndex, pieceIndex, Bitboards::squareIndex(row, col));
+                m_hash ^= key;
+                if (pieceIndex == ChessUtils::PAWN_INDEX) {
+                    m_pawnHash ^= key;
+                }
+            }
         }
     }
 
@@ -315,6 +1039,26 @@ void Board::restoreState(const BoardState& state) {
     m_whiteKingCol = state.whiteKingCol;
     m_blackKingRow = state.blackKingRow;
     m_blackKingCol = state.blackKingCol;
+
+    // Restore the game state
+    m_castlingRights = state.castlingRights;
+    m_enPassantSquare = state.enPassantSquare;
+    m_halfmoveClock = state.halfmoveClock;
+    m_fullmoveNumber = state.fullmoveNumber;
+    m_hash ^= getGameStateKey();
+
+    // Restore evaluation terms and drop moves made after the save
+    m_materialScore = state.materialScore;
+    m_positionalScores = state.positionalScores;
+    m_phaseWeight = state.phaseWeight;
+    if (m_history.size() > state.historySize) {
+        m_history.resize(state.historySize);
+    }
+    if (m_network) {
+        m_accumulators.resize(m_history.size() + 1);
+        refreshAccumulator(m_accumulators.back(), Bitboards::WHITE);
+        refreshAccumulator(m_accumulators.back(), Bitboards::BLACK);
+    }
 }
 
 
@@ -0,0 +1,180 @@
+#include "Board/Fen.h"
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <stdexcept>
+
+namespace {
+    const char CASTLING_SYMBOLS[] = { 'K', 'Q', 'k', 'q' };
+
+    // strict non-negative integer field
+    int parseCounter(std::string_view text, const std::string& fen) {
+        if (text.empty() || text.size() > 6 ||
+            !std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            throw std::runtime_error("Error: bad move counter in FEN " + fen);
+        }
+        int value = 0;
+        for (char digit : text) {
+            value = value * 10 + (digit - '0');
+        }
+        return value;
+    }
+
+    // next whitespace separated field from pos on, empty past the last one
+    std::string_view nextField(std::string_view text, size_t& pos) {
+        auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+        while (pos < text.size() && isSpace(text[pos])) {
+            pos++;
+        }
+        size_t start = pos;
+        while (pos < text.size() && !isSpace(text[pos])) {
+            pos++;
+        }
+        return text.substr(start, pos - start);
+    }
+}
+
+//======================================================================
+// the fields are views of fen, only the board string is built
+FenPosition Fen::parse(const std::string& fen)
+{
+    size_t pos = 0;
+    std::string_view placement = nextField(fen, pos);
+    std::string_view side = nextField(fen, pos);
+    std::string_view castling = nextField(fen, pos);
+    std::string_view enPassant = nextField(fen, pos);
+    std::string_view halfmove = nextField(fen, pos);
+    std::string_view fullmove = nextField(fen, pos);
+
+    FenPosition position;
+    position.boardString.assign(ChessUtils::SQUARE_COUNT, '#');
+    int row = ChessUtils::BOARD_SIZE - 1;
+    int col = 0;
+    for (char symbol : placement) {
+        if (symbol == '/') {
+            if (col != ChessUtils::BOARD_SIZE || --row < 0) {
+                throw std::runtime_error("Error: bad FEN row in " + fen);
+            }
+            col = 0;
+        }
+        else if (symbol >= '1' && symbol <= '8') {
+            col += symbol - '0';
+        }
+        else if (std::isalpha(static_cast<unsigned char>(symbol)) && ChessUtils::getPieceIndex(symbol) >= 0 &&
+            col < ChessUtils::BOARD_SIZE) {
+            position.boardString[Bitboards::squareIndex(row, col++)] = symbol;
+        }
+        else {
+            throw std::runtime_error("Error: bad FEN symbol in " + fen);
+        }
+        if (col > ChessUtils::BOARD_SIZE) {
+            throw std::runtime_error("Error: bad FEN row in " + fen);
+        }
+    }
+    if (row != 0 || col != ChessUtils::BOARD_SIZE) {
+        throw std::runtime_error("Error: FEN " + fen + " does not cover the board");
+    }
+
+    if (side == "b") {
+        position.isWhiteTurn = false;
+    }
+    else if (!side.empty() && side != "w") {
+        throw std::runtime_error("Error: bad side to move in FEN " + fen);
+    }
+
+    if (!castling.empty() && castling != "-") {
+        for (char symbol : castling) {
+            const char* found = std::find(std::begin(CASTLING_SYMBOLS), std::end(CASTLING_SYMBOLS), symbol);
+            if (found == std::end(CASTLING_SYMBOLS)) {
+                throw std::runtime_error("Error: bad castling rights in FEN " + fen);
+            }
+            position.castlingRights |= 1 << (found - std::begin(CASTLING_SYMBOLS));
+        }
+    }
+
+    if (!enPassant.empty()) {
+        try {
+            position.enPassantSquare = parseSquare(std::string(enPassant));
+        }
+        catch (const std::runtime_error&) {
+            throw std::runtime_error("Error: bad en passant square in FEN " + fen);
+        }
+    }
+    if (!halfmove.empty()) {
+        position.halfmoveClock = parseCounter(halfmove, fen);
+    }
+    if (!fullmove.empty()) {
+        position.fullmoveNumber = std::max(1, parseCounter(fullmove, fen));
+    }
+
+    // Board keeps track of both kings, so each side needs exactly one
+    if (std::count(position.boardString.begin(), position.boardString.end(), 'K') != 1 ||
+        std::count(position.boardString.begin(), position.boardString.end(), 'k') != 1) {
+        throw std::runtime_error("Error: position " + fen + " needs one king per side");
+    }
+    return position;
+}
+
+//======================================================================
+std::string Fen::format(const FenPosition& position)
+{
+    std::string fen;
+    for (int row = ChessUtils::BOARD_SIZE - 1; row >= 0; row--) {
+        int emptySquares = 0;
+        for (int col = 0; col < ChessUtils::BOARD_SIZE; col++) {
+            char symbol = position.boardString[Bitboards::squareIndex(row, col)];
+            if (symbol == '#') {
+                emptySquares++;
+                continue;
+            }
+            if (emptySquares > 0) {
+                fen += static_cast<char>('0' + emptySquares);
+                emptySquares = 0;
+            }
+            fen += symbol;
+        }
+        if (emptySquares > 0) {
+            fen += static_cast<char>('0' + emptySquares);
+        }
+        if (row > 0) {
+            fen += '/';
+        }
+    }
+
+    fen += position.isWhiteTurn ? " w " : " b ";
+    if (position.castlingRights == 0) {
+        fen += '-';
+    }
+    for (int i = 0; i < 4; i++) {
+        if (position.castlingRights & (1 << i)) {
+            fen += CASTLING_SYMBOLS[i];
+        }
+    }
+    fen += ' ' + formatSquare(position.enPassantSquare);
+    fen += ' ' + std::to_string(position.halfmoveClock) + ' ' + std::to_string(position.fullmoveNumber);
+    return fen;
+}
+
+//======================================================================
+int Fen::parseSquare(const std::string& text)
+{
+    if (text == "-") {
+        return NO_SQUARE;
+    }
+    if (text.size() != 2 || text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8') {
+        throw std::runtime_error("Error: bad square " + text);
+    }
+    return Bitboards::squareIndex(text[1] - '1', text[0] - 'a');
+}
+
+//======================================================================
+std::string Fen::formatSquare(int square)
+{
+    if (square == NO_SQUARE) {
+        return "-";
+    }
+    std::string text = "a1";
+    text[0] = static_cast<char>('a' + Bitboards::squareCol(square));
+    text[1] = static_cast<char>('1' + Bitboards::squareRow(square));
+    return text;
+}
@@ -0,0 +1,39 @@
+#include "Board/MoveNotation.h"
+#include <cctype>
+
+//======================================================================
+std::string MoveNotation::format(const BoardMove& move)
+{
+    std::string text = "a1a1";
+    text[0] = static_cast<char>('a' + move.srcCol);
+    text[1] = static_cast<char>('1' + move.srcRow);
+    text[2] = static_cast<char>('a' + move.destCol);
+    text[3] = static_cast<char>('1' + move.destRow);
+    if (move.promotionIndex != ChessUtils::NO_PROMOTION) {
+        text += ChessUtils::getPieceSymbol(move.promotionIndex, false);
+    }
+    return text;
+}
+
+//======================================================================
+// a promotion letter (q, r, b or n) may follow the squares
+bool MoveNotation::parse(const std::string& text, BoardMove& move)
+{
+    if (text.size() < 4 || text.size() > 5) {
+        return false;
+    }
+    for (int i = 0; i < 4; i += 2) {
+        if (text[i] < 'a' || text[i] > 'h' || text[i + 1] < '1' || text[i + 1] > '8') {
+            return false;
+        }
+    }
+    move = { text[1] - '1', text[0] - 'a', text[3] - '1', text[2] - 'a' };
+    if (text.size() == 5) {
+        move.promotionIndex = ChessUtils::getPieceIndex(text[4]);
+        if (move.promotionIndex < ChessUtils::KNIGHT_INDEX || move.promotionIndex > ChessUtils::QUEEN_INDEX ||
+            !std::islower(static_cast<unsigned char>(text[4]))) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+#include "Book/OpeningBook.h"
+#include "Board/Fen.h"
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+    uint64_t readBigEndian(const char* data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value = (value << 8) | static_cast<unsigned char>(data[i]);
+        }
+        return value;
+    }
+
+    // Polyglot promotion field: none, knight, bishop, rook, queen
+    constexpr int PROMOTION_PIECES[5] = {
+        ChessUtils::NO_PROMOTION, ChessUtils::KNIGHT_INDEX, ChessUtils::BISHOP_INDEX,
+        ChessUtils::ROOK_INDEX, ChessUtils::QUEEN_INDEX
+    };
+
+    // Pieces, castling rights, en passant file (only if a pawn can take) and side to move
+    uint64_t computeKey(const std::array<uint64_t, Polyglot::KEY_COUNT>& keys, const Board& board) {
+        uint64_t key = 0;
+        for (int pieceIndex = 0; pieceIndex < ChessUtils::PIECE_TYPE_COUNT; pieceIndex++) {
+            for (bool isWhite : { false, true }) {
+                // Polyglot kinds alternate black and white: black pawn 0, white pawn 1, ...
+                int kind = pieceIndex * 2 + (isWhite ? 1 : 0);
+                Bitboard pieces = board.getPieces(isWhite, pieceIndex);
+                while (pieces) {
+                    key ^= keys[kind * ChessUtils::SQUARE_COUNT + Bitboards::popLowestSquare(pieces)];
+                }
+            }
+        }
+
+        // Castling bits are in Polyglot order: white short, white long, black short, black long
+        for (int right = 0; right < 4; right++) {
+            if (board.getCastlingRights() & (1 << right)) {
+                key ^= keys[Polyglot::CASTLING_KEYS + right];
+            }
+        }
+
+        int enPassantSquare = board.getEnPassantSquare();
+        if (enPassantSquare != Fen::NO_SQUARE) {
+            bool isWhite = board.getIsWhiteTurn();
+            Bitboard takers = Bitboards::PAWN_ATTACKS[Bitboards::colorIndex(!isWhite)][enPassantSquare] &
+                board.getPieces(isWhite, ChessUtils::PAWN_INDEX);
+            if (takers) {
+                key ^= keys[Polyglot::EN_PASSANT_KEYS + Bitboards::squareCol(enPassantSquare)];
+            }
+        }
+
+        if (board.getIsWhiteTurn()) {
+            key ^= keys[Polyglot::TURN_KEY];
+        }
+        return key;
+    }
+}
+
+//======================================================================
+// c-tor, maps the book and reads the key table
+OpeningBook::OpeningBook(const std::string& bookPath, const std::string& keysPath)
+    : OpeningBook(bookPath, readKeys(keysPath))
+{
+}
+
+//======================================================================
+// c-tor, maps the book
+OpeningBook::OpeningBook(const std::string& bookPath, const std::array<uint64_t, Polyglot::KEY_COUNT>& keys)
+    : m_file(bookPath, false), m_entryCount(m_file.getSize() / Polyglot::ENTRY_SIZE), m_keys(keys)
+{
+    if (m_file.getSize() % Polyglot::ENTRY_SIZE != 0) {
+        throw std::runtime_error("Error: book " + bookPath + " is not a Polyglot book");
+    }
+}
+
+//======================================================================
+uint64_t OpeningBook::getKey(const Board& board) const
+{
+    return computeKey(m_keys, board);
+}
+
+//======================================================================
+// binary search for the first entry of the key, then a walk over that key's entries
+bool OpeningBook::probe(const Board& board, BookSelection selection, uint64_t randomValue, BoardMove& move) const
+{
+    uint64_t key = getKey(board);
+    size_t low = 0;
+    size_t high = m_entryCount;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (getEntryKey(middle) < key) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    size_t end = low;
+    uint64_t totalWeight = 0;
+    size_t bestEntry = low;
+    for (; end < m_entryCount && getEntryKey(end) == key; end++) {
+        uint16_t weight = getEntryValue(end, Polyglot::WEIGHT_OFFSET);
+        totalWeight += weight;
+        if (weight > getEntryValue(bestEntry, Polyglot::WEIGHT_OFFSET)) {
+            bestEntry = end;
+        }
+    }
+    if (end == low) {
+        return false;
+    }
+
+    // A draw over the weights, all-zero weights fall back to the best entry
+    size_t chosen = bestEntry;
+    if (selection == BookSelection::WEIGHTED && totalWeight > 0) {
+        uint64_t draw = randomValue % totalWeight;
+        for (chosen = low; chosen < end; chosen++) {
+            uint16_t weight = getEntryValue(chosen, Polyglot::WEIGHT_OFFSET);
+            if (draw < weight) {
+                break;
+            }
+            draw -= weight;
+        }
+    }
+
+    move = decodeMove(board, getEntryValue(chosen, Polyglot::MOVE_OFFSET));
+    return true;
+}
+
+//======================================================================
+uint64_t OpeningBook::getEntryKey(size_t entry) const
+{
+    return readBigEndian(m_file.getContents().data() + entry * Polyglot::ENTRY_SIZE, sizeof(uint64_t));
+}
+
+//======================================================================
+uint16_t OpeningBook::getEntryValue(size_t entry, size_t offset) const
+{
+    return static_cast<uint16_t>(readBigEndian(m_file.getContents().data() + entry * Polyglot::ENTRY_SIZE + offset,
+        sizeof(uint16_t)));
+}
+
+//======================================================================
+// destination file and rank, source file and rank, promotion: 3 bits each from the low end
+BoardMove OpeningBook::decodeMove(const Board& board, uint16_t rawMove) const
+{
+    BoardMove move;
+    move.destCol = rawMove & 7;
+    move.destRow = (rawMove >> 3) & 7;
+    move.srcCol = (rawMove >> 6) & 7;
+    move.srcRow = (rawMove >> 9) & 7;
+    int promotion = (rawMove >> 12) & 7;
+    move.promotionIndex = promotion < 5 ? PROMOTION_PIECES[promotion] : ChessUtils::NO_PROMOTION;
+
+    // Castling is written as the king taking its own rook
+    bool isKing = board.getPieces(board.getIsWhiteTurn(), ChessUtils::KING_INDEX) &
+        Bitboards::squareBit(Bitboards::squareIndex(move.srcRow, move.srcCol));
+    if (isKing && move.srcCol == 4 && move.srcRow == move.destRow && (move.destCol == 0 || move.destCol == 7)) {
+        move.destCol = move.destCol == 7 ? 6 : 2;
+    }
+    return move;
+}
+
+//======================================================================
+size_t OpeningBook::getEntryCount() const
+{
+    return m_entryCount;
+}
+
+//======================================================================
+// every "0x..." literal in order, the C array syntax around them is skipped
+std::array<uint64_t, Polyglot::KEY_COUNT> OpeningBook::readKeys(const std::string& keysPath)
+{
+    std::array<uint64_t, Polyglot::KEY_COUNT> keys{};
+    MappedFile keysFile(keysPath);
+    std::string_view text = keysFile.getContents();
+    size_t keyCount = 0;
+    for (size_t pos = text.find("0x"); pos != std::string_view::npos; pos = text.find("0x", pos)) {
+        pos += 2;
+        uint64_t key = 0;
+        for (; pos < text.size() && std::isxdigit(static_cast<unsigned char>(text[pos])); pos++) {
+            int digit = std::isdigit(static_cast<unsigned char>(text[pos])) ? text[pos] - '0' :
+                (text[pos] | 0x20) - 'a' + 10;
+            key = (key << 4) | digit;
+        }
+        if (keyCount == Polyglot::KEY_COUNT) {
+            keyCount++;
+            break;
+        }
+        keys[keyCount++] = key;
+    }
+
+    Board startBoard(Fen::parse(ChessUtils::START_FEN));
+    if (keyCount != Polyglot::KEY_COUNT || computeKey(keys, startBoard) != Polyglot::START_POSITION_KEY) {
+        throw std::runtime_error("Error: " + keysPath + " doesn't hold the Polyglot Random64 table");
+    }
+    return keys;
+}
@@ -1,195 +1,22 @@
 #include "Chess.h"
 #include <iostream>
 #include <string>
+#include <sstream>
 
 using namespace std;
 
-#ifdef _WIN32
-
-// clear the screen "cls"
-void Chess::clear() const 
+// draw the board and the messages, then the extra text and the prompt
+void Chess::displayBoard(const string& extraText)
 {
-	COORD topLeft = { 0, 0 };
-	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
-	CONSOLE_SCREEN_BUFFER_INFO screen;
-	DWORD written;
-
-	GetConsoleScreenBufferInfo(console, &screen);
-	FillConsoleOutputCharacterA(
-		console, ' ', screen.dwSize.X * screen.dwSize.Y, topLeft, &written
-	);
-	FillConsoleOutputAttribute(
-		console, FOREGROUND_GREEN | FOREGROUND_RED | FOREGROUND_BLUE,
-		screen.dwSize.X * screen.dwSize.Y, topLeft, &written
-	);
-	SetConsoleCursorPosition(console, topLeft);
+	m_renderer.render(m_gameBoard, m_msg + m_errorMsg + extraText + getAskInput());
 }
-
-// create the GUI - ASCII art
-void Chess::setFrames() 
-{ 
-	for (size_t row = 0; row < _SIZE; ++row)
-		for (size_t col = 0; col < _SIZE; ++col)
-			m_board[row][col] = 32;
-
-	m_board[0][0] = 201;  m_board[0][20] = 187;
-	m_board[20][0] = 200; m_board[20][20] = 188;
-
-	for (size_t i = 1; i < 20; ++i)
-	{
-		m_board[0][i] = 205;
-		m_board[20][i] = 205;
-		m_board[i][0] = 186;
-		m_board[i][20] = 186;
-	} 
-
-	m_board[2][2] = 218;  m_board[2][18] = 191;
-	m_board[18][2] = 192; m_board[18][18] = 217;
-
-	for (size_t i = 4; i < 17; i += 2)
-	{
-		m_board[2][i] = 194;
-		m_board[18][i] = 193;
-		m_board[i][2] = 195;
-		m_board[i][18] = 180;
-	}
-
-	for (size_t i = 2; i < 19; i += 2)
-		for (size_t j = 3; j < 19; j += 2)
-			m_board[i][j] = 196;
-
-	for (size_t i = 3; i < 18; i += 2)
-		for (size_t j = 2; j < 19; j += 2)
-			m_board[i][j] = 179;
-
-	for (size_t i = 4; i < 17; i += 2)
-		for (size_t j = 4; j < 17; j += 2)
-			m_board[i][j] = 197;
-
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[2][i] = 194;
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[18][i] = 193;
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[i][2] = 195;
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[i][18] = 180;
-
-	for (size_t i = 3, t = 0; i < 19; i += 2, ++t)
-		m_board[1][i] = m_board[19][i] = ('1' + t);
-
-	for (size_t i = 3, t = 0; i < 19; i += 2, ++t)
-		m_board[i][1] = m_board[i][19] = ('A' + t);
-}
-
-void Chess::setPieces()
-{
-	for (size_t row = 0, t = 0; row < 8; ++row)
-		for (size_t col = 0; col < 8; ++col, ++t)
-			m_board[(3 + (row * 2))][(3 + (col * 2))] = ((m_boardString[t] == '#') ? 32 : m_boardString[t]);
-}
-
-#else // non-Windows
-
-void Chess::clear() const
+// the prompt of the player to move
+string Chess::getAskInput() const 
 {
-	cout << "\033[2J\033[3J\033[H";
-}
-
-void Chess::setFrames()
-{
-	for (size_t row = 0; row < _SIZE; ++row)
-		for (size_t col = 0; col < _SIZE; ++col)
-			m_board[row][col] = ' ';
-
-	m_board[0][0] = '+';
-	m_board[0][20] = '+';
-	m_board[20][0] = '+';
-	m_board[20][20] = '+';
-
-	for (size_t i = 1; i < 20; ++i)
-	{
-		m_board[0][i] = '-';
-		m_board[20][i] = '-';
-		m_board[i][0] = '|';
-		m_board[i][20] = '|';
-	}
-
-	m_board[2][2] = '+';
-	m_board[2][18] = '+';
-	m_board[18][2] = '+';
-	m_board[18][18] = '+';
-
-	for (size_t i = 4; i < 17; i += 2)
-	{
-		m_board[2][i] = '+';
-		m_board[18][i] = '+';
-		m_board[i][2] = '+';
-		m_board[i][18] = '+';
-	}
-
-	for (size_t i = 2; i < 19; i += 2)
-		for (size_t j = 3; j < 19; j += 2)
-			m_board[i][j] = '-';
-
-	for (size_t i = 3; i < 18; i += 2)
-		for (size_t j = 2; j < 19; j += 2)
-			m_board[i][j] = '|';
-
-	for (size_t i = 4; i < 17; i += 2)
-		for (size_t j = 4; j < 17; j += 2)
-			m_board[i][j] = '+';
-
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[2][i] = '+';
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[18][i] = '+';
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[i][2] = '+';
-	for (size_t i = 4; i < 17; i += 2)
-		m_board[i][18] = '+';
-
-	for (size_t i = 3, t = 0; i < 19; i += 2, ++t)
-		m_board[1][i] = m_board[19][i] = ('1' + t);
-
-	for (size_t i = 3, t = 0; i < 19; i += 2, ++t)
-		m_board[i][1] = m_board[i][19] = ('A' + t);
-}
-
-void Chess::setPieces()
-{
-	for (size_t row = 0, t = 0; row < 8; ++row)
-		for (size_t col = 0; col < 8; ++col, ++t)
-			m_board[(3 + (row * 2))][(3 + (col * 2))] = ((m_boardString[t] == '#') ? ' ' : m_boardString[t]);
-}
-
-#endif // WINDOWS
-
-// print the only the board to screen 
-void Chess::show() const 
-{
-	for (size_t row = 0; row < _SIZE; ++row)
-	{
-		for (size_t col = 0; col < _SIZE; ++col)
-			cout << m_board[row][col];
-		cout << endl;
-	}
-}
-// clear screen and print the board and the relevant msg 
-void Chess::displayBoard() const
-{
-	clear();
-	show();
-	cout << m_msg<< m_errorMsg;
-	
-}
-// print the who is turn before getting input 
-void Chess::showAskInput() const 
-{
-	if (m_turn)
-		cout << "Player 1 (White - Capital letters) >> ";
+	if (m_gameBoard.getIsWhiteTurn())
+		return "Player 1 (White - Capital letters) >> ";
 	else
-		cout << "Player 2 (Black - Small letters)   >> ";
+		return "Player 2 (Black - Small letters)   >> ";
 }
 // check if the source and dest are the same 
 bool Chess::isSame() const 
@@ -210,20 +37,6 @@ bool Chess::isExit() const
 {
 	return ((m_input == "exit") || (m_input == "quit") || (m_input == "EXIT") || (m_input == "QUIT"));
 }
-// execute the movement on board 
-void Chess::excute()
-{
-	int row = (m_input[0] - 'a');
-	int col = (m_input[1] - '1');
-	char pieceInSource = m_boardString[(row * 8) + col]; 
-	m_boardString[(row * 8) + col] = '#'; 
-
-	row = (m_input[2] - 'a');
-	col = (m_input[3] - '1');
-	m_boardString[(row * 8) + col] = pieceInSource; 
-
-	setPieces(); 
-}
 // check the response code and switch turn if needed 
 void Chess::doTurn()
 {
@@ -257,15 +70,11 @@ void Chess::doTurn()
 	}
 	case 41:
 	{
-		excute();
-		m_turn = !m_turn;
 		m_msg = "the last movement was legal and cause check \n";
 		break;
 	}
 	case 42:
 	{
-		excute();
-		m_turn = !m_turn;
 		m_msg = "the last movement was legal \n";
 		break;
 	}
@@ -273,30 +82,27 @@ void Chess::doTurn()
 }
 
 // C'tor
-Chess::Chess(const string& start)
-	: m_boardString(start),m_codeResponse(-1)
+Chess::Chess(const Board& gameBoard)
+	: m_gameBoard(gameBoard),m_codeResponse(-1)
 {
-	setFrames();
-	setPieces();
 }
 
 // get the source and destination 
 string Chess::getInput(std::function<void()> printFunc)
 {
 	
-	static bool isFirst = true;
-
-	if (isFirst)
-		isFirst = false;
+	if (m_isFirstInput)
+		m_isFirstInput = false;
 	else
 		doTurn(); 
 
-	displayBoard();
-	
-	cout << "Recommended moves:" << '\n';
-
+	// the recommendations go into the same frame as the board
+	std::ostringstream recommendations;
+	std::streambuf* consoleBuffer = cout.rdbuf(recommendations.rdbuf());
 	printFunc();
-	showAskInput();
+	cout.rdbuf(consoleBuffer);
+
+	displayBoard("Recommended moves:\n" + recommendations.str());
 
 	cin >> m_input;
 	if (isExit())
@@ -307,8 +113,7 @@ string Chess::getInput(std::function<void()> printFunc)
 			m_errorMsg = "Invalid input !! \n";
 		else
 			m_errorMsg = "The source and the destination are the same !! \n";
-		displayBoard();
-		showAskInput();
+		displayBoard("");
 		cin >> m_input;
 		if (isExit())
 			return "exit";
@@ -0,0 +1,132 @@
+#include "Core/ChessCoreApi.h"
+#include "Core/ChessEngine.h"
+#include <cstring>
+#include <exception>
+#include <string>
+
+static_assert(CHESS_MATE_SCORE == ChessEngine::MATE_SCORE, "CHESS_MATE_SCORE must match the search");
+
+struct chess_position {
+    ChessEngine engine;
+
+    chess_position(const std::string& fen, size_t hashMb) : engine(fen, hashMb) {}
+};
+
+namespace {
+    thread_local std::string lastError;
+
+    // Runs body, turning any exception into CHESS_ERROR and the thread's last error
+    template <typename Body>
+    int guard(Body&& body) {
+        try {
+            lastError.clear();
+            return body();
+        }
+        catch (const std::exception& e) {
+            lastError = e.what();
+        }
+        catch (...) {
+            lastError = "Error: unknown failure";
+        }
+        return CHESS_ERROR;
+    }
+
+    bool checkArgument(const void* argument, const char* name) {
+        if (!argument) {
+            lastError = std::string("Error: ") + name + " is NULL";
+            return false;
+        }
+        return true;
+    }
+}
+
+//======================================================================
+chess_position* chess_position_create(const char* fen, size_t hash_mb)
+{
+    chess_position* position = nullptr;
+    guard([&]() {
+        position = new chess_position(fen ? fen : ChessEngine::START_FEN, hash_mb);
+        return CHESS_OK;
+    });
+    return position;
+}
+
+//======================================================================
+void chess_position_free(chess_position* position)
+{
+    delete position;
+}
+
+//======================================================================
+int chess_position_set_fen(chess_position* position, const char* fen)
+{
+    return guard([&]() {
+        if (!checkArgument(position, "position") || !checkArgument(fen, "fen")) {
+            return CHESS_ERROR;
+        }
+        position->engine.setPosition(fen);
+        return CHESS_OK;
+    });
+}
+
+//======================================================================
+int chess_position_apply_move(chess_position* position, const char* move)
+{
+    return guard([&]() {
+        if (!checkArgument(position, "position") || !checkArgument(move, "move")) {
+            return CHESS_ERROR;
+        }
+        if (!position->engine.applyMove(move)) {
+            lastError = std::string("Error: illegal move ") + move;
+            return CHESS_ILLEGAL_MOVE;
+        }
+        return CHESS_OK;
+    });
+}
+
+//======================================================================
+int chess_position_get_fen(const chess_position* position, char* buffer, size_t size)
+{
+    return guard([&]() {
+        if (!checkArgument(position, "position") || !checkArgument(buffer, "buffer")) {
+            return CHESS_ERROR;
+        }
+        std::string fen = position->engine.getFen();
+        if (fen.size() + 1 > size) {
+            lastError = "Error: the FEN needs " + std::to_string(fen.size() + 1) + " bytes";
+            return CHESS_ERROR;
+        }
+        std::memcpy(buffer, fen.c_str(), fen.size() + 1);
+        return CHESS_OK;
+    });
+}
+
+//======================================================================
+int chess_recommend(chess_position* position, const chess_limits* limits, chess_recommendation* recommendation)
+{
+    return guard([&]() {
+        if (!checkArgument(position, "position") || !checkArgument(limits, "limits") ||
+            !checkArgument(recommendation, "recommendation")) {
+            return CHESS_ERROR;
+        }
+        RecommendLimits recommendLimits;
+        recommendLimits.depth = limits->depth;
+        recommendLimits.nodes = limits->nodes;
+        recommendLimits.moveTimeMs = limits->movetime_ms;
+        Recommendation result = position->engine.recommend(recommendLimits);
+
+        *recommendation = chess_recommendation{};
+        std::strncpy(recommendation->best_move, result.bestMove.c_str(), sizeof(recommendation->best_move) - 1);
+        recommendation->score = result.score;
+        recommendation->depth = result.depth;
+        recommendation->nodes = result.nodes;
+        recommendation->elapsed_ms = result.elapsedMs;
+        return CHESS_OK;
+    });
+}
+
+//======================================================================
+const char* chess_last_error(void)
+{
+    return lastError.c_str();
+}
@@ -0,0 +1,97 @@
+#include "Core/ChessEngine.h"
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Board/MoveNotation.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Search/SearchLimits.h"
+#include <algorithm>
+#include <string_view>
+
+static_assert(ChessEngine::MATE_SCORE == ChessUtils::SEARCH_MATE_SCORE, "MATE_SCORE must match the search");
+static_assert(std::string_view(ChessEngine::START_FEN) == ChessUtils::START_FEN, "START_FEN must match ChessUtils");
+
+// The recommender searches whichever board it is given, referenceBoard just satisfies its c-tor
+struct ChessEngine::Impl {
+    Board referenceBoard;
+    MoveRecommender recommender;
+    std::unique_ptr<Board> board;
+
+    Impl() : referenceBoard(ChessUtils::START_BOARD), recommender(referenceBoard, 1) {}
+};
+
+//======================================================================
+// c-tor, a deterministic recommender with its own transposition table
+ChessEngine::ChessEngine(const std::string& fen, size_t hashMb)
+    : m_impl(std::make_unique<Impl>())
+{
+    m_impl->recommender.setRandomnessEnabled(false);
+    m_impl->recommender.resizeTranspositionTable(hashMb > 0 ? hashMb : ChessUtils::TRANSPOSITION_TABLE_SIZE_MB);
+    setPosition(fen);
+}
+
+//======================================================================
+ChessEngine::~ChessEngine() = default;
+ChessEngine::ChessEngine(ChessEngine&&) noexcept = default;
+ChessEngine& ChessEngine::operator=(ChessEngine&&) noexcept = default;
+
+//======================================================================
+void ChessEngine::setPosition(const std::string& fen)
+{
+    m_impl->board = std::make_unique<Board>(Fen::parse(fen));
+}
+
+//======================================================================
+// the move must be one of the legal moves, as the UCI and server commands check it
+bool ChessEngine::applyMove(const std::string& move)
+{
+    BoardMove boardMove;
+    if (!MoveNotation::parse(move, boardMove)) {
+        return false;
+    }
+    std::vector<BoardMove> legalMoves;
+    m_impl->board->generateLegalMoves(legalMoves);
+    if (std::find(legalMoves.begin(), legalMoves.end(), boardMove) == legalMoves.end()) {
+        return false;
+    }
+    m_impl->board->makeMove(boardMove);
+    return true;
+}
+
+//======================================================================
+std::string ChessEngine::getFen() const
+{
+    return m_impl->board->toFen();
+}
+
+//======================================================================
+Recommendation ChessEngine::recommend(const RecommendLimits& limits)
+{
+    SearchLimits searchLimits;
+    searchLimits.depth = limits.depth;
+    searchLimits.nodes = limits.nodes;
+    searchLimits.moveTimeMs = limits.moveTimeMs;
+    // A search nothing would stop is cut to depth 1
+    if (searchLimits.depth <= 0 && searchLimits.nodes == 0 && searchLimits.moveTimeMs <= 0) {
+        searchLimits.depth = 1;
+    }
+    SearchInfo info = m_impl->recommender.search(*m_impl->board, searchLimits);
+
+    Recommendation recommendation;
+    recommendation.score = info.score;
+    recommendation.depth = info.depth;
+    recommendation.nodes = info.nodes;
+    recommendation.elapsedMs = info.elapsedMs;
+    for (const BoardMove& move : info.principalVariation) {
+        recommendation.principalVariation.push_back(MoveNotation::format(move));
+    }
+    if (!recommendation.principalVariation.empty()) {
+        recommendation.bestMove = recommendation.principalVariation.front();
+    }
+    return recommendation;
+}
+
+//======================================================================
+void ChessEngine::setThreadCount(size_t threadCount)
+{
+    m_impl->recommender.setThreadCount(threadCount);
+}
@@ -0,0 +1,230 @@
+#include "Epd/EpdRunner.h"
+#include "Board/MoveNotation.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    bool isNumber(const std::string& text) {
+        return !text.empty() &&
+            std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    }
+
+    std::string trim(const std::string& text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return "";
+        }
+        return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    }
+}
+
+//======================================================================
+std::string EpdPosition::getOperation(const std::string& opcode) const
+{
+    for (const auto& operation : operations) {
+        if (operation.first == opcode) {
+            return operation.second;
+        }
+    }
+    return "";
+}
+
+//======================================================================
+EpdRunner::EpdRunner(std::ostream& output, size_t threadCount)
+    : m_output(output), m_pool(threadCount), m_positionCount(0), m_failureCount(0), m_nodeCount(0),
+    m_elapsedSeconds(0)
+{
+}
+
+//======================================================================
+// four FEN fields, the move counters if present, then "opcode operand;" operations
+EpdPosition EpdRunner::parseLine(const std::string& line)
+{
+    std::istringstream stream(line);
+    EpdPosition position;
+    std::string field;
+    for (int i = 0; i < 4; i++) {
+        if (!(stream >> field)) {
+            throw std::runtime_error("Error: EPD line " + line + " needs four FEN fields");
+        }
+        position.fen += (i > 0 ? " " : "") + field;
+    }
+
+    std::string rest;
+    std::getline(stream, rest);
+    bool isFirst = true;
+    std::istringstream operations(rest);
+    std::string operation;
+    while (std::getline(operations, operation, ';')) {
+        std::istringstream words(operation);
+        std::string opcode;
+        words >> opcode;
+
+        // Up to two numbers before the first opcode are the FEN move counters
+        for (int counters = 0; isFirst && counters < 2 && isNumber(opcode); counters++) {
+            position.fen += " " + opcode;
+            opcode.clear();
+            words >> opcode;
+        }
+        isFirst = false;
+        if (opcode.empty()) {
+            continue;
+        }
+
+        std::string operand;
+        std::getline(words, operand);
+        operand = trim(operand);
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            operand = operand.substr(1, operand.size() - 2);
+        }
+        position.operations.emplace_back(opcode, operand);
+    }
+
+    // Checked here so a bad suite fails before any work starts
+    Fen::parse(position.fen);
+    return position;
+}
+
+//======================================================================
+// parses the whole suite, runs it on the pool and writes the results in suite order
+void EpdRunner::run(std::istream& input, EpdMode mode, int depth)
+{
+    std::vector<EpdPosition> positions;
+    std::vector<size_t> lineNumbers;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(input, line); lineNumber++) {
+        if (trim(line).empty()) {
+            continue;
+        }
+        try {
+            positions.push_back(parseLine(line));
+        }
+        catch (const std::runtime_error& e) {
+            throw std::runtime_error(std::string(e.what()) + " (line " + std::to_string(lineNumber) + ")");
+        }
+        lineNumbers.push_back(lineNumber);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PositionResult> results(positions.size());
+    std::atomic<size_t> nextPosition(0);
+    for (size_t worker = 0; worker < m_pool.getThreadCount(); worker++) {
+        m_pool.submit([&]() {
+            // The recommender searches whichever board it is given, this one just satisfies the c-tor
+            Board referenceBoard(ChessUtils::START_BOARD);
+            std::unique_ptr<MoveRecommender> recommender;
+            if (mode == EpdMode::SEARCH) {
+                recommender = std::make_unique<MoveRecommender>(referenceBoard, depth);
+                recommender->setRandomnessEnabled(false);
+            }
+
+            for (size_t i = nextPosition++; i < positions.size(); i = nextPosition++) {
+                auto positionStart = std::chrono::steady_clock::now();
+                if (mode == EpdMode::PERFT) {
+                    runPerft(positions[i], depth, results[i]);
+                }
+                else {
+                    // A fresh table per position, so results don't depend on the order
+                    recommender->clearTranspositionTable();
+                    runSearch(*recommender, positions[i], depth, results[i]);
+                }
+                results[i].elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - positionStart).count();
+            }
+        });
+    }
+    m_pool.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    m_positionCount = positions.size();
+    m_failureCount = 0;
+    m_nodeCount = 0;
+    m_elapsedSeconds = elapsed.count();
+    for (size_t i = 0; i < positions.size(); i++) {
+        const PositionResult& result = results[i];
+        std::string id = positions[i].getOperation("id");
+        uint64_t nodesPerSecond = result.elapsedUs > 0 ? result.nodes * 1000000 / result.elapsedUs : 0;
+        m_output << (id.empty() ? "line " + std::to_string(lineNumbers[i]) : id) << ": " << result.text
+            << " nodes " << result.nodes << " time " << result.elapsedUs / 1000 << "ms nps " << nodesPerSecond << '\n';
+
+        m_nodeCount += result.nodes;
+        if (result.isFailed) {
+            m_failureCount++;
+        }
+    }
+}
+
+//======================================================================
+// leaf count, compared with the suite's "D<depth>" operation when there is one
+void EpdRunner::runPerft(const EpdPosition& position, int depth, PositionResult& result)
+{
+    Board board(Fen::parse(position.fen));
+    result.nodes = board.perft(depth);
+    result.text = "perft " + std::to_string(depth) + " " + std::to_string(result.nodes);
+
+    std::string expected = position.getOperation("D" + std::to_string(depth));
+    if (!expected.empty()) {
+        result.isFailed = expected != std::to_string(result.nodes);
+        result.text += result.isFailed ? " expected " + expected : " ok";
+    }
+}
+
+//======================================================================
+// best move of a depth limited search, the suite's "bm" (SAN) is shown next to it
+void EpdRunner::runSearch(MoveRecommender& recommender, const EpdPosition& position, int depth,
+    PositionResult& result)
+{
+    Board board(Fen::parse(position.fen));
+    SearchLimits limits;
+    limits.depth = depth;
+    SearchInfo info = recommender.search(board, limits);
+
+    result.nodes = info.nodes;
+    result.text = "bestmove " + (info.principalVariation.empty() ? std::string("0000") :
+        MoveNotation::format(info.principalVariation.front())) + " score " + std::to_string(info.score);
+    std::string bestMoves = position.getOperation("bm");
+    if (!bestMoves.empty()) {
+        result.text += " (bm " + bestMoves + ")";
+    }
+}
+
+//======================================================================
+size_t EpdRunner::getPositionCount() const
+{
+    return m_positionCount;
+}
+
+//======================================================================
+size_t EpdRunner::getFailureCount() const
+{
+    return m_failureCount;
+}
+
+//======================================================================
+uint64_t EpdRunner::getNodeCount() const
+{
+    return m_nodeCount;
+}
+
+//======================================================================
+double EpdRunner::getElapsedSeconds() const
+{
+    return m_elapsedSeconds;
+}
+
+//======================================================================
+double EpdRunner::getNodesPerSecond() const
+{
+    return m_elapsedSeconds > 0 ? m_nodeCount / m_elapsedSeconds : 0;
+}
+
+//======================================================================
+size_t EpdRunner::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
@@ -0,0 +1,82 @@
+#include "Evaluation/ScoreCache.h"
+
+//======================================================================
+// c-tor, allocates the table
+ScoreCache::ScoreCache(size_t sizeMb)
+    : m_mask(0), m_hits(0), m_misses(0)
+{
+    resize(sizeMb);
+}
+
+//======================================================================
+// looks up the key, a slot only matches if key and score were written together
+bool ScoreCache::probe(uint64_t key, int& score)
+{
+    Entry& entry = m_entries[key & m_mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t checkedKey = entry.checkedKey.load(std::memory_order_relaxed);
+
+    if ((checkedKey ^ data) != key) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    return true;
+}
+
+//======================================================================
+// always replaces the slot, the newest position is the most likely to come back
+void ScoreCache::store(uint64_t key, int score)
+{
+    Entry& entry = m_entries[key & m_mask];
+    uint64_t data = static_cast<uint32_t>(score);
+    entry.data.store(data, std::memory_order_relaxed);
+    entry.checkedKey.store(key ^ data, std::memory_order_relaxed);
+}
+
+//======================================================================
+// the entry count is the largest power of two that fits in the given size
+void ScoreCache::resize(size_t sizeMb)
+{
+    size_t bytes = sizeMb * 1024 * 1024;
+    size_t entryCount = 1;
+    while (entryCount * 2 * sizeof(Entry) <= bytes) {
+        entryCount *= 2;
+    }
+
+    m_entries = std::make_unique<Entry[]>(entryCount);
+    m_mask = entryCount - 1;
+    clear();
+}
+
+//======================================================================
+// empties every slot, not safe while other threads use the table
+void ScoreCache::clear()
+{
+    for (size_t i = 0; i <= m_mask; i++) {
+        m_entries[i].checkedKey.store(1, std::memory_order_relaxed);
+        m_entries[i].data.store(0, std::memory_order_relaxed);
+    }
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+}
+
+//======================================================================
+size_t ScoreCache::getEntryCount() const
+{
+    return m_mask + 1;
+}
+
+//======================================================================
+uint64_t ScoreCache::getHits() const
+{
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+//======================================================================
+uint64_t ScoreCache::getMisses() const
+{
+    return m_misses.load(std::memory_order_relaxed);
+}
@@ -1,6 +0,0 @@
-#include "Exceptions/MoveScoreDontFit.h"
-
-const char* MoveScoreDontFit::what() const noexcept
-{
-	return "Move has  a lower score then all the moves in the queue.";
-}
\ No newline at end of file
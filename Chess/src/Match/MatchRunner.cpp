@@ -0,0 +1,376 @@
+#include "Match/MatchRunner.h"
+#include "MoveRecommender/FastRandom.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // Per move limit of an engine whose spec gives none
+    const uint64_t DEFAULT_NODES = 20000;
+    const int FIFTY_MOVE_PLIES = 100;
+    const int REPETITION_COUNT = 3;
+    // Two-sided 95% quantile of the normal distribution
+    const double CONFIDENCE_QUANTILE = 1.959964;
+
+    // Mean and per game variance of the score
+    void getScoreStatistics(size_t wins, size_t draws, size_t losses, double& mean, double& variance) {
+        double games = static_cast<double>(wins + draws + losses);
+        mean = (wins + draws * 0.5) / games;
+        variance = (wins * (1 - mean) * (1 - mean) + draws * (0.5 - mean) * (0.5 - mean) +
+            losses * mean * mean) / games;
+    }
+
+    int64_t parseNumber(const std::string& key, const std::string& value) {
+        try {
+            size_t length = 0;
+            int64_t number = std::stoll(value, &length);
+            if (length == value.size() && number >= 0) {
+                return number;
+            }
+        }
+        catch (const std::logic_error&) {
+        }
+        throw std::runtime_error("Error: engine option " + key + "=" + value + " needs a non-negative number");
+    }
+}
+
+//======================================================================
+// "key=value" pairs separated by commas, a node limit when no limit is given
+MatchEngine MatchEngine::parse(const std::string& spec, const std::string& defaultName)
+{
+    MatchEngine engine;
+    engine.name = defaultName;
+    std::istringstream stream(spec);
+    std::string option;
+    while (std::getline(stream, option, ',')) {
+        if (option.empty()) {
+            continue;
+        }
+        size_t separator = option.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Error: engine option " + option + " needs a value (key=value)");
+        }
+        std::string key = option.substr(0, separator);
+        std::string value = option.substr(separator + 1);
+        if (key == "name") {
+            engine.name = value;
+        }
+        else if (key == "depth") {
+            engine.limits.depth = static_cast<int>(parseNumber(key, value));
+        }
+        else if (key == "nodes") {
+            engine.limits.nodes = static_cast<uint64_t>(parseNumber(key, value));
+        }
+        else if (key == "movetime") {
+            engine.limits.moveTimeMs = parseNumber(key, value);
+        }
+        else if (key == "hash") {
+            engine.hashMb = static_cast<size_t>(parseNumber(key, value));
+        }
+        else if (key == "nnue") {
+            engine.network = std::make_shared<const NnueNetwork>(value);
+        }
+        else if (key == "tablebases") {
+            engine.tablebases = std::make_shared<const Tablebases>(value);
+        }
+        else {
+            throw std::runtime_error("Error: unknown engine option " + key);
+        }
+    }
+
+    if (engine.limits.depth == 0 && engine.limits.nodes == 0 && engine.limits.moveTimeMs == 0) {
+        engine.limits.nodes = DEFAULT_NODES;
+    }
+    return engine;
+}
+
+//======================================================================
+MatchRunner::MatchRunner(std::ostream& output, size_t threadCount)
+    : m_output(output), m_pool(threadCount), m_winCount(0), m_lossCount(0), m_drawCount(0), m_elapsedSeconds(0)
+{
+}
+
+//======================================================================
+// each worker keeps one recommender per engine and pulls games until the match or the SPRT is done
+void MatchRunner::run(const MatchEngine& first, const MatchEngine& second, const MatchSettings& settings)
+{
+    m_winCount = 0;
+    m_lossCount = 0;
+    m_drawCount = 0;
+    m_sprt = settings.sprt;
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextGame(0);
+    std::atomic<bool> isDecided(false);
+    for (size_t worker = 0; worker < m_pool.getThreadCount(); worker++) {
+        m_pool.submit([&]() {
+            // The recommenders search whichever board they are given, this one just satisfies the c-tor
+            Board referenceBoard(ChessUtils::START_BOARD);
+            MoveRecommender firstRecommender(referenceBoard, 1);
+            MoveRecommender secondRecommender(referenceBoard, 1);
+            for (auto [engine, recommender] : { std::pair(&first, &firstRecommender),
+                std::pair(&second, &secondRecommender) }) {
+                recommender->setRandomnessEnabled(false);
+                recommender->resizeTranspositionTable(engine->hashMb);
+                recommender->setTablebases(engine->tablebases);
+            }
+            Player firstPlayer{ first, firstRecommender };
+            Player secondPlayer{ second, secondRecommender };
+
+            for (size_t game = nextGame++; game < settings.gameCount && !isDecided; game = nextGame++) {
+                // Both games of a pair start from the same opening, with the colors swapped
+                std::string opening = makeOpening(settings.seed + game / 2, settings.openingPlies);
+                bool isFirstWhite = game % 2 == 0;
+                firstRecommender.clearTranspositionTable();
+                secondRecommender.clearTranspositionTable();
+
+                std::string reason;
+                int plies = 0;
+                GameResult result = playGame(isFirstWhite ? firstPlayer : secondPlayer,
+                    isFirstWhite ? secondPlayer : firstPlayer, opening, settings.maxPlies, reason, plies);
+                SprtStatus status = recordResult(game + 1, first, second, isFirstWhite, result, reason, plies);
+                if (settings.isStoppedBySprt && status != SprtStatus::CONTINUE) {
+                    isDecided = true;
+                }
+            }
+        });
+    }
+    m_pool.wait();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_elapsedSeconds = elapsed.count();
+}
+
+//======================================================================
+// random legal plies from the start position, retried until the side to move has a move
+std::string MatchRunner::makeOpening(uint64_t seed, int plies)
+{
+    FastRandom random(seed);
+    std::vector<BoardMove> moves;
+    for (;;) {
+        Board board(ChessUtils::START_BOARD);
+        for (int ply = 0; ply < plies; ply++) {
+            moves.clear();
+            board.generateLegalMoves(moves);
+            if (moves.empty()) {
+                break;
+            }
+            board.makeMove(moves[random.nextInt(static_cast<int>(moves.size()))]);
+        }
+
+        moves.clear();
+        board.generateLegalMoves(moves);
+        if (!moves.empty()) {
+            return board.toFen();
+        }
+    }
+}
+
+//======================================================================
+// each engine searches its own board, which carries its network; both boards get every move
+MatchRunner::GameResult MatchRunner::playGame(const Player& white, const Player& black,
+    const std::string& openingFen, int maxPlies, std::string& reason, int& plies)
+{
+    FenPosition opening = Fen::parse(openingFen);
+    Board whiteBoard(opening);
+    Board blackBoard(opening);
+    whiteBoard.setNetwork(white.engine.network);
+    blackBoard.setNetwork(black.engine.network);
+
+    std::vector<uint64_t> hashes{ whiteBoard.getHash() };
+    std::vector<BoardMove> moves;
+    for (plies = 0;; plies++) {
+        bool isWhiteTurn = whiteBoard.getIsWhiteTurn();
+        moves.clear();
+        whiteBoard.generateLegalMoves(moves);
+        if (moves.empty()) {
+            bool isMate = whiteBoard.isKingInCheck(isWhiteTurn);
+            reason = isMate ? "checkmate" : "stalemate";
+            return !isMate ? GameResult::DRAW : isWhiteTurn ? GameResult::BLACK_WINS : GameResult::WHITE_WINS;
+        }
+        if (whiteBoard.getHalfmoveClock() >= FIFTY_MOVE_PLIES) {
+            reason = "fifty move rule";
+            return GameResult::DRAW;
+        }
+        if (std::count(hashes.begin(), hashes.end(), hashes.back()) >= REPETITION_COUNT) {
+            reason = "threefold repetition";
+            return GameResult::DRAW;
+        }
+        if (isInsufficientMaterial(whiteBoard)) {
+            reason = "insufficient material";
+            return GameResult::DRAW;
+        }
+        if (plies >= maxPlies) {
+            reason = "move limit";
+            return GameResult::DRAW;
+        }
+
+        const Player& mover = isWhiteTurn ? white : black;
+        SearchInfo info = mover.recommender.search(isWhiteTurn ? whiteBoard : blackBoard, mover.engine.limits);
+        // A search stopped before its first iteration has no move yet
+        BoardMove move = info.principalVariation.empty() ? moves.front() : info.principalVariation.front();
+        whiteBoard.makeMove(move);
+        blackBoard.makeMove(move);
+        hashes.push_back(whiteBoard.getHash());
+    }
+}
+
+//======================================================================
+// bare kings, or a single knight or bishop
+bool MatchRunner::isInsufficientMaterial(const Board& board)
+{
+    int menCount = Bitboards::countSquares(board.getOccupancy());
+    Bitboard minorPieces = 0;
+    for (bool isWhite : { true, false }) {
+        minorPieces |= board.getPieces(isWhite, ChessUtils::KNIGHT_INDEX) |
+            board.getPieces(isWhite, ChessUtils::BISHOP_INDEX);
+    }
+    return menCount == 2 || (menCount == 3 && minorPieces != 0);
+}
+
+//======================================================================
+// totals from the first engine's point of view, the line gives the result as white-black
+SprtStatus MatchRunner::recordResult(size_t gameNumber, const MatchEngine& first, const MatchEngine& second,
+    bool isFirstWhite, GameResult result, const std::string& reason, int plies)
+{
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    if (result == GameResult::DRAW) {
+        m_drawCount++;
+    }
+    else if ((result == GameResult::WHITE_WINS) == isFirstWhite) {
+        m_winCount++;
+    }
+    else {
+        m_lossCount++;
+    }
+
+    const char* score = result == GameResult::WHITE_WINS ? "1-0" : result == GameResult::BLACK_WINS ? "0-1" : "1/2-1/2";
+    m_output << "game " << gameNumber << ": " << (isFirstWhite ? first.name : second.name) << " - "
+        << (isFirstWhite ? second.name : first.name) << " " << score << " (" << reason << ", " << plies
+        << " plies)\n";
+    m_output.flush();
+    return getSprtStatus();
+}
+
+//======================================================================
+size_t MatchRunner::getWinCount() const
+{
+    return m_winCount;
+}
+
+//======================================================================
+size_t MatchRunner::getLossCount() const
+{
+    return m_lossCount;
+}
+
+//======================================================================
+size_t MatchRunner::getDrawCount() const
+{
+    return m_drawCount;
+}
+
+//======================================================================
+size_t MatchRunner::getGameCount() const
+{
+    return m_winCount + m_lossCount + m_drawCount;
+}
+
+//======================================================================
+double MatchRunner::getElo() const
+{
+    if (getGameCount() == 0) {
+        return 0;
+    }
+    double mean = 0;
+    double variance = 0;
+    getScoreStatistics(m_winCount, m_drawCount, m_lossCount, mean, variance);
+    return scoreToElo(mean);
+}
+
+//======================================================================
+// normal approximation of the mean score, mapped to Elo
+double MatchRunner::getEloMargin() const
+{
+    if (getGameCount() == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double mean = 0;
+    double variance = 0;
+    getScoreStatistics(m_winCount, m_drawCount, m_lossCount, mean, variance);
+    double margin = CONFIDENCE_QUANTILE * std::sqrt(variance / getGameCount());
+    if (mean - margin <= 0 || mean + margin >= 1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return (scoreToElo(mean + margin) - scoreToElo(mean - margin)) / 2;
+}
+
+//======================================================================
+double MatchRunner::getLogLikelihoodRatio() const
+{
+    return computeLogLikelihoodRatio(m_winCount, m_drawCount, m_lossCount, m_sprt);
+}
+
+//======================================================================
+// Wald's bounds for the error rates
+SprtStatus MatchRunner::getSprtStatus() const
+{
+    double ratio = getLogLikelihoodRatio();
+    if (ratio >= std::log((1 - m_sprt.beta) / m_sprt.alpha)) {
+        return SprtStatus::ACCEPT_H1;
+    }
+    if (ratio <= std::log(m_sprt.beta / (1 - m_sprt.alpha))) {
+        return SprtStatus::ACCEPT_H0;
+    }
+    return SprtStatus::CONTINUE;
+}
+
+//======================================================================
+double MatchRunner::getGamesPerHour() const
+{
+    return m_elapsedSeconds > 0 ? getGameCount() * 3600 / m_elapsedSeconds : 0;
+}
+
+//======================================================================
+size_t MatchRunner::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
+
+//======================================================================
+// logistic model, infinite for a score of 0 or 1
+double MatchRunner::scoreToElo(double score)
+{
+    if (score <= 0 || score >= 1) {
+        return score <= 0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    }
+    return 400 * std::log10(score / (1 - score));
+}
+
+//======================================================================
+double MatchRunner::eloToScore(double elo)
+{
+    return 1 / (1 + std::pow(10, -elo / 400));
+}
+
+//======================================================================
+// normal approximation of the generalized SPRT: with the score's mean s and
+// per game variance v, LLR = n (s1 - s0) (2s - s0 - s1) / (2v)
+double MatchRunner::computeLogLikelihoodRatio(size_t wins, size_t draws, size_t losses, const SprtSettings& sprt)
+{
+    if (wins + draws + losses == 0) {
+        return 0;
+    }
+    double mean = 0;
+    double variance = 0;
+    getScoreStatistics(wins, draws, losses, mean, variance);
+    if (variance <= 0) {
+        return 0;
+    }
+    double score0 = eloToScore(sprt.elo0);
+    double score1 = eloToScore(sprt.elo1);
+    return (wins + draws + losses) * (score1 - score0) * (2 * mean - score0 - score1) / (2 * variance);
+}
@@ -1,15 +1,39 @@
 #include "MoveRecommender/MoveRecommender.h"
+#include "Utils/AllocationTracker.h"
+#include "Utils/Trace.h"
 #include <algorithm>
 #include <climits>
 #include <cstdlib>
 #include <list>
+#include <random>
+
+namespace {
+    // Mate scores are stored relative to the position, not to the root
+    int toTableScore(int score, int ply) {
+        if (score >= ChessUtils::MATE_THRESHOLD) return score + ply;
+        if (score <= -ChessUtils::MATE_THRESHOLD) return score - ply;
+        return score;
+    }
+
+    int fromTableScore(int score, int ply) {
+        if (score >= ChessUtils::MATE_THRESHOLD) return score - ply;
+        if (score <= -ChessUtils::MATE_THRESHOLD) return score + ply;
+        return score;
+    }
+}
 
 /**
  * @brief Constructor for the MoveRecommender class.
  */
 MoveRecommender::MoveRecommender(Board& board, int maxDepth)
     : m_board(board), m_maxDepth(maxDepth), m_isWhiteTurn(true),
-    m_moveQueue(ChessUtils::MAX_QUEUE_SIZE) {
+    m_moveQueue(ChessUtils::MAX_QUEUE_SIZE),
+    m_pawnTable(ChessUtils::PAWN_HASH_SIZE_MB),
+    m_evaluationCache(ChessUtils::EVALUATION_CACHE_SIZE_MB),
+    m_seedGenerator(std::random_device{}()), m_isRandomnessEnabled(true),
+    m_bookSelection(BookSelection::WEIGHTED),
+    m_transpositionTable(std::make_shared<TranspositionTable>(ChessUtils::TRANSPOSITION_TABLE_SIZE_MB)), m_searchLimits(nullptr),
+    m_isSearchStopped(false), m_searchNodes(0), m_timeBudgetMs(0), m_isStatsPrinted(false) {
 }
 
 /**
@@ -30,69 +54,141 @@ bool MoveRecommender::isMoveStillValid(const ChessMove& move) const {
 }
 
 /**
- * @brief Gets the numerical value of a chess piece.
+ * @brief Queues the book move of the position, false when out of book.
+ *
+ * The queue keeps two squares per move, so an underpromotion from the book
+ * falls back to the search.
  */
-int MoveRecommender::getPieceValue(char pieceSymbol) const {
-    switch (tolower(pieceSymbol)) {
-    case static_cast<char>(ChessUtils::PieceType::PAWN):   return ChessUtils::PAWN_VALUE;
-    case static_cast<char>(ChessUtils::PieceType::KNIGHT): return ChessUtils::KNIGHT_VALUE;
-    case static_cast<char>(ChessUtils::PieceType::BISHOP): return ChessUtils::BISHOP_VALUE;
-    case static_cast<char>(ChessUtils::PieceType::ROOK):   return ChessUtils::ROOK_VALUE;
-    case static_cast<char>(ChessUtils::PieceType::QUEEN):  return ChessUtils::QUEEN_VALUE;
-    case static_cast<char>(ChessUtils::PieceType::KING):   return ChessUtils::KING_VALUE;
-    default: return 0;
+bool MoveRecommender::probeBook() {
+    BoardMove bookMove;
+    if (!m_book || !m_book->probe(m_board, m_bookSelection, m_seedGenerator.next(), bookMove) ||
+        bookMove.isUnderpromotion()) {
+        return false;
+    }
+
+    m_searchStats.validateMoveCalls++;
+    int moveCode = m_board.validateMove(bookMove.srcRow, bookMove.srcCol, bookMove.destRow, bookMove.destCol);
+    if (moveCode != ChessUtils::VALID_MOVE && moveCode != ChessUtils::VALID_MOVE_CHECK) {
+        return false;
     }
+
+    m_moveQueue.clear();
+    m_moveQueue.emplace(coordinatesToNotation(bookMove.srcRow, bookMove.srcCol),
+        coordinatesToNotation(bookMove.destRow, bookMove.destCol), m_isWhiteTurn, ChessUtils::BOOK_MOVE_SCORE);
+    return true;
 }
 
 /**
  * @brief Evaluates all possible moves and fills the priority queue.
+ *
+ * With a thread pool, each thread takes every n-th root move on its own copy
+ * of the board and keeps its own top moves and counters, the lists and the
+ * counters are merged at the end.
  */
 void MoveRecommender::refreshMoveQueue() {
-    m_moveQueue = PriorityQueue<ChessMove, ChessMoveComparator>(ChessUtils::MAX_QUEUE_SIZE);
+    CHESS_TRACE_SCOPE("MoveRecommender::refreshMoveQueue");
+    CHESS_ALLOCATION_PHASE(ROOT_SETUP);
+    m_moveQueue.clear();
+
+    std::vector<BoardMove> moves;
+    m_board.generateLegalMoves(moves);
+    // Moves are kept as two squares here, a promotion is always to a queen
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [](const BoardMove& move) {
+        return move.isUnderpromotion();
+    }), moves.end());
+
+    // Each root move gets its own stream, so results don't depend on evaluation order
+    uint64_t searchSeed = m_seedGenerator.next();
+
+    size_t threadCount = m_pool ? std::max<size_t>(1, std::min(moves.size(), m_pool->getThreadCount())) : 1;
+    ConcurrentTopK<ChessMove, ChessMoveComparator> collector(ChessUtils::MAX_QUEUE_SIZE, threadCount);
+    std::vector<SearchStats> threadStats(threadCount);
+
+    if (threadCount == 1) {
+        scoreRootMoves(m_board, moves, 0, 1, searchSeed, collector, threadStats[0]);
+    }
+    else {
+        for (size_t first = 0; first < threadCount; first++) {
+            m_pool->submit([this, &moves, &collector, &threadStats, first, threadCount, searchSeed]() {
+                CHESS_ALLOCATION_PHASE(ROOT_SETUP);
+                Board board(m_board);
+                scoreRootMoves(board, moves, first, threadCount, searchSeed, collector, threadStats[first]);
+            });
+        }
+        m_pool->wait();
+    }
 
-    // Iterate through all board positions
-    for (int row = 0; row < ChessUtils::BOARD_SIZE; row++) {
-        for (int col = 0; col < ChessUtils::BOARD_SIZE; col++) {
-            std::shared_ptr<Piece> piece = m_board.getPieceAt(row, col);
+    {
+        CHESS_ALLOCATION_PHASE(RESULT_QUEUE);
+        collector.mergeInto(m_moveQueue);
+    }
+    for (const SearchStats& stats : threadStats) {
+        m_searchStats.merge(stats);
+    }
+}
 
-            // Skip if no piece or wrong color
-            if (!piece || piece->getIsWhite() != m_isWhiteTurn) {
-                continue;
+/**
+ * @brief Scores moves first, first + stride, ... and keeps the best in the collector.
+ *
+ * The collector slot is the first move index, one per thread, and stats
+ * belongs to the thread too.
+ */
+void MoveRecommender::scoreRootMoves(Board& board, const std::vector<BoardMove>& moves, size_t first, size_t stride,
+    uint64_t searchSeed, ConcurrentTopK<ChessMove, ChessMoveComparator>& collector, SearchStats& stats) {
+    CHESS_ALLOCATION_PHASE(TREE_SEARCH);
+    for (size_t i = first; i < moves.size(); i += stride) {
+        const BoardMove& boardMove = moves[i];
+        std::string source = coordinatesToNotation(boardMove.srcRow, boardMove.srcCol);
+        std::string dest = coordinatesToNotation(boardMove.destRow, boardMove.destCol);
+        SearchContext context{ board, FastRandom(searchSeed + i) };
+
+        try {
+            ChessMove move(source, dest, m_isWhiteTurn);
+            int score = 0;
+            {
+                CHESS_TRACE_SCOPE("MoveRecommender::minimax (root move)");
+                score = minimax(context, move, m_maxDepth, true);
             }
+            move.setScore(score);
 
-            // Check all possible destinations for this piece
-            evaluateMovesForPiece(row, col);
+            if (score != 0) {
+                CHESS_ALLOCATION_PHASE(RESULT_QUEUE);
+                collector.push(first, std::move(move));
+            }
         }
+        catch (const std::exception& e) {
+            std::cerr << "Error evaluating move " << source << dest
+                << ": " << e.what() << std::endl;
+        }
+        stats.merge(context.stats);
     }
 }
 
 /**
- * @brief Evaluates all possible moves for a piece at given position.
+ * @brief Sorts moves so that captures winning the most material come first.
+ *
+ * Captures are ranked by static exchange evaluation, quiet moves keep their
+ * generation order and losing captures go last.
  */
-void MoveRecommender::evaluateMovesForPiece(int srcRow, int srcCol) {
-    std::string source = coordinatesToNotation(srcRow, srcCol);
-
-    for (int destRow = 0; destRow < ChessUtils::BOARD_SIZE; destRow++) {
-        for (int destCol = 0; destCol < ChessUtils::BOARD_SIZE; destCol++) {
-            std::string dest = coordinatesToNotation(destRow, destCol);
+void MoveRecommender::orderMoves(const Board& board, std::vector<BoardMove>& moves) const {
+    CHESS_ALLOCATION_PHASE(MOVE_ORDERING);
+    std::vector<std::pair<int, BoardMove>> keyedMoves;
+    keyedMoves.reserve(moves.size());
+
+    for (const BoardMove& move : moves) {
+        int key = 0;
+        if (board.getPieceAt(move.destRow, move.destCol)) {
+            // Shift captures so that even exchanges still go before quiet moves
+            key = board.staticExchangeEvaluation(move) * 2 + 1;
+        }
+        keyedMoves.push_back({ key, move });
+    }
 
-            int moveCode = m_board.validateMove(source, dest);
-            if (moveCode == ChessUtils::VALID_MOVE || moveCode == ChessUtils::VALID_MOVE_CHECK) {
-                try {
-                    ChessMove move(source, dest, m_isWhiteTurn);
-                    int score = minimax(move, m_maxDepth, true);
-                    move.setScore(score);
+    std::stable_sort(keyedMoves.begin(), keyedMoves.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
 
-                    if (score != 0) {
-                        m_moveQueue.push(move);
-                    }
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Error evaluating move " << source << dest
-                        << ": " << e.what() << std::endl;
-                }
-            }
-        }
+    for (size_t i = 0; i < moves.size(); i++) {
+        moves[i] = keyedMoves[i].second;
     }
 }
 
@@ -104,9 +200,11 @@ void MoveRecommender::evaluateMovesForPiece(int srcRow, int srcCol) {
  * 2. If we haven't reached max depth, looks ahead at opponent responses
  * 3. Returns the best score assuming both players play optimally
  */
-int MoveRecommender::minimax(const ChessMove& move, int depth, bool isMaximizing) {
+int MoveRecommender::minimax(SearchContext& context, const ChessMove& move, int depth, bool isMaximizing) {
+    context.stats.nodes++;
+
     // Step 1: Get the immediate score for this move
-    int currentScore = evaluatePosition(move);
+    int currentScore = evaluatePosition(context, move);
 
     // Step 2: If we've reached the bottom or this is a leaf, return the score
     if (depth == 0) {
@@ -114,56 +212,56 @@ int MoveRecommender::minimax(const ChessMove& move, int depth, bool isMaximizing
     }
 
     // Step 3: Look ahead - make the move temporarily and see what opponent can do
-    return makeTemporaryMoveAndEvaluate(move, [&]() {
-        int bestScore = isMaximizing ? INT_MIN : INT_MAX;
-        bool foundMove = false;
-
-        // Check all possible opponent responses
-        for (int row = 0; row < ChessUtils::BOARD_SIZE; row++) {
-            for (int col = 0; col < ChessUtils::BOARD_SIZE; col++) {
-                std::shared_ptr<Piece> piece = m_board.getPieceAt(row, col);
-
-                // Skip if not opponent's piece
-                if (!piece || piece->getIsWhite() == move.getIsWhite()) {
-                    continue;
-                }
-
-                // Try all destinations for this opponent piece
-                for (int destRow = 0; destRow < ChessUtils::BOARD_SIZE; destRow++) {
-                    for (int destCol = 0; destCol < ChessUtils::BOARD_SIZE; destCol++) {
-                        std::string source = coordinatesToNotation(row, col);
-                        std::string dest = coordinatesToNotation(destRow, destCol);
-
-                        int moveCode = m_board.validateMove(source, dest);
-                        if (moveCode == ChessUtils::VALID_MOVE || moveCode == ChessUtils::VALID_MOVE_CHECK) {
-                            foundMove = true;
-                            ChessMove opponentMove(source, dest, !move.getIsWhite());
-                            int opponentScore = minimax(opponentMove, depth - 1, !isMaximizing);
-
-                            // Update best score based on who's playing
-                            if (isMaximizing) {
-                                bestScore = std::max(bestScore, opponentScore);
-                            }
-                            else {
-                                bestScore = std::min(bestScore, opponentScore);
-                            }
-
-                            // Early exit if we found a really good/bad move
-                            if ((isMaximizing && bestScore > ChessUtils::ALPHA_BETA_CUTOFF) ||
-                                (!isMaximizing && bestScore < -ChessUtils::ALPHA_BETA_CUTOFF)) {
-                                return currentScore + bestScore / depth;
-                            }
-                        }
-                    }
-                }
+    return makeTemporaryMoveAndEvaluate(context.board, move, [&]() {
+        // A tablebase position needs no look ahead: a known mate scores like checkmate
+        TablebaseResult tablebaseResult;
+        if (m_tablebases && m_tablebases->probe(context.board, tablebaseResult)) {
+            if (tablebaseResult.outcome == Tablebase::WDL_DRAW) {
+                return currentScore;
             }
+            int mateScore = ChessUtils::CHECKMATE_SCORE - tablebaseResult.distance;
+            return (tablebaseResult.outcome == Tablebase::WDL_LOSS) == isMaximizing ? mateScore : -mateScore;
         }
 
+        std::vector<BoardMove> responses;
+        context.board.generateLegalMoves(responses);
+
         // If opponent has no moves, it's checkmate
-        if (!foundMove) {
+        if (responses.empty()) {
             return isMaximizing ? ChessUtils::CHECKMATE_SCORE : -ChessUtils::CHECKMATE_SCORE;
         }
 
+        // Good captures first, so the early exit below triggers sooner
+        orderMoves(context.board, responses);
+        context.stats.expandedNodes++;
+        int bestScore = isMaximizing ? INT_MIN : INT_MAX;
+
+        // Check all possible opponent responses
+        for (const BoardMove& response : responses) {
+            if (response.isUnderpromotion()) {
+                continue;
+            }
+            ChessMove opponentMove(coordinatesToNotation(response.srcRow, response.srcCol),
+                coordinatesToNotation(response.destRow, response.destCol), !move.getIsWhite());
+            context.stats.searchedChildren++;
+            int opponentScore = minimax(context, opponentMove, depth - 1, !isMaximizing);
+
+            // Update best score based on who's playing
+            if (isMaximizing) {
+                bestScore = std::max(bestScore, opponentScore);
+            }
+            else {
+                bestScore = std::min(bestScore, opponentScore);
+            }
+
+            // Early exit if we found a really good/bad move
+            if ((isMaximizing && bestScore > ChessUtils::ALPHA_BETA_CUTOFF) ||
+                (!isMaximizing && bestScore < -ChessUtils::ALPHA_BETA_CUTOFF)) {
+                context.stats.cutoffsPerPly[std::min(m_maxDepth - depth, ChessUtils::MAX_SEARCH_PLY - 1)]++;
+                return currentScore + bestScore / depth;
+            }
+        }
+
         // Combine current move score with best opponent response
         return currentScore + bestScore / depth;
         });
@@ -171,111 +269,465 @@ int MoveRecommender::minimax(const ChessMove& move, int depth, bool isMaximizing
 
 /**
  * @brief Evaluates a position based on multiple factors.
+ *
+ * Material and center control are read from the board's incremental terms
+ * before and after the move, so no extra validation or scan is needed.
  */
-int MoveRecommender::evaluatePosition(const ChessMove& move) {
-    auto [srcRow, srcCol] = m_board.notationToCoordinates(move.getSourcePos());
-    auto [destRow, destCol] = m_board.notationToCoordinates(move.getDestPos());
-
-    std::shared_ptr<Piece> movingPiece = m_board.getPieceAt(srcRow, srcCol);
+int MoveRecommender::evaluatePosition(SearchContext& context, const ChessMove& move) {
+    CHESS_TRACE_SCOPE("MoveRecommender::evaluatePosition");
+    CHESS_ALLOCATION_PHASE(EVALUATION);
+    Board& board = context.board;
+    auto [srcRow, srcCol] = board.notationToCoordinates(move.getSourcePos());
+    auto [destRow, destCol] = board.notationToCoordinates(move.getDestPos());
+
+    std::shared_ptr<Piece> movingPiece = board.getPieceAt(srcRow, srcCol);
     if (!movingPiece) return 0;
 
+    context.stats.leafEvaluations++;
+    bool isWhite = movingPiece->getIsWhite();
+    int evaluationBefore = getStaticEvaluation(board, isWhite);
     int score = 0;
-    int moveCode = m_board.validateMove(move.getSourcePos(), move.getDestPos());
 
-    // 1. Capture bonus
-    std::shared_ptr<Piece> capturedPiece = m_board.getPieceAt(destRow, destCol);
-    if (capturedPiece && capturedPiece->getIsWhite() != movingPiece->getIsWhite()) {
-        score += getPieceValue(capturedPiece->getSymbol()) * ChessUtils::CAPTURE_MULTIPLIER;
+    // 1. King move penalty (generally avoid moving king unless necessary)
+    if (tolower(movingPiece->getSymbol()) == static_cast<char>(ChessUtils::PieceType::KING)) {
+        score += ChessUtils::KING_MOVE_PENALTY;
     }
 
-    // 2. Check bonus
-    if (moveCode == ChessUtils::VALID_MOVE_CHECK) {
-        score += ChessUtils::CHECK_BONUS;
+    // 2. Add small randomness to vary play, from the thread's own generator
+    if (m_isRandomnessEnabled) {
+        score += context.random.nextInt(ChessUtils::RANDOMNESS_RANGE);
     }
 
-    // 3. Center control bonus
-    score += evaluateCenterControl(destRow, destCol);
+    return makeTemporaryMoveAndEvaluate(board, move, [&]() {
+        // 3. Capture, piece-square and structure gain
+        score += getStaticEvaluation(board, isWhite) - evaluationBefore;
 
-    // 4. King move penalty (generally avoid moving king unless necessary)
-    if (tolower(movingPiece->getSymbol()) == static_cast<char>(ChessUtils::PieceType::KING)) {
-        score += ChessUtils::KING_MOVE_PENALTY;
-    }
-
-    // 5. Add small randomness to vary play
-    score += rand() % ChessUtils::RANDOMNESS_RANGE;
+        // 4. Check bonus
+        if (board.isKingInCheck(!isWhite)) {
+            score += ChessUtils::CHECK_BONUS;
+        }
 
-    // 6. Evaluate threats after the move
-    return makeTemporaryMoveAndEvaluate(move, [&]() {
-        int pieceValue = getPieceValue(movingPiece->getSymbol());
-        return score + evaluateThreat(destRow, destCol, movingPiece->getIsWhite(), pieceValue);
+        // 5. Evaluate threats after the move
+        return score + evaluateThreat(board, destRow, destCol, isWhite);
         });
 }
 
 /**
- * @brief Evaluates center control bonus.
+ * @brief Static evaluation of the current position from one side's point of view.
+ *
+ * Material and piece-square terms come from the board's incremental totals,
+ * pawn structure from the pawn table and king shelter is computed on a miss.
+ * With a network attached the board's NNUE accumulator is used instead.
+ * The result is cached by position hash.
+ */
+int MoveRecommender::getStaticEvaluation(const Board& board, bool forWhite) {
+    int evaluation = 0;
+    if (!m_evaluationCache.probe(board.getHash(), evaluation)) {
+        if (board.hasNetwork()) {
+            // The network scores for the side to move, the cache keeps white's view
+            int sideToMove = board.getNetworkEvaluation();
+            evaluation = board.getIsWhiteTurn() ? sideToMove : -sideToMove;
+        }
+        else {
+            evaluation = board.getEvaluation(true) + evaluatePawnStructure(board) +
+                evaluateKingShelter(board, true) - evaluateKingShelter(board, false);
+        }
+        m_evaluationCache.store(board.getHash(), evaluation);
+    }
+    return forWhite ? evaluation : -evaluation;
+}
+
+/**
+ * @brief Pawn structure balance (white minus black), cached by pawn hash.
+ */
+int MoveRecommender::evaluatePawnStructure(const Board& board) {
+    int score = 0;
+    if (!m_pawnTable.probe(board.getPawnHash(), score)) {
+        score = evaluatePawnStructure(board, true) - evaluatePawnStructure(board, false);
+        m_pawnTable.store(board.getPawnHash(), score);
+    }
+    return score;
+}
+
+/**
+ * @brief Doubled, isolated and passed pawn terms for one side.
  */
-int MoveRecommender::evaluateCenterControl(int row, int col) const {
-    // Check inner center squares
-    for (int i = 0; i < 4; i++) {
-        if (row == ChessUtils::CENTER_SQUARES_INNER[i][0] &&
-            col == ChessUtils::CENTER_SQUARES_INNER[i][1]) {
-            return ChessUtils::CENTER_BONUS_INNER;
+int MoveRecommender::evaluatePawnStructure(const Board& board, bool isWhite) const {
+    Bitboard pawns = board.getPieces(isWhite, ChessUtils::PAWN_INDEX);
+    Bitboard enemyPawns = board.getPieces(!isWhite, ChessUtils::PAWN_INDEX);
+    int colorIndex = Bitboards::colorIndex(isWhite);
+    int score = 0;
+
+    for (int col = 0; col < ChessUtils::BOARD_SIZE; col++) {
+        int pawnsOnColumn = Bitboards::countSquares(pawns & Bitboards::COLUMN_MASKS[col]);
+        if (pawnsOnColumn > 1) {
+            score += (pawnsOnColumn - 1) * ChessUtils::DOUBLED_PAWN_PENALTY;
         }
     }
 
-    // Check outer center squares
-    for (int i = 0; i < 12; i++) {
-        if (row == ChessUtils::CENTER_SQUARES_OUTER[i][0] &&
-            col == ChessUtils::CENTER_SQUARES_OUTER[i][1]) {
-            return ChessUtils::CENTER_BONUS_OUTER;
+    Bitboard remaining = pawns;
+    while (remaining) {
+        int square = Bitboards::popLowestSquare(remaining);
+        int col = Bitboards::squareCol(square);
+
+        Bitboard neighbours = (col > 0 ? Bitboards::COLUMN_MASKS[col - 1] : 0) |
+            (col < ChessUtils::BOARD_SIZE - 1 ? Bitboards::COLUMN_MASKS[col + 1] : 0);
+        if (!(pawns & neighbours)) {
+            score += ChessUtils::ISOLATED_PAWN_PENALTY;
+        }
+
+        if (!(enemyPawns & Bitboards::PASSED_PAWN_MASKS[colorIndex][square])) {
+            int row = Bitboards::squareRow(square);
+            int rowsAdvanced = isWhite ? row - 1 : ChessUtils::BOARD_SIZE - 2 - row;
+            score += rowsAdvanced * ChessUtils::PASSED_PAWN_BONUS;
         }
     }
 
-    return 0;
+    return score;
+}
+
+/**
+ * @brief Bonus for own pawns directly in front of the king.
+ */
+int MoveRecommender::evaluateKingShelter(const Board& board, bool isWhite) const {
+    int kingRow = isWhite ? board.getWhiteKingRow() : board.getBlackKingRow();
+    int kingCol = isWhite ? board.getWhiteKingCol() : board.getBlackKingCol();
+    int kingSquare = Bitboards::squareIndex(kingRow, kingCol);
+
+    // The pawn attack pattern plus the square straight ahead
+    int shelterRow = kingRow + (isWhite ? 1 : -1);
+    Bitboard shelter = Bitboards::PAWN_ATTACKS[Bitboards::colorIndex(isWhite)][kingSquare];
+    if (Bitboards::isOnBoard(shelterRow, kingCol)) {
+        shelter |= Bitboards::squareBit(Bitboards::squareIndex(shelterRow, kingCol));
+    }
+
+    Bitboard pawns = board.getPieces(isWhite, ChessUtils::PAWN_INDEX);
+    return Bitboards::countSquares(pawns & shelter) * ChessUtils::KING_SHELTER_BONUS;
 }
 
 /**
  * @brief Evaluates threats to a piece at given position.
+ *
+ * The opponent's best capture sequence on the square is resolved by static
+ * exchange evaluation, so only real material losses are penalised heavily.
  */
-int MoveRecommender::evaluateThreat(int row, int col, bool isWhite, int pieceValue) {
-    int threatScore = 0;
-
-    // Check if any opponent piece can capture our piece
-    for (int attackerRow = 0; attackerRow < ChessUtils::BOARD_SIZE; attackerRow++) {
-        for (int attackerCol = 0; attackerCol < ChessUtils::BOARD_SIZE; attackerCol++) {
-            std::shared_ptr<Piece> attacker = m_board.getPieceAt(attackerRow, attackerCol);
-
-            if (attacker && attacker->getIsWhite() != isWhite) {
-                std::string source = coordinatesToNotation(attackerRow, attackerCol);
-                std::string dest = coordinatesToNotation(row, col);
-
-                int moveCode = m_board.validateMove(source, dest);
-                if (moveCode == ChessUtils::VALID_MOVE || moveCode == ChessUtils::VALID_MOVE_CHECK) {
-                    int attackerValue = getPieceValue(attacker->getSymbol());
-
-                    // Heavy penalty if threatened by weaker piece
-                    if (attackerValue < pieceValue) {
-                        threatScore -= (pieceValue - attackerValue) * ChessUtils::THREAT_MULTIPLIER;
-                    }
-                    else {
-                        threatScore -= ChessUtils::THREAT_PENALTY;
-                    }
-                }
+int MoveRecommender::evaluateThreat(const Board& board, int row, int col, bool isWhite) const {
+    int square = Bitboards::squareIndex(row, col);
+    Bitboard enemyAttackers = board.getAttackersTo(square, board.getOccupancy()) &
+        board.getColorPieces(!isWhite);
+    if (!enemyAttackers) {
+        return 0;
+    }
+
+    int exchangeLoss = board.staticExchangeEvaluation(square, !isWhite);
+    if (exchangeLoss > 0) {
+        return -exchangeLoss * ChessUtils::THREAT_MULTIPLIER;
+    }
+    return ChessUtils::THREAT_PENALTY;
+}
+
+/**
+ * @brief Iterative deepening alpha-beta search of any board.
+ *
+ * The calling thread searches the given board and reports each completed
+ * depth. With a thread pool, the other threads search their own copies of
+ * the board, starting at alternating depths, and help only through the
+ * transposition table (lazy SMP).
+ */
+SearchInfo MoveRecommender::search(Board& board, const SearchLimits& limits,
+    const std::function<void(const SearchInfo&)>& onIteration) {
+    CHESS_TRACE_SCOPE("MoveRecommender::search");
+    m_searchLimits = &limits;
+    m_isSearchStopped = false;
+    m_searchNodes = 0;
+    m_searchStats.clear();
+    Allocations::Counters allocationsBefore = Allocations::snapshot();
+    // Opened per search, so threads created since are counted too
+    if (m_hardwareCounters) {
+        m_hardwareCounters->start();
+    }
+    m_searchStart = std::chrono::steady_clock::now();
+    m_timeBudgetMs = limits.getTimeBudgetMs(board.getIsWhiteTurn());
+    int maxDepth = ChessUtils::MAX_SEARCH_PLY - 1;
+    if (limits.depth > 0) {
+        maxDepth = std::min(limits.depth, maxDepth);
+    }
+
+    // Copies are made before the main search starts changing the board
+    size_t helperCount = m_pool ? m_pool->getThreadCount() - 1 : 0;
+    std::vector<std::unique_ptr<Board>> helperBoards;
+    std::vector<SearchStats> helperStats(helperCount);
+    for (size_t i = 0; i < helperCount; i++) {
+        helperBoards.push_back(std::make_unique<Board>(board));
+    }
+    for (size_t i = 0; i < helperCount; i++) {
+        m_pool->submit([this, &helperBoards, &helperStats, i, maxDepth]() {
+            SearchContext context{ *helperBoards[i], FastRandom(i + 1) };
+            SearchInfo ignored;
+            iterativeDeepening(context, 1 + (i + 1) % 2, maxDepth, nullptr, ignored);
+            helperStats[i] = context.stats;
+        });
+    }
+
+    SearchContext context{ board, FastRandom(0) };
+    SearchInfo result;
+    iterativeDeepening(context, 1, maxDepth, onIteration ? &onIteration : nullptr, result);
+
+    m_isSearchStopped = true;
+    if (helperCount > 0) {
+        m_pool->wait();
+    }
+    result.nodes = m_searchNodes;
+    result.elapsedMs = getElapsedMs();
+    m_searchStats.merge(context.stats);
+    for (const SearchStats& stats : helperStats) {
+        m_searchStats.merge(stats);
+    }
+    m_searchStats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_searchStart).count();
+    m_searchStats.allocations = Allocations::snapshot() - allocationsBefore;
+    if (m_hardwareCounters) {
+        m_searchStats.hardware = m_hardwareCounters->stop();
+    }
+    m_searchLimits = nullptr;
+    return result;
+}
+
+/**
+ * @brief Searches depth after depth until a limit is hit.
+ *
+ * An iteration cut short by the limits is dropped, except the first one.
+ */
+void MoveRecommender::iterativeDeepening(SearchContext& context, int firstDepth, int maxDepth,
+    const std::function<void(const SearchInfo&)>* onIteration, SearchInfo& result) {
+    CHESS_ALLOCATION_PHASE(TREE_SEARCH);
+    for (int depth = firstDepth; depth <= maxDepth; depth++) {
+        PrincipalVariation pv;
+        int score = alphaBeta(context, depth, 0, -ChessUtils::SEARCH_INFINITY, ChessUtils::SEARCH_INFINITY, pv);
+        if (m_isSearchStopped && result.depth > 0) {
+            break;
+        }
+
+        result.depth = depth;
+        result.score = score;
+        result.principalVariation.assign(pv.moves.begin(), pv.moves.begin() + pv.length);
+        m_searchNodes += context.unreportedNodes;
+        context.unreportedNodes = 0;
+        result.nodes = m_searchNodes;
+        result.elapsedMs = getElapsedMs();
+        if (onIteration) {
+            (*onIteration)(result);
+        }
+
+        // The next iteration takes longer than all the previous ones together
+        if (m_isSearchStopped || (m_timeBudgetMs > 0 && result.elapsedMs * 2 > m_timeBudgetMs)) {
+            break;
+        }
+        // A mate within the searched depth can't be improved on
+        if (std::abs(score) >= ChessUtils::MATE_THRESHOLD && ChessUtils::SEARCH_MATE_SCORE - std::abs(score) <= depth) {
+            break;
+        }
+    }
+    m_searchNodes += context.unreportedNodes;
+    context.unreportedNodes = 0;
+}
+
+/**
+ * @brief Negamax alpha-beta, scores are from the side to move's point of view.
+ */
+int MoveRecommender::alphaBeta(SearchContext& context, int depth, int ply, int alpha, int beta, PrincipalVariation& pv) {
+    pv.length = 0;
+    if (depth <= 0 || ply >= ChessUtils::MAX_SEARCH_PLY - 1) {
+        return quiescence(context, ply, alpha, beta);
+    }
+    if (visitNode(context)) {
+        return 0;
+    }
+
+    // Tablebase positions are scored exactly, nothing below them is searched
+    Board& board = context.board;
+    int tablebaseScore = 0;
+    if (ply > 0 && probeTablebases(board, ply, tablebaseScore)) {
+        return tablebaseScore;
+    }
+
+    uint64_t key = board.getHash();
+    BoardMove hashMove = { -1, -1, -1, -1 };
+    TranspositionEntry entry;
+    context.stats.transpositionProbes++;
+    if (m_transpositionTable->probe(key, entry)) {
+        context.stats.transpositionHits++;
+        hashMove = entry.move;
+        int score = fromTableScore(entry.score, ply);
+        bool isUsable = entry.bound == ScoreBound::EXACT ||
+            (entry.bound == ScoreBound::LOWER && score >= beta) ||
+            (entry.bound == ScoreBound::UPPER && score <= alpha);
+        if (ply > 0 && entry.depth >= depth && isUsable) {
+            return score;
+        }
+    }
+
+    std::vector<BoardMove> moves;
+    board.generateLegalMoves(moves);
+    if (moves.empty()) {
+        return board.isKingInCheck(board.getIsWhiteTurn()) ? -ChessUtils::SEARCH_MATE_SCORE + ply : 0;
+    }
+    orderSearchMoves(board, moves, hashMove);
+    context.stats.expandedNodes++;
+
+    int originalAlpha = alpha;
+    int bestScore = -ChessUtils::SEARCH_INFINITY;
+    BoardMove bestMove = moves.front();
+    PrincipalVariation childPv;
+    for (const BoardMove& move : moves) {
+        context.stats.searchedChildren++;
+        board.makeMove(move);
+        int score = -alphaBeta(context, depth - 1, ply + 1, -beta, -alpha, childPv);
+        board.undoMove();
+
+        if (m_isSearchStopped.load(std::memory_order_relaxed)) {
+            return bestScore > -ChessUtils::SEARCH_INFINITY ? bestScore : 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                pv.moves[0] = move;
+                std::copy(childPv.moves.begin(), childPv.moves.begin() + childPv.length, pv.moves.begin() + 1);
+                pv.length = childPv.length + 1;
+            }
+            if (alpha >= beta) {
+                context.stats.cutoffsPerPly[ply]++;
+                break;
             }
         }
     }
 
-    return threatScore;
+    ScoreBound bound = bestScore >= beta ? ScoreBound::LOWER :
+        bestScore > originalAlpha ? ScoreBound::EXACT : ScoreBound::UPPER;
+    m_transpositionTable->store(key, { toTableScore(bestScore, ply), depth, bound, bestMove });
+    return bestScore;
+}
+
+/**
+ * @brief Resolves captures before trusting the static evaluation.
+ *
+ * Only captures that don't lose material by static exchange are tried.
+ */
+int MoveRecommender::quiescence(SearchContext& context, int ply, int alpha, int beta) {
+    if (visitNode(context)) {
+        return 0;
+    }
+
+    Board& board = context.board;
+    int tablebaseScore = 0;
+    if (probeTablebases(board, ply, tablebaseScore)) {
+        return tablebaseScore;
+    }
+
+    context.stats.leafEvaluations++;
+    int standPat = getStaticEvaluation(board, board.getIsWhiteTurn());
+    if (standPat >= beta) {
+        context.stats.cutoffsPerPly[ply]++;
+        return standPat;
+    }
+    if (ply >= ChessUtils::MAX_SEARCH_PLY - 1) {
+        return standPat;
+    }
+    alpha = std::max(alpha, standPat);
+
+    std::vector<BoardMove> moves;
+    board.generateLegalMoves(moves);
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [&board](const BoardMove& move) {
+        return !board.getPieceAt(move.destRow, move.destCol) || board.staticExchangeEvaluation(move) < 0;
+    }), moves.end());
+    orderMoves(board, moves);
+    context.stats.expandedNodes++;
+
+    for (const BoardMove& move : moves) {
+        context.stats.searchedChildren++;
+        board.makeMove(move);
+        int score = -quiescence(context, ply + 1, -beta, -alpha);
+        board.undoMove();
+
+        if (m_isSearchStopped.load(std::memory_order_relaxed)) {
+            return alpha;
+        }
+        if (score >= beta) {
+            context.stats.cutoffsPerPly[ply]++;
+            return score;
+        }
+        alpha = std::max(alpha, score);
+    }
+    return alpha;
+}
+
+/**
+ * @brief Usual ordering, with the transposition table move first.
+ */
+void MoveRecommender::orderSearchMoves(const Board& board, std::vector<BoardMove>& moves, const BoardMove& firstMove) const {
+    orderMoves(board, moves);
+    auto it = std::find(moves.begin(), moves.end(), firstMove);
+    if (it != moves.end()) {
+        std::rotate(moves.begin(), it, it + 1);
+    }
+}
+
+/**
+ * @brief Counts one node, returns true when the search must end.
+ *
+ * The limits are checked every SEARCH_CHECK_INTERVAL nodes, when the thread
+ * adds its count to the shared one.
+ */
+bool MoveRecommender::visitNode(SearchContext& context) {
+    context.stats.nodes++;
+    if (++context.unreportedNodes >= ChessUtils::SEARCH_CHECK_INTERVAL) {
+        uint64_t totalNodes = m_searchNodes.fetch_add(context.unreportedNodes, std::memory_order_relaxed) +
+            context.unreportedNodes;
+        context.unreportedNodes = 0;
+
+        const std::atomic<bool>* stopRequested = m_searchLimits->stopRequested;
+        if ((stopRequested && stopRequested->load(std::memory_order_relaxed)) ||
+            (m_searchLimits->nodes > 0 && totalNodes >= m_searchLimits->nodes) ||
+            (m_timeBudgetMs > 0 && getElapsedMs() >= m_timeBudgetMs)) {
+            m_isSearchStopped.store(true, std::memory_order_relaxed);
+        }
+    }
+    return m_isSearchStopped.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Exact score of a position the tablebases cover, false if none does.
+ *
+ * A mate n plies from here scores like a mate found at ply + n.
+ */
+bool MoveRecommender::probeTablebases(const Board& board, int ply, int& score) const {
+    TablebaseResult result;
+    if (!m_tablebases || !m_tablebases->probe(board, result)) {
+        return false;
+    }
+
+    int mateScore = ChessUtils::SEARCH_MATE_SCORE - ply - result.distance;
+    score = result.outcome == Tablebase::WDL_WIN ? mateScore : result.outcome == Tablebase::WDL_LOSS ? -mateScore : 0;
+    return true;
+}
+
+/**
+ * @brief Milliseconds since the current search started.
+ */
+int64_t MoveRecommender::getElapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_searchStart).count();
 }
 
 /**
  * @brief Makes a temporary move, evaluates, then restores board.
  */
-int MoveRecommender::makeTemporaryMoveAndEvaluate(const ChessMove& move, std::function<int()> evaluationFunc) {
-    BoardState savedState = m_board.saveState();
-    m_board.makeMove(move.getSourcePos(), move.getDestPos());
+int MoveRecommender::makeTemporaryMoveAndEvaluate(Board& board, const ChessMove& move, std::function<int()> evaluationFunc) {
+    board.makeMove(move.getSourcePos(), move.getDestPos());
     int result = evaluationFunc();
-    m_board.restoreState(savedState);
+    board.undoMove();
     return result;
 }
 
@@ -283,11 +735,67 @@ int MoveRecommender::makeTemporaryMoveAndEvaluate(const ChessMove& move, std::fu
  * @brief Main function to get move recommendations.
  */
 void MoveRecommender::recommendMoves() {
-    refreshMoveQueue();
+    CHESS_TRACE_SCOPE("MoveRecommender::recommendMoves");
+    auto start = std::chrono::steady_clock::now();
+    m_searchStats.clear();
+    Allocations::Counters allocationsBefore = Allocations::snapshot();
+    // Opened per search, so threads created since are counted too
+    if (m_hardwareCounters) {
+        m_hardwareCounters->start();
+    }
+    m_isWhiteTurn = m_board.getIsWhiteTurn();
+    if (!probeBook()) {
+        refreshMoveQueue();
+    }
+    m_searchStats.elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    m_searchStats.allocations = Allocations::snapshot() - allocationsBefore;
+    if (m_hardwareCounters) {
+        m_searchStats.hardware = m_hardwareCounters->stop();
+    }
+}
 
+/**
+ * @brief Scores any board without touching the recommendation queue.
+ *
+ * Returns the best root move score for the side to move, or the mate/stalemate
+ * score when there is no legal move. Only the lock-free caches are shared, so
+ * several threads may search their own boards at once.
+ */
+int MoveRecommender::searchPosition(Board& board, uint64_t seed) {
+    std::vector<BoardMove> moves;
+    board.generateLegalMoves(moves);
+    if (moves.empty()) {
+        return board.isKingInCheck(board.getIsWhiteTurn()) ? -ChessUtils::CHECKMATE_SCORE : 0;
+    }
 
+    int bestScore = INT_MIN;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const BoardMove& boardMove = moves[i];
+        if (boardMove.isUnderpromotion()) {
+            continue;
+        }
+        ChessMove move(coordinatesToNotation(boardMove.srcRow, boardMove.srcCol),
+            coordinatesToNotation(boardMove.destRow, boardMove.destCol), board.getIsWhiteTurn());
+        SearchContext context{ board, FastRandom(seed + i) };
+        bestScore = std::max(bestScore, minimax(context, move, m_maxDepth, true));
+    }
+    return bestScore;
+}
 
-    m_isWhiteTurn = !m_isWhiteTurn;
+/**
+ * @brief Static evaluation of any board for its side to move, shared with offline scoring.
+ */
+int MoveRecommender::getStaticScore(const Board& board) {
+    return getStaticEvaluation(board, board.getIsWhiteTurn());
+}
+
+/**
+ * @brief Scores a single move on any board, the static part of the root move scoring.
+ */
+int MoveRecommender::evaluateMove(Board& board, const ChessMove& move, uint64_t seed) {
+    SearchContext context{ board, FastRandom(seed) };
+    return evaluatePosition(context, move);
 }
 
 /**
@@ -295,4 +803,138 @@ void MoveRecommender::recommendMoves() {
  */
 void MoveRecommender::printRecommendations() const {
     std::cout << m_moveQueue;
-}
\ No newline at end of file
+    if (m_isStatsPrinted) {
+        std::cout << m_searchStats;
+    }
+}
+
+/**
+ * @brief Returns the recommended moves, best first.
+ */
+const std::vector<ChessMove>& MoveRecommender::getRecommendations() const {
+    return m_moveQueue.getList();
+}
+
+/**
+ * @brief Counters of the last recommendMoves or search.
+ */
+const SearchStats& MoveRecommender::getSearchStats() const {
+    return m_searchStats;
+}
+
+/**
+ * @brief Prints the search statistics after the recommendations, or stops printing them.
+ */
+void MoveRecommender::setStatsPrinted(bool isPrinted) {
+    m_isStatsPrinted = isPrinted;
+}
+
+/**
+ * @brief Turns the perf_event counters around each search on or off.
+ *
+ * A first measurement right away tells which events the kernel refuses.
+ */
+void MoveRecommender::setHardwareCountersEnabled(bool isEnabled) {
+    if (!isEnabled) {
+        m_hardwareCounters.reset();
+        return;
+    }
+    m_hardwareCounters = std::make_unique<HardwareCounters>();
+    m_hardwareCounters->start();
+    m_hardwareCounters->stop();
+    if (!m_hardwareCounters->getError().empty()) {
+        std::cerr << "Counters left out: " << m_hardwareCounters->getError() << std::endl;
+    }
+}
+
+/**
+ * @brief Fixes the seed of the move randomness, so that searches replay exactly.
+ */
+void MoveRecommender::setSeed(uint64_t seed) {
+    m_seedGenerator.setSeed(seed);
+}
+
+/**
+ * @brief Turns the small random score variation on or off.
+ */
+void MoveRecommender::setRandomnessEnabled(bool isEnabled) {
+    m_isRandomnessEnabled = isEnabled;
+}
+
+/**
+ * @brief Sets how many threads score the root moves.
+ */
+void MoveRecommender::setThreadCount(size_t threadCount) {
+    if (threadCount == 1) {
+        m_pool.reset();
+    }
+    else {
+        m_pool = std::make_unique<ThreadPool>(threadCount);
+    }
+}
+
+/**
+ * @brief Attaches an NNUE network to the board, cached evaluations are dropped.
+ */
+void MoveRecommender::setNetwork(std::shared_ptr<const NnueNetwork> network) {
+    m_board.setNetwork(network);
+    m_evaluationCache.clear();
+}
+
+/**
+ * @brief Attaches an opening book, shared with any other recommender.
+ */
+void MoveRecommender::setOpeningBook(std::shared_ptr<const OpeningBook> book, BookSelection selection) {
+    m_book = std::move(book);
+    m_bookSelection = selection;
+}
+
+/**
+ * @brief Attaches endgame tables, shared with any other recommender.
+ */
+void MoveRecommender::setTablebases(std::shared_ptr<const Tablebases> tablebases) {
+    m_tablebases = std::move(tablebases);
+}
+
+/**
+ * @brief Resizes the transposition table, clearing it.
+ */
+void MoveRecommender::resizeTranspositionTable(size_t sizeMb) {
+    m_transpositionTable->resize(sizeMb);
+}
+
+/**
+ * @brief Forgets every stored search result, for a new game.
+ */
+void MoveRecommender::clearTranspositionTable() {
+    m_transpositionTable->clear();
+}
+
+/**
+ * @brief Replaces the transposition table with one shared by other recommenders.
+ */
+void MoveRecommender::setTranspositionTable(std::shared_ptr<TranspositionTable> table) {
+    m_transpositionTable = std::move(table);
+}
+
+/**
+ * @brief Resizes the pawn table and the evaluation cache, clearing both.
+ */
+void MoveRecommender::resizeCaches(size_t pawnTableMb, size_t evaluationCacheMb) {
+    m_pawnTable.resize(pawnTableMb);
+    m_evaluationCache.resize(evaluationCacheMb);
+}
+
+/**
+ * @brief Pawn structure table, for its hit/miss counters.
+ */
+const ScoreCache& MoveRecommender::getPawnTable() const {
+    return m_pawnTable;
+}
+
+/**
+ * @brief Full evaluation cache, for its hit/miss counters.
+ */
+const ScoreCache& MoveRecommender::getEvaluationCache() const {
+    return m_evaluationCache;
+}
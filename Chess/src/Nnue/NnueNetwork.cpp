@@ -0,0 +1,134 @@
+#include "Nnue/NnueNetwork.h"
+#include "Nnue/NnueKernels.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const char FILE_MAGIC[4] = { 'C', 'N', 'U', 'E' };
+
+    // reads count little endian values, the engine only targets little endian CPUs
+    template <typename T>
+    void readValues(std::ifstream& file, T* values, size_t count, const std::string& path) {
+        file.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!file) {
+            throw std::runtime_error("Error: NNUE file " + path + " is truncated");
+        }
+    }
+
+    template <typename T>
+    void readVector(std::ifstream& file, std::vector<T>& values, size_t count, const std::string& path) {
+        values.resize(count);
+        readValues(file, values.data(), count, path);
+    }
+}
+
+//======================================================================
+// c-tor, loads and checks the weights file
+NnueNetwork::NnueNetwork(const std::string& path)
+    : m_outputBias(0)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Error: NNUE file " + path + " not found");
+    }
+
+    char magic[4] = {};
+    uint32_t header[5] = {};
+    readValues(file, magic, 4, path);
+    readValues(file, header, 5, path);
+
+    const uint32_t expected[5] = { Nnue::FILE_VERSION, Nnue::FEATURE_COUNT, Nnue::ACCUMULATOR_SIZE,
+        Nnue::HIDDEN1_SIZE, Nnue::HIDDEN2_SIZE };
+    if (!std::equal(magic, magic + 4, FILE_MAGIC) || !std::equal(header, header + 5, expected)) {
+        throw std::runtime_error("Error: " + path + " is not a compatible NNUE file");
+    }
+
+    readVector(file, m_featureBiases, Nnue::ACCUMULATOR_SIZE, path);
+    readVector(file, m_featureWeights, static_cast<size_t>(Nnue::FEATURE_COUNT) * Nnue::ACCUMULATOR_SIZE, path);
+    readVector(file, m_hidden1Biases, Nnue::HIDDEN1_SIZE, path);
+    readVector(file, m_hidden1Weights, Nnue::HIDDEN1_SIZE * 2 * Nnue::ACCUMULATOR_SIZE, path);
+    readVector(file, m_hidden2Biases, Nnue::HIDDEN2_SIZE, path);
+    readVector(file, m_hidden2Weights, Nnue::HIDDEN2_SIZE * Nnue::HIDDEN1_SIZE, path);
+    readValues(file, &m_outputBias, 1, path);
+    readVector(file, m_outputWeights, Nnue::HIDDEN2_SIZE, path);
+}
+
+//======================================================================
+// feature of a piece seen from one side, relative to that side's king
+int NnueNetwork::getFeatureIndex(int perspective, int kingSquare, int colorIndex, int pieceIndex, int square)
+{
+    if (perspective == Bitboards::BLACK) {
+        kingSquare = Bitboards::mirrorSquare(kingSquare);
+        square = Bitboards::mirrorSquare(square);
+    }
+    int relativeColor = colorIndex == perspective ? 0 : 1;
+    int pieceFeature = pieceIndex * Bitboards::COLOR_COUNT + relativeColor;
+
+    return (kingSquare * Nnue::PIECE_FEATURES + pieceFeature) * ChessUtils::SQUARE_COUNT + square;
+}
+
+//======================================================================
+// sums the weights of every non-king piece for one perspective
+void NnueNetwork::refreshAccumulator(NnueAccumulator& accumulator, int perspective, int kingSquare,
+    const PieceBitboards& pieces) const
+{
+    std::copy(m_featureBiases.begin(), m_featureBiases.end(), accumulator.values[perspective].begin());
+
+    for (int colorIndex = 0; colorIndex < Bitboards::COLOR_COUNT; colorIndex++) {
+        for (int pieceIndex = 0; pieceIndex < ChessUtils::KING_INDEX; pieceIndex++) {
+            Bitboard remaining = pieces[colorIndex][pieceIndex];
+            while (remaining) {
+                addFeature(accumulator, perspective, kingSquare, colorIndex, pieceIndex,
+                    Bitboards::popLowestSquare(remaining));
+            }
+        }
+    }
+}
+
+//======================================================================
+void NnueNetwork::addFeature(NnueAccumulator& accumulator, int perspective, int kingSquare,
+    int colorIndex, int pieceIndex, int square) const
+{
+    size_t feature = getFeatureIndex(perspective, kingSquare, colorIndex, pieceIndex, square);
+    NnueKernels::addWeights(accumulator.values[perspective].data(),
+        &m_featureWeights[feature * Nnue::ACCUMULATOR_SIZE], Nnue::ACCUMULATOR_SIZE);
+}
+
+//======================================================================
+void NnueNetwork::removeFeature(NnueAccumulator& accumulator, int perspective, int kingSquare,
+    int colorIndex, int pieceIndex, int square) const
+{
+    size_t feature = getFeatureIndex(perspective, kingSquare, colorIndex, pieceIndex, square);
+    NnueKernels::subtractWeights(accumulator.values[perspective].data(),
+        &m_featureWeights[feature * Nnue::ACCUMULATOR_SIZE], Nnue::ACCUMULATOR_SIZE);
+}
+
+//======================================================================
+// runs the dense layers, the side to move's accumulator half goes first
+int NnueNetwork::evaluate(const NnueAccumulator& accumulator, bool isWhiteToMove) const
+{
+    int us = Bitboards::colorIndex(isWhiteToMove);
+    int them = Bitboards::colorIndex(!isWhiteToMove);
+
+    alignas(32) uint8_t input[2 * Nnue::ACCUMULATOR_SIZE];
+    NnueKernels::clippedRelu(accumulator.values[us].data(), input, Nnue::ACCUMULATOR_SIZE);
+    NnueKernels::clippedRelu(accumulator.values[them].data(), input + Nnue::ACCUMULATOR_SIZE, Nnue::ACCUMULATOR_SIZE);
+
+    alignas(32) uint8_t hidden1[Nnue::HIDDEN1_SIZE];
+    for (int i = 0; i < Nnue::HIDDEN1_SIZE; i++) {
+        int32_t sum = m_hidden1Biases[i] +
+            NnueKernels::dotProduct(input, &m_hidden1Weights[i * 2 * Nnue::ACCUMULATOR_SIZE], 2 * Nnue::ACCUMULATOR_SIZE);
+        hidden1[i] = static_cast<uint8_t>(std::clamp(sum >> Nnue::WEIGHT_SHIFT, 0, 127));
+    }
+
+    alignas(32) uint8_t hidden2[Nnue::HIDDEN2_SIZE];
+    for (int i = 0; i < Nnue::HIDDEN2_SIZE; i++) {
+        int32_t sum = m_hidden2Biases[i] +
+            NnueKernels::dotProduct(hidden1, &m_hidden2Weights[i * Nnue::HIDDEN1_SIZE], Nnue::HIDDEN1_SIZE);
+        hidden2[i] = static_cast<uint8_t>(std::clamp(sum >> Nnue::WEIGHT_SHIFT, 0, 127));
+    }
+
+    int32_t output = m_outputBias + NnueKernels::dotProduct(hidden2, m_outputWeights.data(), Nnue::HIDDEN2_SIZE);
+    return output / Nnue::OUTPUT_SCALE;
+}
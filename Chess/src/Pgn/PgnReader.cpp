@@ -0,0 +1,369 @@
+#include "Pgn/PgnReader.h"
+#include "Utils/MappedFile.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    const std::string_view WHITESPACE = " \t\r\n";
+    const std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+
+    bool isLegalCode(int code) {
+        return code == ChessUtils::VALID_MOVE || code == ChessUtils::VALID_MOVE_CHECK;
+    }
+
+    bool isResult(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    // [Name "value"] at pos, unlike a [%clk ...] command or a bracket in a comment
+    bool isTagLine(std::string_view text, size_t pos) {
+        if (pos >= text.size() || text[pos] != '[') {
+            return false;
+        }
+        size_t nameEnd = pos + 1;
+        while (nameEnd < text.size() &&
+            (std::isalnum(static_cast<unsigned char>(text[nameEnd])) || text[nameEnd] == '_')) {
+            nameEnd++;
+        }
+        size_t value = text.find_first_not_of(" \t", nameEnd);
+        return nameEnd > pos + 1 && value != std::string_view::npos && value > nameEnd && text[value] == '"';
+    }
+
+    // skips a {comment}, ;comment or (variation, nested), returns the offset after it
+    size_t skipAnnotation(std::string_view text, size_t pos) {
+        if (text[pos] == '{') {
+            size_t close = text.find('}', pos);
+            return close == std::string_view::npos ? text.size() : close + 1;
+        }
+        if (text[pos] == ';') {
+            size_t lineEnd = text.find('\n', pos);
+            return lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+        }
+
+        int depth = 0;
+        while (pos < text.size()) {
+            if (text[pos] == '{') {
+                pos = skipAnnotation(text, pos);
+                continue;
+            }
+            if (text[pos] == '(') {
+                depth++;
+            }
+            else if (text[pos] == ')' && --depth == 0) {
+                return pos + 1;
+            }
+            pos++;
+        }
+        return pos;
+    }
+}
+
+//======================================================================
+PgnReader::PgnReader(size_t threadCount)
+    : m_pool(threadCount), m_gameCount(0), m_plyCount(0), m_elapsedSeconds(0)
+{
+}
+
+//======================================================================
+void PgnReader::read(const std::string& path)
+{
+    MappedFile file(path);
+    read(file.getContents());
+}
+
+//======================================================================
+// cuts the text into chunks at game starts, replays them in parallel and merges the results
+void PgnReader::read(std::string_view contents)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    size_t chunkCount = m_pool.getThreadCount() * CHUNKS_PER_THREAD;
+    std::vector<size_t> boundaries(chunkCount + 1, contents.size());
+    boundaries[0] = 0;
+    for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+        boundaries[chunk] = std::max(boundaries[chunk - 1],
+            findGameStart(contents, contents.size() * chunk / chunkCount));
+    }
+
+    std::vector<ChunkResult> results(chunkCount);
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        m_pool.submit([&contents, &boundaries, &results, chunk]() {
+            readChunk(contents, boundaries[chunk], boundaries[chunk + 1], results[chunk]);
+        });
+    }
+    m_pool.wait();
+
+    // Chunk game numbers become file game numbers
+    m_gameCount = 0;
+    m_plyCount = 0;
+    m_errors.clear();
+    for (ChunkResult& result : results) {
+        for (PgnError& error : result.errors) {
+            error.gameNumber += m_gameCount;
+            m_errors.push_back(std::move(error));
+        }
+        m_gameCount += result.gameCount;
+        m_plyCount += result.plyCount;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_elapsedSeconds = elapsed.count();
+}
+
+//======================================================================
+// first tag line at or after the offset that follows a blank line or the movetext
+// of the previous game (any line but a tag), the end if there is none
+size_t PgnReader::findGameStart(std::string_view contents, size_t offset)
+{
+    if (offset == 0) {
+        return 0;
+    }
+
+    for (size_t pos = contents.find("\n[", offset - 1); pos != std::string_view::npos;
+        pos = contents.find("\n[", pos + 1)) {
+        if (!isTagLine(contents, pos + 1)) {
+            continue;
+        }
+        size_t previousEnd = contents.find_last_not_of(WHITESPACE, pos);
+        if (previousEnd == std::string_view::npos || contents.find('\n', previousEnd) < pos) {
+            return pos + 1;
+        }
+        size_t previousStart = contents.rfind('\n', previousEnd);
+        previousStart = previousStart == std::string_view::npos ? 0 : previousStart + 1;
+        if (contents.substr(previousStart, UTF8_BOM.size()) == UTF8_BOM) {
+            previousStart += UTF8_BOM.size();
+        }
+        if (!isTagLine(contents, contents.find_first_not_of(" \t", previousStart))) {
+            return pos + 1;
+        }
+    }
+    return contents.size();
+}
+
+//======================================================================
+// replays every game of [begin, end), one board per chunk
+void PgnReader::readChunk(std::string_view contents, size_t begin, size_t end, ChunkResult& result)
+{
+    Board startBoard(Fen::parse(ChessUtils::START_FEN));
+    BoardState startState = startBoard.saveState();
+
+    for (size_t gameBegin = begin; gameBegin < end;) {
+        size_t gameEnd = std::min(end, findGameStart(contents, gameBegin + 1));
+        std::string_view game = contents.substr(gameBegin, gameEnd - gameBegin);
+        size_t gameOffset = gameBegin;
+        gameBegin = gameEnd;
+
+        // Tag pairs first, only [FEN "..."] matters here
+        if (game.substr(0, UTF8_BOM.size()) == UTF8_BOM) {
+            game.remove_prefix(UTF8_BOM.size());
+        }
+        std::string_view fen;
+        size_t pos = game.find_first_not_of(WHITESPACE);
+        bool hasTags = false;
+        while (pos != std::string_view::npos && game[pos] == '[') {
+            size_t lineEnd = std::min(game.find('\n', pos), game.size());
+            std::string_view tag = game.substr(pos, lineEnd - pos);
+            if (tag.substr(0, 5) == "[FEN ") {
+                size_t open = tag.find('"');
+                size_t close = tag.rfind('"');
+                fen = open < close ? tag.substr(open + 1, close - open - 1) : tag.substr(5);
+            }
+            hasTags = true;
+            pos = game.find_first_not_of(WHITESPACE, lineEnd);
+        }
+        std::string_view movetext = pos == std::string_view::npos ? std::string_view() : game.substr(pos);
+        if (!hasTags && movetext.empty()) {
+            continue;
+        }
+
+        result.gameCount++;
+        if (fen.empty()) {
+            startBoard.restoreState(startState);
+            replayGame(startBoard, movetext, gameOffset, result);
+            continue;
+        }
+        try {
+            Board board(Fen::parse(std::string(fen)));
+            replayGame(board, movetext, gameOffset, result);
+        }
+        catch (const std::runtime_error&) {
+            result.errors.push_back({ result.gameCount, gameOffset, 0, std::string(fen) });
+        }
+    }
+}
+
+//======================================================================
+// plays the movetext until the result token, the first bad move ends the game
+void PgnReader::replayGame(Board& board, std::string_view movetext, size_t offset, ChunkResult& result)
+{
+    int ply = 0;
+    size_t pos = 0;
+    while (pos < movetext.size()) {
+        char symbol = movetext[pos];
+        if (WHITESPACE.find(symbol) != std::string_view::npos) {
+            pos++;
+            continue;
+        }
+        if (symbol == '{' || symbol == ';' || symbol == '(') {
+            pos = skipAnnotation(movetext, pos);
+            continue;
+        }
+
+        size_t tokenEnd = std::min(movetext.find_first_of(" \t\r\n{;()", pos), movetext.size());
+        std::string_view token = movetext.substr(pos, tokenEnd - pos);
+        pos = tokenEnd;
+        if (isResult(token)) {
+            break;
+        }
+        if (symbol == '$') {
+            continue;
+        }
+
+        // Move numbers ("12." or "12...") may be glued to the move
+        size_t digits = token.find_first_not_of("0123456789");
+        if (digits > 0 && digits != std::string_view::npos && token[digits] == '.') {
+            token.remove_prefix(std::min(token.find_first_not_of('.', digits), token.size()));
+        }
+        else if (digits == std::string_view::npos) {
+            token = std::string_view();
+        }
+        if (token.empty()) {
+            continue;
+        }
+
+        BoardMove move;
+        ply++;
+        if (!parseSan(board, token, move)) {
+            result.errors.push_back({ result.gameCount, offset, ply, std::string(token) });
+            break;
+        }
+        board.makeMove(move);
+        result.plyCount++;
+    }
+}
+
+//======================================================================
+// piece letter, optional source file and/or rank, optional x, destination,
+// optional promotion; check and annotation marks are ignored
+bool PgnReader::parseSan(Board& board, std::string_view san, BoardMove& move)
+{
+    while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos) {
+        san.remove_suffix(1);
+    }
+
+    bool isWhite = board.getIsWhiteTurn();
+    int homeRow = isWhite ? 0 : ChessUtils::BOARD_SIZE - 1;
+    bool isKingside = san == "O-O" || san == "0-0";
+    if (isKingside || san == "O-O-O" || san == "0-0-0") {
+        std::shared_ptr<Piece> king = board.getPieceAt(homeRow, 4);
+        move = { homeRow, 4, homeRow, isKingside ? 6 : 2 };
+        return king && king->getIsWhite() == isWhite &&
+            ChessUtils::getPieceIndex(king->getSymbol()) == ChessUtils::KING_INDEX &&
+            isLegalCode(board.validateMove(move.srcRow, move.srcCol, move.destRow, move.destCol));
+    }
+
+    int pieceIndex = ChessUtils::PAWN_INDEX;
+    if (!san.empty() && std::string_view("KQRBN").find(san.front()) != std::string_view::npos) {
+        pieceIndex = ChessUtils::getPieceIndex(san.front());
+        san.remove_prefix(1);
+    }
+    int promotionIndex = ChessUtils::NO_PROMOTION;
+    if (pieceIndex == ChessUtils::PAWN_INDEX && !san.empty() &&
+        std::string_view("QRBN").find(san.back()) != std::string_view::npos) {
+        promotionIndex = ChessUtils::getPieceIndex(san.back());
+        san.remove_suffix(1);
+        if (!san.empty() && san.back() == '=') {
+            san.remove_suffix(1);
+        }
+    }
+
+    if (san.size() < 2) {
+        return false;
+    }
+    char file = san[san.size() - 2];
+    char rank = san[san.size() - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+        return false;
+    }
+    int destRow = rank - '1';
+    int destCol = file - 'a';
+
+    // Disambiguation: a source file and/or rank
+    int srcRow = -1;
+    int srcCol = -1;
+    for (char symbol : san.substr(0, san.size() - 2)) {
+        if (symbol >= 'a' && symbol <= 'h') {
+            srcCol = symbol - 'a';
+        }
+        else if (symbol >= '1' && symbol <= '8') {
+            srcRow = symbol - '1';
+        }
+        else if (symbol != 'x') {
+            return false;
+        }
+    }
+
+    int matchCount = 0;
+    Bitboard pieces = board.getPieces(isWhite, pieceIndex);
+    while (pieces) {
+        int square = Bitboards::popLowestSquare(pieces);
+        int row = Bitboards::squareRow(square);
+        int col = Bitboards::squareCol(square);
+        if ((srcRow >= 0 && row != srcRow) || (srcCol >= 0 && col != srcCol)) {
+            continue;
+        }
+        if (isLegalCode(board.validateMove(row, col, destRow, destCol))) {
+            move = { row, col, destRow, destCol };
+            matchCount++;
+        }
+    }
+    if (matchCount != 1) {
+        return false;
+    }
+
+    // A pawn reaching the last row must promote, queen when the letter is missing
+    bool isPromotion = pieceIndex == ChessUtils::PAWN_INDEX && (destRow == 0 || destRow == ChessUtils::BOARD_SIZE - 1);
+    if (!isPromotion) {
+        return promotionIndex == ChessUtils::NO_PROMOTION;
+    }
+    move.promotionIndex = promotionIndex == ChessUtils::NO_PROMOTION ? ChessUtils::QUEEN_INDEX : promotionIndex;
+    return true;
+}
+
+//======================================================================
+uint64_t PgnReader::getGameCount() const
+{
+    return m_gameCount;
+}
+
+//======================================================================
+uint64_t PgnReader::getPlyCount() const
+{
+    return m_plyCount;
+}
+
+//======================================================================
+const std::vector<PgnError>& PgnReader::getErrors() const
+{
+    return m_errors;
+}
+
+//======================================================================
+double PgnReader::getGamesPerSecond() const
+{
+    return m_elapsedSeconds > 0 ? m_gameCount / m_elapsedSeconds : 0;
+}
+
+//======================================================================
+double PgnReader::getPliesPerSecond() const
+{
+    return m_elapsedSeconds > 0 ? m_plyCount / m_elapsedSeconds : 0;
+}
+
+//======================================================================
+size_t PgnReader::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
@@ -1,9 +1,27 @@
 #include "PieceFactory/PieceFactory.h"
+#include "Pieces/Bishop.h"
+#include "Pieces/King.h"
+#include "Pieces/Knight.h"
+#include "Pieces/Pawn.h"
+#include "Pieces/Queen.h"
+#include "Pieces/Rook.h"
+
+namespace {
+    template <typename PieceType>
+    PieceFactory::Creator makeCreator() {
+        return [](bool isWhite, int row, int col) {
+            return std::make_shared<PieceType>(isWhite, row, col);
+        };
+    }
+}
 
 //======================================================================
-// returns the factory map
+// returns the factory map, the standard pieces are in it from the first use
 std::map<char, PieceFactory::Creator>& PieceFactory::getCreators() {
-    static std::map<char, Creator> creators; // static pieces map factory
+    static std::map<char, Creator> creators = { // static pieces map factory
+        { 'K', makeCreator<King>() }, { 'Q', makeCreator<Queen>() }, { 'R', makeCreator<Rook>() },
+        { 'B', makeCreator<Bishop>() }, { 'N', makeCreator<Knight>() }, { 'P', makeCreator<Pawn>() }
+    };
     return creators;
 }
 
@@ -44,9 +44,3 @@ bool Bishop::isPathClear(int destRow, int destCol, const std::vector<std::vector
 
     return true; // move is ok
 }
-//================================================================================
-// register bishop to the factory
-bool Bishop::m_isRegistered = PieceFactory::registerPiece('B', [](bool isWhite, int x, int y) {
-    return std::make_shared<Bishop>(isWhite, x, y);
-
-});
\ No newline at end of file
@@ -35,9 +35,3 @@ bool Knight::isValidLShapeMove(int destRow, int destCol) const {
     // Knight moves in an L-shape: 2 squares in one direction and 1 square perpendicular
     return (dRow == 2 && dCol == 1) || (dRow == 1 && dCol == 2);
 }
-
-//=============================================================================
-// register the knight to the factory
-bool Knight::isRegistered = PieceFactory::registerPiece('N', [](bool isWhite, int row, int col) {
-    return std::make_shared<Knight>(isWhite, row, col);
-    });
\ No newline at end of file
@@ -111,9 +111,3 @@ bool Pawn::isValidDiagonalCapture(int destRow, int destCol,
 
     return false;
 }
-
-//=============================================================================
-// register the pawn to the factory
-bool Pawn::isRegistered = PieceFactory::registerPiece('P', [](bool isWhite, int row, int col) {
-    return std::make_shared<Pawn>(isWhite, row, col);
-    });
\ No newline at end of file
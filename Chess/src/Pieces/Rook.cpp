@@ -31,9 +31,3 @@ bool Rook::isPathClear(int destRow, int destCol, const std::vector<std::vector<s
 
     return true;// path is clear
 }
-
-//=================================================================================
-// register to the factory
-bool Rook::isRegistered = PieceFactory::registerPiece('R', [](bool isWhite, int x, int y) {
-    return std::make_shared<Rook>(isWhite, x, y);
-    });
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "Renderer/ConsoleRenderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // Board square (row, col) is drawn at frame cell (3 + 2 * row, 3 + 2 * col)
+    const int FIRST_SQUARE_CELL = 3;
+    const int SQUARE_STEP = 2;
+
+#ifdef _WIN32
+    // code page 437 box drawing characters
+    const char CORNER_TOP_LEFT = char(201), CORNER_TOP_RIGHT = char(187);
+    const char CORNER_BOTTOM_LEFT = char(200), CORNER_BOTTOM_RIGHT = char(188);
+    const char OUTER_HORIZONTAL = char(205), OUTER_VERTICAL = char(186);
+    const char GRID_TOP_LEFT = char(218), GRID_TOP_RIGHT = char(191);
+    const char GRID_BOTTOM_LEFT = char(192), GRID_BOTTOM_RIGHT = char(217);
+    const char GRID_TOP = char(194), GRID_BOTTOM = char(193);
+    const char GRID_LEFT = char(195), GRID_RIGHT = char(180);
+    const char GRID_HORIZONTAL = char(196), GRID_VERTICAL = char(179), GRID_CROSS = char(197);
+#else
+    const char CORNER_TOP_LEFT = '+', CORNER_TOP_RIGHT = '+';
+    const char CORNER_BOTTOM_LEFT = '+', CORNER_BOTTOM_RIGHT = '+';
+    const char OUTER_HORIZONTAL = '-', OUTER_VERTICAL = '|';
+    const char GRID_TOP_LEFT = '+', GRID_TOP_RIGHT = '+';
+    const char GRID_BOTTOM_LEFT = '+', GRID_BOTTOM_RIGHT = '+';
+    const char GRID_TOP = '+', GRID_BOTTOM = '+';
+    const char GRID_LEFT = '+', GRID_RIGHT = '+';
+    const char GRID_HORIZONTAL = '-', GRID_VERTICAL = '|', GRID_CROSS = '+';
+#endif
+}
+
+//======================================================================
+// c-tor, the first render clears the screen
+ConsoleRenderer::ConsoleRenderer()
+    : m_isFullRepaint(true)
+{
+#ifdef _WIN32
+    // cursor moves need the console's virtual terminal mode
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(console, &mode)) {
+        SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+}
+
+//======================================================================
+void ConsoleRenderer::render(const Board& board, const std::string& text)
+{
+    buildFrame(board, text);
+
+    m_output.clear();
+    appendChanges();
+    writeOutput();
+
+    m_previousFrame.swap(m_frame);
+    m_isFullRepaint = false;
+}
+
+//======================================================================
+void ConsoleRenderer::invalidate()
+{
+    m_isFullRepaint = true;
+}
+
+//======================================================================
+// the empty board with its labels, the same for every frame
+std::vector<std::string> ConsoleRenderer::buildBoardFrame()
+{
+    std::vector<std::string> frame(FRAME_SIZE, std::string(FRAME_SIZE, ' '));
+    const int last = FRAME_SIZE - 1;
+
+    frame[0][0] = CORNER_TOP_LEFT;     frame[0][last] = CORNER_TOP_RIGHT;
+    frame[last][0] = CORNER_BOTTOM_LEFT; frame[last][last] = CORNER_BOTTOM_RIGHT;
+    for (int i = 1; i < last; ++i) {
+        frame[0][i] = frame[last][i] = OUTER_HORIZONTAL;
+        frame[i][0] = frame[i][last] = OUTER_VERTICAL;
+    }
+
+    // grid lines on the even cells between 2 and 18, squares on the odd ones
+    for (int i = 2; i <= last - 2; i += 2) {
+        for (int j = 3; j < last - 1; j += 2) {
+            frame[i][j] = GRID_HORIZONTAL;
+            frame[j][i] = GRID_VERTICAL;
+        }
+    }
+    for (int i = 4; i < last - 2; i += 2) {
+        for (int j = 4; j < last - 2; j += 2) {
+            frame[i][j] = GRID_CROSS;
+        }
+        frame[2][i] = GRID_TOP;
+        frame[last - 2][i] = GRID_BOTTOM;
+        frame[i][2] = GRID_LEFT;
+        frame[i][last - 2] = GRID_RIGHT;
+    }
+    frame[2][2] = GRID_TOP_LEFT;         frame[2][last - 2] = GRID_TOP_RIGHT;
+    frame[last - 2][2] = GRID_BOTTOM_LEFT; frame[last - 2][last - 2] = GRID_BOTTOM_RIGHT;
+
+    // digits along the top and bottom, letters along the sides
+    for (int i = 0; i < ChessUtils::BOARD_SIZE; ++i) {
+        int cell = FIRST_SQUARE_CELL + i * SQUARE_STEP;
+        frame[1][cell] = frame[last - 1][cell] = static_cast<char>('1' + i);
+        frame[cell][1] = frame[cell][last - 1] = static_cast<char>('A' + i);
+    }
+    return frame;
+}
+
+//======================================================================
+// board frame, pieces from the board, then one line per text line
+void ConsoleRenderer::buildFrame(const Board& board, const std::string& text)
+{
+    static const std::vector<std::string> BOARD_FRAME = buildBoardFrame();
+    m_frame.assign(BOARD_FRAME.begin(), BOARD_FRAME.end());
+
+    for (int row = 0; row < ChessUtils::BOARD_SIZE; ++row) {
+        for (int col = 0; col < ChessUtils::BOARD_SIZE; ++col) {
+            std::shared_ptr<Piece> piece = board.getPieceAt(row, col);
+            m_frame[FIRST_SQUARE_CELL + row * SQUARE_STEP][FIRST_SQUARE_CELL + col * SQUARE_STEP] =
+                piece ? piece->getSymbol() : ' ';
+        }
+    }
+
+    size_t lineStart = 0;
+    while (true) {
+        size_t lineEnd = text.find('\n', lineStart);
+        m_frame.push_back(text.substr(lineStart, lineEnd - lineStart));
+        if (lineEnd == std::string::npos) {
+            break;
+        }
+        lineStart = lineEnd + 1;
+    }
+}
+
+//======================================================================
+// one cursor move and one run of cells per changed line
+void ConsoleRenderer::appendChanges()
+{
+    if (m_isFullRepaint) {
+        m_output += "\033[2J\033[3J\033[H";
+        m_previousFrame.clear();
+    }
+    else if (!m_previousFrame.empty()) {
+        // the user's input was echoed after the last line, so it no longer matches
+        m_previousFrame.back().assign(m_previousFrame.back().size() + 1, '\0');
+    }
+
+    for (size_t row = 0; row < m_frame.size(); ++row) {
+        const std::string& line = m_frame[row];
+        const std::string noLine;
+        const std::string& previous = row < m_previousFrame.size() ? m_previousFrame[row] : noLine;
+        if (line == previous) {
+            continue;
+        }
+
+        auto [lineDiff, previousDiff] = std::mismatch(line.begin(), line.end(), previous.begin(), previous.end());
+        size_t first = lineDiff - line.begin();
+        size_t last = line.size();
+        if (line.size() == previous.size()) {
+            auto [lineEnd, previousEnd] = std::mismatch(line.rbegin(), line.rend(), previous.rbegin(), previous.rend());
+            last = line.rend() - lineEnd;
+        }
+
+        appendCursorMove(row, first);
+        m_output.append(line, first, last - first);
+        if (line.size() < previous.size()) {
+            m_output += "\033[K";
+        }
+    }
+
+    // clear whatever the previous frame and the echoed input left below
+    appendCursorMove(m_frame.size(), 0);
+    m_output += "\033[J";
+    appendCursorMove(m_frame.size() - 1, m_frame.back().size());
+}
+
+//======================================================================
+// ANSI positions are 1-based
+void ConsoleRenderer::appendCursorMove(size_t row, size_t col)
+{
+    m_output += "\033[";
+    m_output += std::to_string(row + 1);
+    m_output += ';';
+    m_output += std::to_string(col + 1);
+    m_output += 'H';
+}
+
+//======================================================================
+// bypasses the line buffering of the standard streams, so the frame arrives at once
+void ConsoleRenderer::writeOutput() const
+{
+    std::cout.flush();
+#ifdef _WIN32
+    DWORD written = 0;
+    WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), m_output.data(), static_cast<DWORD>(m_output.size()), &written, nullptr);
+#else
+    size_t offset = 0;
+    while (offset < m_output.size()) {
+        ssize_t written = ::write(STDOUT_FILENO, m_output.data() + offset, m_output.size() - offset);
+        if (written <= 0) {
+            break;
+        }
+        offset += static_cast<size_t>(written);
+    }
+#endif
+}
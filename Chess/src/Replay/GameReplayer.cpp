@@ -0,0 +1,112 @@
+#include "Replay/GameReplayer.h"
+#include <chrono>
+#include <sstream>
+
+//======================================================================
+// c-tor, the recommendations don't use randomness so reports can be compared
+GameReplayer::GameReplayer(std::ostream& output, int recommendDepth)
+    : m_output(output), m_board(ChessUtils::START_BOARD), m_initialState(m_board.saveState()),
+    m_gameCount(0), m_moveCount(0), m_illegalMoveCount(0), m_movesPerSecond(0)
+{
+    if (recommendDepth > 0) {
+        m_recommender = std::make_unique<MoveRecommender>(m_board, recommendDepth);
+        m_recommender->setRandomnessEnabled(false);
+    }
+}
+
+//======================================================================
+void GameReplayer::replay(std::istream& input)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t firstMove = m_moveCount;
+
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            replayGame(line);
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_movesPerSecond = elapsed.count() > 0 ? (m_moveCount - firstMove) / elapsed.count() : 0;
+}
+
+//======================================================================
+// one code per token, "code/best move" when recommending
+void GameReplayer::replayGame(const std::string& line)
+{
+    m_board.restoreState(m_initialState);
+    m_gameCount++;
+
+    std::istringstream tokens(line);
+    std::string token;
+    bool isFirstToken = true;
+    while (tokens >> token) {
+        int code = INVALID_TOKEN;
+        if (isMoveToken(token)) {
+            std::string source = token.substr(0, 2);
+            std::string dest = token.substr(2, 2);
+            code = m_board.validateMove(source, dest);
+            if (code == ChessUtils::VALID_MOVE || code == ChessUtils::VALID_MOVE_CHECK) {
+                m_board.makeMove(source, dest);
+            }
+        }
+
+        m_moveCount++;
+        bool isLegal = code == ChessUtils::VALID_MOVE || code == ChessUtils::VALID_MOVE_CHECK;
+        if (!isLegal) {
+            m_illegalMoveCount++;
+        }
+
+        m_output << (isFirstToken ? "" : " ") << code;
+        if (isLegal && m_recommender) {
+            m_recommender->recommendMoves();
+            const auto& recommendations = m_recommender->getRecommendations();
+            m_output << '/' << (recommendations.empty() ? std::string("-") :
+                recommendations.front().getSourcePos() + recommendations.front().getDestPos());
+        }
+        isFirstToken = false;
+    }
+    m_output << '\n';
+}
+
+//======================================================================
+// same rules as Chess::getInput: two squares A-H / 1-8, not the same square
+bool GameReplayer::isMoveToken(const std::string& token)
+{
+    if (token.size() != 4) {
+        return false;
+    }
+    for (int i = 0; i < 4; i += 2) {
+        char row = static_cast<char>(toupper(static_cast<unsigned char>(token[i])));
+        if (row < 'A' || row > 'H' || token[i + 1] < '1' || token[i + 1] > '8') {
+            return false;
+        }
+    }
+    return toupper(static_cast<unsigned char>(token[0])) != toupper(static_cast<unsigned char>(token[2])) ||
+        token[1] != token[3];
+}
+
+//======================================================================
+uint64_t GameReplayer::getGameCount() const
+{
+    return m_gameCount;
+}
+
+//======================================================================
+uint64_t GameReplayer::getMoveCount() const
+{
+    return m_moveCount;
+}
+
+//======================================================================
+uint64_t GameReplayer::getIllegalMoveCount() const
+{
+    return m_illegalMoveCount;
+}
+
+//======================================================================
+double GameReplayer::getMovesPerSecond() const
+{
+    return m_movesPerSecond;
+}
@@ -0,0 +1,80 @@
+#include "Search/SearchStats.h"
+#include <iomanip>
+
+//======================================================================
+void SearchStats::merge(const SearchStats& other)
+{
+    nodes += other.nodes;
+    leafEvaluations += other.leafEvaluations;
+    validateMoveCalls += other.validateMoveCalls;
+    expandedNodes += other.expandedNodes;
+    searchedChildren += other.searchedChildren;
+    transpositionProbes += other.transpositionProbes;
+    transpositionHits += other.transpositionHits;
+    for (size_t ply = 0; ply < cutoffsPerPly.size(); ply++) {
+        cutoffsPerPly[ply] += other.cutoffsPerPly[ply];
+    }
+}
+
+//======================================================================
+void SearchStats::clear()
+{
+    *this = SearchStats();
+}
+
+//======================================================================
+uint64_t SearchStats::getCutoffs() const
+{
+    uint64_t cutoffs = 0;
+    for (uint64_t plyCutoffs : cutoffsPerPly) {
+        cutoffs += plyCutoffs;
+    }
+    return cutoffs;
+}
+
+//======================================================================
+double SearchStats::getBranchingFactor() const
+{
+    return expandedNodes > 0 ? static_cast<double>(searchedChildren) / expandedNodes : 0;
+}
+
+//======================================================================
+double SearchStats::getNodesPerSecond() const
+{
+    return elapsedUs > 0 ? nodes * 1e6 / elapsedUs : 0;
+}
+
+//======================================================================
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats)
+{
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(1) << "nodes " << stats.nodes
+        << " | evaluations " << stats.leafEvaluations
+        << " | validateMove " << stats.validateMoveCalls
+        << " | branching " << std::setprecision(2) << stats.getBranchingFactor()
+        << " | cutoffs " << stats.getCutoffs();
+    if (stats.transpositionProbes > 0) {
+        os << " | tt hits " << stats.transpositionHits << "/" << stats.transpositionProbes;
+    }
+    os << " | time " << std::setprecision(1) << stats.elapsedUs / 1000.0 << " ms"
+        << " | nps " << std::setprecision(0) << stats.getNodesPerSecond() << std::endl;
+
+    bool hasCutoffs = false;
+    for (size_t ply = 0; ply < stats.cutoffsPerPly.size(); ply++) {
+        if (stats.cutoffsPerPly[ply] > 0) {
+            os << (hasCutoffs ? " " : "cutoffs by ply: ") << ply << ":" << stats.cutoffsPerPly[ply];
+            hasCutoffs = true;
+        }
+    }
+    if (hasCutoffs) {
+        os << std::endl;
+    }
+    if (Allocations::isCompiledIn()) {
+        printAllocations(os, stats.allocations, stats.nodes);
+    }
+    if (stats.hardware.hasAny()) {
+        printHardwareCounts(os, stats.hardware, stats.nodes);
+    }
+    os.flags(flags);
+    return os;
+}
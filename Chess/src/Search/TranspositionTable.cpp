@@ -0,0 +1,121 @@
+#include "Search/TranspositionTable.h"
+#include "Board/Bitboard.h"
+
+namespace {
+    // data layout: score (32 bits), source square + 1 (7), destination square (6),
+    // depth (8), bound (2), promotion piece + 1 (3)
+    const int SOURCE_SHIFT = 32;
+    const int DEST_SHIFT = 39;
+    const int DEPTH_SHIFT = 45;
+    const int BOUND_SHIFT = 53;
+    const int PROMOTION_SHIFT = 55;
+}
+
+//======================================================================
+// c-tor, allocates the table
+TranspositionTable::TranspositionTable(size_t sizeMb)
+    : m_mask(0)
+{
+    resize(sizeMb);
+}
+
+//======================================================================
+bool TranspositionTable::probe(uint64_t key, TranspositionEntry& entry) const
+{
+    const Slot& slot = m_slots[key & m_mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t checkedKey = slot.checkedKey.load(std::memory_order_relaxed);
+
+    if ((checkedKey ^ data) != key) {
+        return false;
+    }
+    entry = unpack(data);
+    return true;
+}
+
+//======================================================================
+void TranspositionTable::store(uint64_t key, const TranspositionEntry& entry)
+{
+    Slot& slot = m_slots[key & m_mask];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    uint64_t oldKey = slot.checkedKey.load(std::memory_order_relaxed) ^ oldData;
+    if (oldKey != key && static_cast<int>((oldData >> DEPTH_SHIFT) & 0xFF) > entry.depth) {
+        return;
+    }
+
+    uint64_t data = pack(entry);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.checkedKey.store(key ^ data, std::memory_order_relaxed);
+}
+
+//======================================================================
+// the entry count is the largest power of two that fits in the given size
+void TranspositionTable::resize(size_t sizeMb)
+{
+    size_t bytes = sizeMb * 1024 * 1024;
+    size_t slotCount = 1;
+    while (slotCount * 2 * sizeof(Slot) <= bytes) {
+        slotCount *= 2;
+    }
+
+    m_slots = std::make_unique<Slot[]>(slotCount);
+    m_mask = slotCount - 1;
+    clear();
+}
+
+//======================================================================
+// empties every slot, not safe while a search runs
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i <= m_mask; i++) {
+        m_slots[i].checkedKey.store(1, std::memory_order_relaxed);
+        m_slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+//======================================================================
+size_t TranspositionTable::getEntryCount() const
+{
+    return m_mask + 1;
+}
+
+//======================================================================
+uint64_t TranspositionTable::pack(const TranspositionEntry& entry)
+{
+    uint64_t source = 0;
+    uint64_t dest = 0;
+    uint64_t promotion = 0;
+    if (entry.move.srcRow >= 0) {
+        source = Bitboards::squareIndex(entry.move.srcRow, entry.move.srcCol) + 1;
+        dest = Bitboards::squareIndex(entry.move.destRow, entry.move.destCol);
+        promotion = entry.move.promotionIndex + 1;
+    }
+
+    return static_cast<uint32_t>(entry.score) |
+        source << SOURCE_SHIFT |
+        dest << DEST_SHIFT |
+        static_cast<uint64_t>(entry.depth & 0xFF) << DEPTH_SHIFT |
+        static_cast<uint64_t>(entry.bound) << BOUND_SHIFT |
+        promotion << PROMOTION_SHIFT;
+}
+
+//======================================================================
+TranspositionEntry TranspositionTable::unpack(uint64_t data)
+{
+    TranspositionEntry entry;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+    entry.bound = static_cast<ScoreBound>((data >> BOUND_SHIFT) & 0x3);
+
+    int source = static_cast<int>((data >> SOURCE_SHIFT) & 0x7F) - 1;
+    int dest = static_cast<int>((data >> DEST_SHIFT) & 0x3F);
+    if (source < 0) {
+        entry.move = { -1, -1, -1, -1 };
+    }
+    else {
+        entry.move = { Bitboards::squareRow(source), Bitboards::squareCol(source),
+            Bitboards::squareRow(dest), Bitboards::squareCol(dest),
+            static_cast<int>((data >> PROMOTION_SHIFT) & 0x7) - 1 };
+    }
+    return entry;
+}
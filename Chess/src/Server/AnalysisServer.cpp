@@ -0,0 +1,625 @@
+#include "Server/AnalysisServer.h"
+#include "Board/MoveNotation.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <fcntl.h>
+#include <iomanip>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    const char* UNIX_PREFIX = "unix:";
+    const char* TCP_PREFIX = "tcp:";
+
+    bool isLimit(const std::string& token) {
+        return token == "depth" || token == "nodes" || token == "movetime" || token == "infinite";
+    }
+
+    double getMs(std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    bool setNonBlocking(int descriptor) {
+        int flags = ::fcntl(descriptor, F_GETFL, 0);
+        return flags >= 0 && ::fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    bool isRetry(int error) {
+        return error == EINTR || error == EAGAIN || error == EWOULDBLOCK;
+    }
+
+    // Depth, score, nodes and time of a search result, as in the info and bestmove lines
+    std::string formatResult(const SearchInfo& info) {
+        return "depth " + std::to_string(info.depth) + " score " + std::to_string(info.score) + " nodes " +
+            std::to_string(info.nodes) + " time " + std::to_string(info.elapsedMs);
+    }
+}
+
+//======================================================================
+AnalysisServer::Session::Session(int socket, int wakeDescriptor)
+    : socket(socket), wakeDescriptor(wakeDescriptor)
+{
+}
+
+//======================================================================
+AnalysisServer::Session::~Session()
+{
+    ::close(socket);
+}
+
+//======================================================================
+// the whole line under the lock, so lines of concurrent searches don't interleave;
+// wakes the poll thread when it has to watch for POLLOUT or drop the session
+void AnalysisServer::Session::send(const std::string& line)
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (isClosed) {
+            return;
+        }
+        bool wasIdle = output.empty();
+        output += line;
+        output += '\n';
+        if (output.size() > MAX_OUTPUT_SIZE) {
+            isClosed = true;
+            output.clear();
+        }
+        else if (wasIdle) {
+            writeOutput();
+        }
+        if (!isClosed && (!wasIdle || output.empty())) {
+            return;
+        }
+    }
+    char wake = 0;
+    ssize_t ignored = ::write(wakeDescriptor, &wake, 1);
+    (void)ignored;
+}
+
+//======================================================================
+bool AnalysisServer::Session::flush()
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!isClosed) {
+        writeOutput();
+    }
+    return !isClosed;
+}
+
+//======================================================================
+bool AnalysisServer::Session::hasOutput()
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return !output.empty();
+}
+
+//======================================================================
+// stops at a full socket buffer, the rest stays queued
+void AnalysisServer::Session::writeOutput()
+{
+    size_t sent = 0;
+    while (sent < output.size()) {
+        ssize_t count = ::send(socket, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+        if (count > 0) {
+            sent += static_cast<size_t>(count);
+        }
+        else if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else {
+            if (count == 0 || !isRetry(errno)) {
+                isClosed = true;
+                sent = output.size();
+            }
+            break;
+        }
+    }
+    output.erase(0, sent);
+}
+
+//======================================================================
+void AnalysisServer::Session::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(requestMutex);
+    for (auto& entry : requests) {
+        entry.second->stopRequested = true;
+    }
+}
+
+//======================================================================
+// there is one recommender per pool thread, so a search always finds an idle one
+AnalysisServer::RecommenderLease::RecommenderLease(AnalysisServer& server)
+    : m_server(server)
+{
+    std::lock_guard<std::mutex> lock(m_server.m_recommenderMutex);
+    m_recommender = m_server.m_idleRecommenders.back();
+    m_server.m_idleRecommenders.pop_back();
+}
+
+//======================================================================
+AnalysisServer::RecommenderLease::~RecommenderLease()
+{
+    std::lock_guard<std::mutex> lock(m_server.m_recommenderMutex);
+    m_server.m_idleRecommenders.push_back(m_recommender);
+}
+
+//======================================================================
+MoveRecommender& AnalysisServer::RecommenderLease::get() const
+{
+    return *m_recommender;
+}
+
+//======================================================================
+// c-tor, one recommender per pool thread, all on the shared table
+AnalysisServer::AnalysisServer(std::ostream& log, size_t threadCount, size_t hashMb)
+    : m_log(log), m_listenSocket(-1), m_wakePipe{ -1, -1 }, m_isStopping(false),
+    m_transpositionTable(std::make_shared<TranspositionTable>(hashMb)),
+    m_referenceBoard(ChessUtils::START_BOARD), m_queuedCount(0), m_runningCount(0), m_completedCount(0),
+    m_cancelledCount(0), m_totalWaitMs(0), m_totalLatencyMs(0), m_maxLatencyMs(0), m_pool(threadCount)
+{
+    if (::pipe(m_wakePipe) != 0 || !setNonBlocking(m_wakePipe[0]) || !setNonBlocking(m_wakePipe[1])) {
+        throw std::runtime_error("Error: can't create the server's wake-up pipe");
+    }
+    for (size_t i = 0; i < m_pool.getThreadCount(); i++) {
+        auto recommender = std::make_unique<MoveRecommender>(m_referenceBoard, 1);
+        recommender->setRandomnessEnabled(false);
+        recommender->setTranspositionTable(m_transpositionTable);
+        m_idleRecommenders.push_back(recommender.get());
+        m_recommenders.push_back(std::move(recommender));
+    }
+}
+
+//======================================================================
+// d-tor, stops every search and lets them finish before the wake-up pipe
+// their sessions write to is closed
+AnalysisServer::~AnalysisServer()
+{
+    for (const auto& session : m_sessions) {
+        session->cancelAll();
+    }
+    try {
+        m_pool.wait();
+    }
+    catch (const std::exception& e) {
+        m_log << "search failed: " << e.what() << std::endl;
+    }
+    closeSocket();
+    ::close(m_wakePipe[0]);
+    ::close(m_wakePipe[1]);
+}
+
+//======================================================================
+void AnalysisServer::setNetwork(std::shared_ptr<const NnueNetwork> network)
+{
+    m_network = std::move(network);
+}
+
+//======================================================================
+void AnalysisServer::setTablebases(std::shared_ptr<const Tablebases> tablebases)
+{
+    for (const auto& recommender : m_recommenders) {
+        recommender->setTablebases(tablebases);
+    }
+}
+
+//======================================================================
+// unix:<path> replaces a stale socket file, tcp:<port> binds the loopback address only
+void AnalysisServer::listen(const std::string& address)
+{
+    closeSocket();
+    if (address.rfind(UNIX_PREFIX, 0) == 0) {
+        std::string path = address.substr(std::string(UNIX_PREFIX).size());
+        sockaddr_un socketAddress{};
+        socketAddress.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(socketAddress.sun_path)) {
+            throw std::runtime_error("Error: bad socket path " + path);
+        }
+        std::copy(path.begin(), path.end(), socketAddress.sun_path);
+
+        struct stat status;
+        if (::stat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+            ::unlink(path.c_str());
+        }
+        m_listenSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listenSocket >= 0 &&
+            ::bind(m_listenSocket, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) == 0) {
+            m_socketPath = path;
+        }
+    }
+    else if (address.rfind(TCP_PREFIX, 0) == 0) {
+        std::string port = address.substr(std::string(TCP_PREFIX).size());
+        if (port.empty() || port.size() > 5 ||
+            !std::all_of(port.begin(), port.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }) ||
+            std::stoi(port) > UINT16_MAX) {
+            throw std::runtime_error("Error: bad port " + port);
+        }
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(static_cast<uint16_t>(std::stoi(port)));
+        socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        m_listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+        int isReused = 1;
+        if (m_listenSocket >= 0) {
+            ::setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &isReused, sizeof(isReused));
+        }
+        if (m_listenSocket >= 0 &&
+            ::bind(m_listenSocket, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0) {
+            closeSocket();
+        }
+    }
+    else {
+        throw std::runtime_error("Error: server address " + address + " needs to be unix:<path> or tcp:<port>");
+    }
+
+    bool isBound = m_listenSocket >= 0 && (address.rfind(TCP_PREFIX, 0) == 0 || !m_socketPath.empty());
+    if (!isBound || ::listen(m_listenSocket, SOMAXCONN) != 0) {
+        closeSocket();
+        throw std::runtime_error("Error: can't listen on " + address);
+    }
+    m_log << "listening on " << address << ", " << m_pool.getThreadCount() << " search threads" << std::endl;
+}
+
+//======================================================================
+// polls the listening socket, the wake-up pipe and every session, the
+// sessions with queued output for POLLOUT as well
+void AnalysisServer::run()
+{
+    std::vector<pollfd> descriptors;
+    while (!m_isStopping) {
+        descriptors.assign({ { m_listenSocket, POLLIN, 0 }, { m_wakePipe[0], POLLIN, 0 } });
+        for (const auto& session : m_sessions) {
+            short events = session->hasOutput() ? POLLIN | POLLOUT : POLLIN;
+            descriptors.push_back({ session->socket, events, 0 });
+        }
+        if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Error: polling the server sockets failed");
+        }
+        if (descriptors[1].revents != 0) {
+            char wake[64];
+            while (::read(m_wakePipe[0], wake, sizeof(wake)) > 0) {
+            }
+            if (m_isStopping) {
+                break;
+            }
+        }
+
+        // From the back, so closed sessions can be removed in place
+        for (size_t i = m_sessions.size(); i-- > 0;) {
+            const std::shared_ptr<Session>& session = m_sessions[i];
+            short events = descriptors[i + 2].revents;
+            bool isOpen = !session->isClosed;
+            if (isOpen && (events & POLLOUT)) {
+                isOpen = session->flush();
+            }
+            if (isOpen && (events & ~POLLOUT) != 0) {
+                isOpen = readSession(session);
+            }
+            if (!isOpen) {
+                closeSession(i);
+            }
+        }
+        if (descriptors[0].revents & POLLIN) {
+            acceptSession();
+        }
+    }
+
+    for (const auto& session : m_sessions) {
+        session->cancelAll();
+    }
+    m_sessions.clear();
+}
+
+//======================================================================
+void AnalysisServer::stop()
+{
+    m_isStopping = true;
+    char wake = 0;
+    ssize_t ignored = ::write(m_wakePipe[1], &wake, 1);
+    (void)ignored;
+}
+
+//======================================================================
+size_t AnalysisServer::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
+
+//======================================================================
+void AnalysisServer::acceptSession()
+{
+    int socket = ::accept(m_listenSocket, nullptr, nullptr);
+    if (socket < 0) {
+        return;
+    }
+    if (!setNonBlocking(socket)) {
+        ::close(socket);
+        return;
+    }
+    m_sessions.push_back(std::make_shared<Session>(socket, m_wakePipe[1]));
+    m_log << "session opened, " << m_sessions.size() << " open" << std::endl;
+}
+
+//======================================================================
+// sends what the socket takes of the last replies, then stops the session's searches
+void AnalysisServer::closeSession(size_t index)
+{
+    const std::shared_ptr<Session>& session = m_sessions[index];
+    session->flush();
+    session->isClosed = true;
+    session->cancelAll();
+    m_sessions.erase(m_sessions.begin() + index);
+    m_log << "session closed, " << m_sessions.size() << " open" << std::endl;
+}
+
+//======================================================================
+// handles the complete lines received so far, false when the session ends
+bool AnalysisServer::readSession(const std::shared_ptr<Session>& session)
+{
+    char buffer[4096];
+    ssize_t count = ::recv(session->socket, buffer, sizeof(buffer), 0);
+    if (count < 0 && isRetry(errno)) {
+        return true;
+    }
+    if (count <= 0) {
+        return false;
+    }
+
+    session->input.append(buffer, static_cast<size_t>(count));
+    size_t end;
+    while ((end = session->input.find('\n')) != std::string::npos) {
+        std::string line = session->input.substr(0, end);
+        session->input.erase(0, end + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line == "quit") {
+            return false;
+        }
+        handleLine(session, line);
+    }
+
+    if (session->input.size() > MAX_LINE_LENGTH) {
+        session->send("error - line too long");
+        return false;
+    }
+    return !session->isClosed;
+}
+
+//======================================================================
+void AnalysisServer::handleLine(const std::shared_ptr<Session>& session, const std::string& line)
+{
+    std::istringstream arguments(line);
+    std::string command;
+    if (!(arguments >> command)) {
+        return;
+    }
+
+    if (command == "analyze") {
+        handleAnalyze(session, arguments);
+    }
+    else if (command == "cancel") {
+        handleCancel(*session, arguments);
+    }
+    else if (command == "stats") {
+        session->send(formatStats());
+    }
+    else {
+        session->send("error - unknown command " + command);
+    }
+}
+
+//======================================================================
+// analyze <id> startpos | <fen> [moves ...] [limits], queued on the pool
+void AnalysisServer::handleAnalyze(const std::shared_ptr<Session>& session, std::istringstream& arguments)
+{
+    auto request = std::make_shared<Request>();
+    request->receivedAt = std::chrono::steady_clock::now();
+    if (!(arguments >> request->id)) {
+        session->send("error - analyze needs an id");
+        return;
+    }
+    const std::string& id = request->id;
+
+    // FEN fields up to the moves or the first limit
+    std::string token;
+    std::string fen;
+    bool hasToken = static_cast<bool>(arguments >> token);
+    if (hasToken && token == "startpos") {
+        fen = ChessUtils::START_FEN;
+        hasToken = static_cast<bool>(arguments >> token);
+    }
+    for (; hasToken && token != "moves" && !isLimit(token); hasToken = static_cast<bool>(arguments >> token)) {
+        fen += token + " ";
+    }
+    try {
+        request->board = std::make_unique<Board>(Fen::parse(fen));
+    }
+    catch (const std::runtime_error& e) {
+        session->send("error " + id + " " + e.what());
+        return;
+    }
+    request->board->setNetwork(m_network);
+
+    // Moves are checked against the legal ones
+    std::vector<BoardMove> legalMoves;
+    if (hasToken && token == "moves") {
+        for (hasToken = static_cast<bool>(arguments >> token); hasToken && !isLimit(token);
+            hasToken = static_cast<bool>(arguments >> token)) {
+            BoardMove move;
+            legalMoves.clear();
+            request->board->generateLegalMoves(legalMoves);
+            if (!MoveNotation::parse(token, move) || std::find(legalMoves.begin(), legalMoves.end(), move) ==
+                legalMoves.end()) {
+                session->send("error " + id + " illegal move " + token);
+                return;
+            }
+            request->board->makeMove(move);
+        }
+    }
+
+    SearchLimits& limits = request->limits;
+    for (; hasToken; hasToken = static_cast<bool>(arguments >> token)) {
+        int64_t value = 0;
+        if (token == "infinite") {
+            limits.isInfinite = true;
+        }
+        else if (!isLimit(token) || !(arguments >> value) || value < 0 ||
+            (token == "depth" && value > ChessUtils::MAX_SEARCH_PLY)) {
+            session->send("error " + id + " bad limit " + token);
+            return;
+        }
+        else if (token == "depth") {
+            limits.depth = static_cast<int>(value);
+        }
+        else if (token == "nodes") {
+            limits.nodes = static_cast<uint64_t>(value);
+        }
+        else {
+            limits.moveTimeMs = value;
+        }
+    }
+    if (!limits.isInfinite && limits.depth == 0 && limits.nodes == 0 && limits.moveTimeMs == 0) {
+        limits.moveTimeMs = DEFAULT_MOVE_TIME_MS;
+    }
+    limits.stopRequested = &request->stopRequested;
+    request->session = session;
+
+    bool isNew;
+    {
+        std::lock_guard<std::mutex> lock(session->requestMutex);
+        isNew = session->requests.emplace(id, request).second;
+    }
+    if (!isNew) {
+        session->send("error " + id + " request id already in use");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_metricsMutex);
+        m_queuedCount++;
+    }
+    m_pool.submit([this, request]() { runRequest(request); });
+}
+
+//======================================================================
+void AnalysisServer::handleCancel(Session& session, std::istringstream& arguments)
+{
+    std::string id;
+    arguments >> id;
+    std::shared_ptr<Request> request;
+    {
+        std::lock_guard<std::mutex> lock(session.requestMutex);
+        auto found = session.requests.find(id);
+        if (found != session.requests.end()) {
+            request = found->second;
+        }
+    }
+
+    if (!request) {
+        session.send("error " + (id.empty() ? std::string("-") : id) + " no such request");
+        return;
+    }
+    request->stopRequested = true;
+}
+
+//======================================================================
+// means over the finished requests
+std::string AnalysisServer::formatStats()
+{
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    size_t finishedCount = std::max<size_t>(1, m_completedCount + m_cancelledCount);
+    std::ostringstream stats;
+    stats << std::fixed << std::setprecision(1) << "stats sessions " << m_sessions.size() << " queued "
+        << m_queuedCount << " running " << m_runningCount << " completed " << m_completedCount << " cancelled "
+        << m_cancelledCount << " wait_ms " << m_totalWaitMs / finishedCount << " latency_ms "
+        << m_totalLatencyMs / finishedCount << " max_latency_ms " << m_maxLatencyMs;
+    return stats.str();
+}
+
+//======================================================================
+// searches on an idle recommender, streaming every finished depth
+void AnalysisServer::runRequest(const std::shared_ptr<Request>& request)
+{
+    request->startedAt = std::chrono::steady_clock::now();
+    Session& session = *request->session;
+    bool isCancelled = request->stopRequested || session.isClosed;
+    {
+        std::lock_guard<std::mutex> lock(m_metricsMutex);
+        m_queuedCount--;
+        if (!isCancelled) {
+            m_runningCount++;
+        }
+    }
+    // The id is freed before the last line, so the client may reuse it as soon as it reads that
+    if (isCancelled) {
+        finishRequest(*request, false);
+        session.send("cancelled " + request->id);
+        return;
+    }
+
+    std::string reply;
+    try {
+        RecommenderLease lease(*this);
+        SearchInfo result = lease.get().search(*request->board, request->limits,
+            [&request, &session](const SearchInfo& info) {
+                std::string line = "info " + request->id + " " + formatResult(info) + " pv";
+                for (const BoardMove& move : info.principalVariation) {
+                    line += " " + MoveNotation::format(move);
+                }
+                session.send(line);
+            });
+        reply = "bestmove " + request->id + " " + (result.principalVariation.empty() ? std::string("0000") :
+            MoveNotation::format(result.principalVariation.front())) + " " + formatResult(result);
+    }
+    catch (const std::exception& e) {
+        reply = "error " + request->id + " search failed: " + e.what();
+    }
+    finishRequest(*request, true);
+    session.send(reply);
+}
+
+//======================================================================
+// frees the request's id and adds it to the metrics
+void AnalysisServer::finishRequest(const Request& request, bool wasStarted)
+{
+    {
+        std::lock_guard<std::mutex> lock(request.session->requestMutex);
+        auto found = request.session->requests.find(request.id);
+        if (found != request.session->requests.end() && found->second.get() == &request) {
+            request.session->requests.erase(found);
+        }
+    }
+
+    double latencyMs = getMs(std::chrono::steady_clock::now() - request.receivedAt);
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    if (wasStarted) {
+        m_runningCount--;
+    }
+    (request.stopRequested ? m_cancelledCount : m_completedCount)++;
+    m_totalWaitMs += getMs(request.startedAt - request.receivedAt);
+    m_totalLatencyMs += latencyMs;
+    m_maxLatencyMs = std::max(m_maxLatencyMs, latencyMs);
+}
+
+//======================================================================
+void AnalysisServer::closeSocket()
+{
+    if (m_listenSocket >= 0) {
+        ::close(m_listenSocket);
+        m_listenSocket = -1;
+    }
+    if (!m_socketPath.empty()) {
+        ::unlink(m_socketPath.c_str());
+        m_socketPath.clear();
+    }
+}
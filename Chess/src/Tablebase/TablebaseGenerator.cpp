@@ -0,0 +1,446 @@
+#include "Tablebase/TablebaseGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    // Positions not decided yet, only while a table is built
+    const uint8_t UNKNOWN = Tablebase::ILLEGAL - 1;
+
+    // Per position flags while a table is built
+    const uint8_t HAS_EXIT = 1;
+    const uint8_t IS_CANDIDATE = 2;
+
+    constexpr int PROMOTION_PIECES[4] = {
+        ChessUtils::QUEEN_INDEX, ChessUtils::ROOK_INDEX, ChessUtils::BISHOP_INDEX, ChessUtils::KNIGHT_INDEX
+    };
+
+    // Passes read values other threads may be writing, the decisions don't depend on which they see
+    uint8_t loadValue(const uint8_t& value) {
+        return std::atomic_ref<uint8_t>(const_cast<uint8_t&>(value)).load(std::memory_order_relaxed);
+    }
+
+    void storeValue(uint8_t& value, uint8_t newValue) {
+        std::atomic_ref<uint8_t>(value).store(newValue, std::memory_order_relaxed);
+    }
+
+    // The value pass n decides
+    uint8_t getDecidedValue(int distance) {
+        return static_cast<uint8_t>(distance % 2 == 1 ? distance : Tablebase::LOSS_BASE + distance);
+    }
+
+    void removeMan(TablebasePosition& position, int slot) {
+        std::copy(position.men.begin() + slot + 1, position.men.begin() + position.count, position.men.begin() + slot);
+        position.count--;
+    }
+
+    Bitboard getOccupancy(const TablebasePosition& position) {
+        Bitboard occupancy = 0;
+        for (int slot = 0; slot < position.count; slot++) {
+            occupancy |= Bitboards::squareBit(position.men[slot].square);
+        }
+        return occupancy;
+    }
+
+    Bitboard getAttacks(const TablebaseMan& man, Bitboard occupancy) {
+        switch (man.pieceIndex) {
+        case ChessUtils::KING_INDEX:   return Bitboards::KING_ATTACKS[man.square];
+        case ChessUtils::KNIGHT_INDEX: return Bitboards::KNIGHT_ATTACKS[man.square];
+        case ChessUtils::BISHOP_INDEX: return Bitboards::bishopAttacks(man.square, occupancy);
+        case ChessUtils::ROOK_INDEX:   return Bitboards::rookAttacks(man.square, occupancy);
+        case ChessUtils::QUEEN_INDEX:
+            return Bitboards::rookAttacks(man.square, occupancy) | Bitboards::bishopAttacks(man.square, occupancy);
+        default: return Bitboards::PAWN_ATTACKS[Bitboards::colorIndex(man.isWhite)][man.square];
+        }
+    }
+
+    // Little endian, whatever the host order
+    void writeHeader(std::ofstream& file, const char (&magic)[4], uint64_t positionCount) {
+        char header[Tablebase::HEADER_SIZE] = {};
+        std::copy(magic, magic + 4, header);
+        for (int i = 0; i < 4; i++) {
+            header[4 + i] = static_cast<char>(Tablebase::FILE_VERSION >> (8 * i));
+        }
+        for (int i = 0; i < 8; i++) {
+            header[8 + i] = static_cast<char>(positionCount >> (8 * i));
+        }
+        file.write(header, sizeof(header));
+    }
+}
+
+//======================================================================
+TablebaseGenerator::TablebaseGenerator(std::ostream& log, size_t threadCount)
+    : m_log(log), m_pool(threadCount)
+{
+}
+
+//======================================================================
+void TablebaseGenerator::generate(const std::string& signature, const std::string& directory)
+{
+    build(TablebaseLayout(signature), directory);
+}
+
+//======================================================================
+// the tables reached by captures and promotions first, then this one pass by pass
+const TablebaseGenerator::Table& TablebaseGenerator::build(const TablebaseLayout& layout, const std::string& directory)
+{
+    auto found = m_tables.find(layout.getMaterialKey());
+    if (found != m_tables.end()) {
+        return *found->second;
+    }
+
+    TablebasePosition men;
+    layout.getPosition(0, men);
+    int maxChildDistance = 0;
+    auto buildChild = [&](TablebasePosition child) {
+        // Two kings alone are a draw, there is no table for them
+        if (child.count >= Tablebase::MIN_MEN) {
+            TablebaseLayout::normalize(child);
+            maxChildDistance = std::max(maxChildDistance, build(TablebaseLayout(child), directory).maxDistance);
+        }
+    };
+    for (int slot = 0; slot < men.count; slot++) {
+        if (men.men[slot].pieceIndex == ChessUtils::KING_INDEX) {
+            continue;
+        }
+        TablebasePosition captured = men;
+        removeMan(captured, slot);
+        buildChild(captured);
+        if (men.men[slot].pieceIndex == ChessUtils::PAWN_INDEX) {
+            for (int promotion : PROMOTION_PIECES) {
+                TablebasePosition promoted = men;
+                promoted.men[slot].pieceIndex = promotion;
+                buildChild(promoted);
+            }
+        }
+    }
+
+    auto table = std::make_unique<Table>(Table{ layout, std::vector<uint8_t>(layout.getPositionCount()) });
+    std::vector<uint8_t>& values = table->values;
+    std::vector<uint8_t> flags(values.size());
+    m_pool.parallelFor(values.size(), [this, &table, &values, &flags](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; index++) {
+            bool hasExit = false;
+            values[index] = initialValue(*table, index, hasExit);
+            flags[index] = hasExit ? HAS_EXIT : 0;
+        }
+    });
+    markPredecessors(*table, getDecidedValue(0), flags);
+
+    // Pass n can only decide positions when pass n - 1 did or a smaller table has distance n - 1
+    int distance = 1;
+    for (;; distance++) {
+        if (distance > Tablebase::MAX_DISTANCE) {
+            throw std::runtime_error("Error: tablebase " + layout.getName() + " has mates beyond the file format");
+        }
+        bool isExitOpen = distance <= maxChildDistance + 1;
+        std::atomic<size_t> decidedCount(0);
+        m_pool.parallelFor(values.size(), [&, distance, isExitOpen](size_t begin, size_t end) {
+            size_t decided = 0;
+            for (size_t index = begin; index < end; index++) {
+                bool isCandidate = (flags[index] & IS_CANDIDATE) || (isExitOpen && (flags[index] & HAS_EXIT));
+                flags[index] &= ~IS_CANDIDATE;
+                if (isCandidate && loadValue(values[index]) == UNKNOWN) {
+                    uint8_t value = passValue(*table, index, distance);
+                    if (value != UNKNOWN) {
+                        storeValue(values[index], value);
+                        decided++;
+                    }
+                }
+            }
+            decidedCount += decided;
+        });
+
+        if (decidedCount > 0) {
+            table->maxDistance = distance;
+            markPredecessors(*table, getDecidedValue(distance), flags);
+        }
+        else if (distance > maxChildDistance) {
+            break;
+        }
+    }
+    std::replace(values.begin(), values.end(), UNKNOWN, Tablebase::DRAW);
+
+    m_log << layout.getName() << ": " << values.size() << " positions, longest mate " << table->maxDistance
+        << " plies, " << distance << " passes" << std::endl;
+    writeTable(*table, directory);
+    return *(m_tables[layout.getMaterialKey()] = std::move(table));
+}
+
+//======================================================================
+// illegal positions, mates and stalemates, everything else is still open; notes
+// whether a capture or promotion leaves the table
+uint8_t TablebaseGenerator::initialValue(const Table& table, size_t index, bool& hasExit) const
+{
+    TablebasePosition position;
+    table.layout.getPosition(index, position);
+    if (!isValid(position) || table.layout.getIndex(position) != index) {
+        return Tablebase::ILLEGAL;
+    }
+
+    bool hasMove = false;
+    forEachMove(position, [&hasMove, &hasExit](const TablebasePosition&, bool isSameMaterial) {
+        hasMove = true;
+        hasExit |= !isSameMaterial;
+        return true;
+    });
+    if (hasMove) {
+        return UNKNOWN;
+    }
+    return isKingAttacked(position, position.isWhiteTurn) ? Tablebase::LOSS_BASE : Tablebase::DRAW;
+}
+
+//======================================================================
+// odd passes find wins (a move to a loss in distance - 1), even passes find
+// losses (every move to a win of at most distance - 1)
+uint8_t TablebaseGenerator::passValue(const Table& table, size_t index, int distance) const
+{
+    TablebasePosition position;
+    table.layout.getPosition(index, position);
+
+    if (distance % 2 == 1) {
+        uint8_t target = static_cast<uint8_t>(Tablebase::LOSS_BASE + distance - 1);
+        bool isWin = false;
+        forEachMove(position, [&](const TablebasePosition& child, bool isSameMaterial) {
+            isWin = lookup(table, child, isSameMaterial) == target;
+            return !isWin;
+        });
+        return isWin ? static_cast<uint8_t>(distance) : UNKNOWN;
+    }
+
+    bool isLoss = true;
+    forEachMove(position, [&](const TablebasePosition& child, bool isSameMaterial) {
+        uint8_t value = lookup(table, child, isSameMaterial);
+        isLoss = Tablebase::isWin(value) && value < distance;
+        return isLoss;
+    });
+    return isLoss ? static_cast<uint8_t>(Tablebase::LOSS_BASE + distance) : UNKNOWN;
+}
+
+//======================================================================
+// a child of the same material is in the table being built, others in a finished one
+uint8_t TablebaseGenerator::lookup(const Table& table, const TablebasePosition& child, bool isSameMaterial) const
+{
+    if (isSameMaterial) {
+        return loadValue(table.values[table.layout.getIndex(child)]);
+    }
+    if (child.count < Tablebase::MIN_MEN) {
+        return Tablebase::DRAW;
+    }
+
+    TablebasePosition normalized = child;
+    TablebaseLayout::normalize(normalized);
+    const Table& childTable = *m_tables.at(TablebaseLayout::getMaterialKey(normalized));
+    return childTable.values[childTable.layout.getIndex(normalized)];
+}
+
+//======================================================================
+// flags the positions that can reach the ones just decided, for the next pass
+void TablebaseGenerator::markPredecessors(const Table& table, uint8_t decidedValue, std::vector<uint8_t>& flags)
+{
+    m_pool.parallelFor(table.values.size(), [&table, &flags, decidedValue](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; index++) {
+            if (table.values[index] != decidedValue) {
+                continue;
+            }
+            TablebasePosition position;
+            table.layout.getPosition(index, position);
+            forEachPredecessor(position, [&table, &flags](const TablebasePosition& parent) {
+                std::atomic_ref<uint8_t>(flags[table.layout.getIndex(parent)]).fetch_or(IS_CANDIDATE,
+                    std::memory_order_relaxed);
+            });
+        }
+    });
+}
+
+//======================================================================
+// pseudo-legal moves of the side to move, those leaving its king attacked are dropped
+template <typename OnMove>
+bool TablebaseGenerator::forEachMove(const TablebasePosition& position, OnMove&& onMove)
+{
+    bool isWhite = position.isWhiteTurn;
+    Bitboard occupancy = getOccupancy(position);
+    Bitboard own = 0;
+    for (int slot = 0; slot < position.count; slot++) {
+        if (position.men[slot].isWhite == isWhite) {
+            own |= Bitboards::squareBit(position.men[slot].square);
+        }
+    }
+
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        if (man.isWhite != isWhite) {
+            continue;
+        }
+
+        Bitboard targets = getAttacks(man, occupancy);
+        bool isPawn = man.pieceIndex == ChessUtils::PAWN_INDEX;
+        if (isPawn) {
+            targets &= occupancy;
+            int forward = isWhite ? ChessUtils::BOARD_SIZE : -ChessUtils::BOARD_SIZE;
+            int startRow = isWhite ? 1 : ChessUtils::BOARD_SIZE - 2;
+            int oneStep = man.square + forward;
+            if (!(occupancy & Bitboards::squareBit(oneStep))) {
+                targets |= Bitboards::squareBit(oneStep);
+                if (Bitboards::squareRow(man.square) == startRow && !(occupancy & Bitboards::squareBit(oneStep + forward))) {
+                    targets |= Bitboards::squareBit(oneStep + forward);
+                }
+            }
+        }
+        targets &= ~own;
+
+        while (targets) {
+            int dest = Bitboards::popLowestSquare(targets);
+            TablebasePosition child = position;
+            child.isWhiteTurn = !isWhite;
+            child.men[slot].square = dest;
+
+            int movedSlot = slot;
+            bool isCapture = false;
+            for (int other = 0; other < child.count; other++) {
+                if (other != slot && child.men[other].square == dest) {
+                    removeMan(child, other);
+                    movedSlot -= other < slot ? 1 : 0;
+                    isCapture = true;
+                    break;
+                }
+            }
+            if (isKingAttacked(child, isWhite)) {
+                continue;
+            }
+
+            int destRow = Bitboards::squareRow(dest);
+            if (isPawn && (destRow == 0 || destRow == ChessUtils::BOARD_SIZE - 1)) {
+                for (int promotion : PROMOTION_PIECES) {
+                    child.men[movedSlot].pieceIndex = promotion;
+                    if (!onMove(child, false)) {
+                        return false;
+                    }
+                }
+            }
+            else if (!onMove(child, !isCapture)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//======================================================================
+// the side that just moved takes its move back: pieces to empty squares they
+// attack, pawns one or two rows back; the parents may be illegal, their
+// indexes then hold ILLEGAL
+template <typename OnPredecessor>
+void TablebaseGenerator::forEachPredecessor(const TablebasePosition& position, OnPredecessor&& onPredecessor)
+{
+    bool isWhite = !position.isWhiteTurn;
+    Bitboard occupancy = getOccupancy(position);
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        if (man.isWhite != isWhite) {
+            continue;
+        }
+
+        Bitboard origins = 0;
+        if (man.pieceIndex == ChessUtils::PAWN_INDEX) {
+            int backward = isWhite ? -ChessUtils::BOARD_SIZE : ChessUtils::BOARD_SIZE;
+            int startRow = isWhite ? 1 : ChessUtils::BOARD_SIZE - 2;
+            int oneStep = man.square + backward;
+            int row = Bitboards::squareRow(oneStep);
+            if (row > 0 && row < ChessUtils::BOARD_SIZE - 1 && !(occupancy & Bitboards::squareBit(oneStep))) {
+                origins |= Bitboards::squareBit(oneStep);
+                int twoSteps = oneStep + backward;
+                if (Bitboards::squareRow(twoSteps) == startRow && !(occupancy & Bitboards::squareBit(twoSteps))) {
+                    origins |= Bitboards::squareBit(twoSteps);
+                }
+            }
+        }
+        else {
+            origins = getAttacks(man, occupancy) & ~occupancy;
+        }
+
+        while (origins) {
+            TablebasePosition parent = position;
+            parent.men[slot].square = Bitboards::popLowestSquare(origins);
+            parent.isWhiteTurn = isWhite;
+            onPredecessor(parent);
+        }
+    }
+}
+
+//======================================================================
+bool TablebaseGenerator::isAttacked(const TablebasePosition& position, int square, bool byWhite)
+{
+    Bitboard occupancy = getOccupancy(position);
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        if (man.isWhite == byWhite && (getAttacks(man, occupancy) & Bitboards::squareBit(square))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//======================================================================
+bool TablebaseGenerator::isKingAttacked(const TablebasePosition& position, bool isWhiteKing)
+{
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        if (man.pieceIndex == ChessUtils::KING_INDEX && man.isWhite == isWhiteKing) {
+            return isAttacked(position, man.square, !isWhiteKing);
+        }
+    }
+    return false;
+}
+
+//======================================================================
+// one man per square, no pawn on the last rows, the side that just moved not in check
+bool TablebaseGenerator::isValid(const TablebasePosition& position)
+{
+    if (Bitboards::countSquares(getOccupancy(position)) != position.count) {
+        return false;
+    }
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        int row = Bitboards::squareRow(man.square);
+        if (man.pieceIndex == ChessUtils::PAWN_INDEX && (row == 0 || row == ChessUtils::BOARD_SIZE - 1)) {
+            return false;
+        }
+    }
+    return !isKingAttacked(position, !position.isWhiteTurn);
+}
+
+//======================================================================
+// DTM bytes as they are, the WDL outcomes packed four to a byte
+void TablebaseGenerator::writeTable(const Table& table, const std::string& directory)
+{
+    std::string path = directory + "/" + table.layout.getName();
+    std::ofstream dtmFile(path + ".dtm", std::ios::binary);
+    std::ofstream wdlFile(path + ".wdl", std::ios::binary);
+    if (!dtmFile || !wdlFile) {
+        throw std::runtime_error("Error: can't write tablebase files " + path);
+    }
+
+    const std::vector<uint8_t>& values = table.values;
+    writeHeader(dtmFile, Tablebase::DTM_MAGIC, values.size());
+    dtmFile.write(reinterpret_cast<const char*>(values.data()), values.size());
+
+    std::vector<char> packed((values.size() + Tablebase::WDL_PER_BYTE - 1) / Tablebase::WDL_PER_BYTE);
+    for (size_t index = 0; index < values.size(); index++) {
+        packed[index / Tablebase::WDL_PER_BYTE] |=
+            static_cast<char>(Tablebase::toWdl(values[index]) << (2 * (index % Tablebase::WDL_PER_BYTE)));
+    }
+    writeHeader(wdlFile, Tablebase::WDL_MAGIC, values.size());
+    wdlFile.write(packed.data(), packed.size());
+
+    if (!dtmFile || !wdlFile) {
+        throw std::runtime_error("Error: can't write tablebase files " + path);
+    }
+}
+
+//======================================================================
+size_t TablebaseGenerator::getThreadCount() const
+{
+    return m_pool.getThreadCount();
+}
@@ -0,0 +1,239 @@
+#include "Tablebase/TablebaseLayout.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+    // Board symmetries, applied in this order
+    const int FLIP_COLUMNS = 1;
+    const int FLIP_ROWS = 2;
+    const int TRANSPOSE = 4;
+
+    // Regions of the white king: the a1-d1-d4 triangle, or files a-d with pawns
+    constexpr bool isKingRegion(int square, bool hasPawns) {
+        int row = Bitboards::squareRow(square);
+        int col = Bitboards::squareCol(square);
+        return col < ChessUtils::BOARD_SIZE / 2 && (hasPawns || row <= col);
+    }
+
+    struct KingSlots {
+        std::array<int, ChessUtils::SQUARE_COUNT> slots{};
+        std::array<int, ChessUtils::SQUARE_COUNT> squares{};
+        int count = 0;
+    };
+
+    constexpr KingSlots buildKingSlots(bool hasPawns) {
+        KingSlots kingSlots;
+        for (int square = 0; square < ChessUtils::SQUARE_COUNT; square++) {
+            kingSlots.slots[square] = -1;
+            if (isKingRegion(square, hasPawns)) {
+                kingSlots.squares[kingSlots.count] = square;
+                kingSlots.slots[square] = kingSlots.count++;
+            }
+        }
+        return kingSlots;
+    }
+
+    constexpr KingSlots PAWNLESS_KING_SLOTS = buildKingSlots(false);
+    constexpr KingSlots PAWN_KING_SLOTS = buildKingSlots(true);
+
+    int applySymmetry(int square, int symmetry) {
+        int row = Bitboards::squareRow(square);
+        int col = Bitboards::squareCol(square);
+        if (symmetry & FLIP_COLUMNS) {
+            col = ChessUtils::BOARD_SIZE - 1 - col;
+        }
+        if (symmetry & FLIP_ROWS) {
+            row = ChessUtils::BOARD_SIZE - 1 - row;
+        }
+        if (symmetry & TRANSPOSE) {
+            std::swap(row, col);
+        }
+        return Bitboards::squareIndex(row, col);
+    }
+
+    // The white king goes into the region; on the diagonal, the first man off it goes below
+    int getSymmetry(const TablebasePosition& position, bool hasPawns) {
+        int row = Bitboards::squareRow(position.men[0].square);
+        int col = Bitboards::squareCol(position.men[0].square);
+        int symmetry = 0;
+        if (col >= ChessUtils::BOARD_SIZE / 2) {
+            symmetry |= FLIP_COLUMNS;
+            col = ChessUtils::BOARD_SIZE - 1 - col;
+        }
+        if (hasPawns) {
+            return symmetry;
+        }
+        if (row >= ChessUtils::BOARD_SIZE / 2) {
+            symmetry |= FLIP_ROWS;
+            row = ChessUtils::BOARD_SIZE - 1 - row;
+        }
+        if (row > col) {
+            return symmetry | TRANSPOSE;
+        }
+
+        for (int slot = 1; row == col && slot < position.count; slot++) {
+            int square = applySymmetry(position.men[slot].square, symmetry);
+            if (Bitboards::squareRow(square) != Bitboards::squareCol(square)) {
+                return Bitboards::squareRow(square) > Bitboards::squareCol(square) ? symmetry | TRANSPOSE : symmetry;
+            }
+        }
+        return symmetry;
+    }
+}
+
+//======================================================================
+// c-tor, parses and normalizes the signature
+TablebaseLayout::TablebaseLayout(const std::string& signature)
+{
+    size_t blackKing = signature.find('K', 1);
+    if (signature.size() < Tablebase::MIN_MEN || signature.size() > Tablebase::MAX_MEN ||
+        signature[0] != 'K' || blackKing == std::string::npos) {
+        throw std::runtime_error("Error: tablebase " + signature + " needs 3 or 4 men, a king on each side");
+    }
+
+    for (size_t i = 0; i < signature.size(); i++) {
+        int pieceIndex = ChessUtils::getPieceIndex(signature[i]);
+        bool isKingSlot = i == 0 || i == blackKing;
+        if (pieceIndex < 0 || !std::isupper(static_cast<unsigned char>(signature[i])) ||
+            (pieceIndex == ChessUtils::KING_INDEX) != isKingSlot) {
+            throw std::runtime_error("Error: tablebase " + signature + " has an unknown or extra piece");
+        }
+        m_men.men[m_men.count++] = { pieceIndex, i < blackKing, 0 };
+    }
+    normalize(m_men);
+    initialize();
+}
+
+//======================================================================
+TablebaseLayout::TablebaseLayout(const TablebasePosition& position)
+    : m_men(position)
+{
+    initialize();
+}
+
+//======================================================================
+// name, index sizes and key of the normalized men
+void TablebaseLayout::initialize()
+{
+    m_name.clear();
+    m_hasPawns = false;
+    for (int slot = 0; slot < m_men.count; slot++) {
+        m_name += ChessUtils::getPieceSymbol(m_men.men[slot].pieceIndex, true);
+        m_hasPawns |= m_men.men[slot].pieceIndex == ChessUtils::PAWN_INDEX;
+    }
+
+    m_kingSlotCount = m_hasPawns ? PAWN_KING_SLOTS.count : PAWNLESS_KING_SLOTS.count;
+    m_positionCount = Bitboards::COLOR_COUNT * m_kingSlotCount;
+    for (int slot = 1; slot < m_men.count; slot++) {
+        m_positionCount *= ChessUtils::SQUARE_COUNT;
+    }
+    m_materialKey = getMaterialKey(m_men);
+}
+
+//======================================================================
+const std::string& TablebaseLayout::getName() const
+{
+    return m_name;
+}
+
+//======================================================================
+uint32_t TablebaseLayout::getMaterialKey() const
+{
+    return m_materialKey;
+}
+
+//======================================================================
+size_t TablebaseLayout::getPositionCount() const
+{
+    return m_positionCount;
+}
+
+//======================================================================
+int TablebaseLayout::getManCount() const
+{
+    return m_men.count;
+}
+
+//======================================================================
+const TablebaseMan& TablebaseLayout::getMan(int slot) const
+{
+    return m_men.men[slot];
+}
+
+//======================================================================
+// side to move, white king slot, then the other squares, all under the king's symmetry
+size_t TablebaseLayout::getIndex(const TablebasePosition& position) const
+{
+    const KingSlots& kingSlots = m_hasPawns ? PAWN_KING_SLOTS : PAWNLESS_KING_SLOTS;
+    int symmetry = getSymmetry(position, m_hasPawns);
+    size_t index = (position.isWhiteTurn ? 0 : 1) * m_kingSlotCount +
+        kingSlots.slots[applySymmetry(position.men[0].square, symmetry)];
+    for (int slot = 1; slot < position.count; slot++) {
+        index = index * ChessUtils::SQUARE_COUNT + applySymmetry(position.men[slot].square, symmetry);
+    }
+    return index;
+}
+
+//======================================================================
+void TablebaseLayout::getPosition(size_t index, TablebasePosition& position) const
+{
+    const KingSlots& kingSlots = m_hasPawns ? PAWN_KING_SLOTS : PAWNLESS_KING_SLOTS;
+    position = m_men;
+    for (int slot = m_men.count - 1; slot > 0; slot--) {
+        position.men[slot].square = static_cast<int>(index % ChessUtils::SQUARE_COUNT);
+        index /= ChessUtils::SQUARE_COUNT;
+    }
+    position.men[0].square = kingSlots.squares[index % m_kingSlotCount];
+    position.isWhiteTurn = index / m_kingSlotCount == 0;
+}
+
+//======================================================================
+// the stronger side has more material, on equal material the better pieces
+void TablebaseLayout::normalize(TablebasePosition& position)
+{
+    auto isBefore = [](const TablebaseMan& a, const TablebaseMan& b) {
+        return a.isWhite != b.isWhite ? a.isWhite : a.pieceIndex > b.pieceIndex;
+    };
+    std::sort(position.men.begin(), position.men.begin() + position.count, isBefore);
+
+    std::array<std::array<int, Tablebase::MAX_MEN>, Bitboards::COLOR_COUNT> pieces{};
+    std::array<int, Bitboards::COLOR_COUNT> values{};
+    std::array<int, Bitboards::COLOR_COUNT> counts{};
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        int color = Bitboards::colorIndex(man.isWhite);
+        if (man.pieceIndex != ChessUtils::KING_INDEX) {
+            values[color] += ChessUtils::PIECE_VALUES[man.pieceIndex];
+            // One higher than a missing piece, so longer lists of equal pieces compare higher
+            pieces[color][counts[color]++] = man.pieceIndex + 1;
+        }
+    }
+
+    bool isBlackStronger = values[Bitboards::BLACK] != values[Bitboards::WHITE] ?
+        values[Bitboards::BLACK] > values[Bitboards::WHITE] : pieces[Bitboards::BLACK] > pieces[Bitboards::WHITE];
+    if (!isBlackStronger) {
+        return;
+    }
+
+    // Colors swapped, the board flipped so pawns keep their direction
+    for (int slot = 0; slot < position.count; slot++) {
+        TablebaseMan& man = position.men[slot];
+        man.isWhite = !man.isWhite;
+        man.square = Bitboards::mirrorSquare(man.square);
+    }
+    position.isWhiteTurn = !position.isWhiteTurn;
+    std::sort(position.men.begin(), position.men.begin() + position.count, isBefore);
+}
+
+//======================================================================
+// 4 bits per man: piece index + 1, plus 8 for black
+uint32_t TablebaseLayout::getMaterialKey(const TablebasePosition& position)
+{
+    uint32_t key = 0;
+    for (int slot = 0; slot < position.count; slot++) {
+        const TablebaseMan& man = position.men[slot];
+        key = (key << 4) | static_cast<uint32_t>(man.pieceIndex + 1 + (man.isWhite ? 0 : 8));
+    }
+    return key;
+}
@@ -0,0 +1,104 @@
+#include "Tablebase/Tablebases.h"
+#include "Board/Fen.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+    uint64_t readLittleEndian(const char* data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = bytes; i > 0; i--) {
+            value = (value << 8) | static_cast<unsigned char>(data[i - 1]);
+        }
+        return value;
+    }
+
+    // Magic, version and position count, then exactly the expected bytes
+    void checkHeader(const MappedFile& file, const char (&magic)[4], size_t positionCount, size_t dataSize,
+        const std::string& path) {
+        std::string_view contents = file.getContents();
+        if (contents.size() != Tablebase::HEADER_SIZE + dataSize ||
+            !std::equal(magic, magic + 4, contents.data()) ||
+            readLittleEndian(contents.data() + 4, 4) != Tablebase::FILE_VERSION ||
+            readLittleEndian(contents.data() + 8, 8) != positionCount) {
+            throw std::runtime_error("Error: tablebase file " + path + " is malformed");
+        }
+    }
+}
+
+//======================================================================
+// c-tor, every <name>.wdl with its <name>.dtm
+Tablebases::Tablebases(const std::string& directory)
+{
+    if (!std::filesystem::is_directory(directory)) {
+        throw std::runtime_error("Error: tablebase directory " + directory + " not found");
+    }
+
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        if (file.path().extension() != ".wdl") {
+            continue;
+        }
+        std::string path = file.path().string();
+        std::string dtmPath = path.substr(0, path.size() - 4) + ".dtm";
+        TablebaseLayout layout(file.path().stem().string());
+        size_t positionCount = layout.getPositionCount();
+
+        auto wdlFile = std::make_unique<MappedFile>(path, false);
+        auto dtmFile = std::make_unique<MappedFile>(dtmPath, false);
+        checkHeader(*wdlFile, Tablebase::WDL_MAGIC, positionCount,
+            (positionCount + Tablebase::WDL_PER_BYTE - 1) / Tablebase::WDL_PER_BYTE, path);
+        checkHeader(*dtmFile, Tablebase::DTM_MAGIC, positionCount, positionCount, dtmPath);
+        m_tables.emplace(layout.getMaterialKey(), Table{ layout, std::move(wdlFile), std::move(dtmFile) });
+    }
+}
+
+//======================================================================
+// men in table order, then the outcome and, for a decided position, the distance
+bool Tablebases::probe(const Board& board, TablebaseResult& result) const
+{
+    Bitboard occupancy = board.getOccupancy();
+    if (Bitboards::countSquares(occupancy) > Tablebase::MAX_MEN || board.getCastlingRights() != 0 ||
+        board.getEnPassantSquare() != Fen::NO_SQUARE || m_tables.empty()) {
+        return false;
+    }
+
+    TablebasePosition position;
+    position.isWhiteTurn = board.getIsWhiteTurn();
+    for (bool isWhite : { true, false }) {
+        for (int pieceIndex = ChessUtils::KING_INDEX; pieceIndex >= ChessUtils::PAWN_INDEX; pieceIndex--) {
+            Bitboard pieces = board.getPieces(isWhite, pieceIndex);
+            while (pieces) {
+                position.men[position.count++] = { pieceIndex, isWhite, Bitboards::popLowestSquare(pieces) };
+            }
+        }
+    }
+    TablebaseLayout::normalize(position);
+
+    auto found = m_tables.find(TablebaseLayout::getMaterialKey(position));
+    if (found == m_tables.end()) {
+        return false;
+    }
+    const Table& table = found->second;
+    size_t index = table.layout.getIndex(position);
+
+    const char* wdl = table.wdlFile->getContents().data() + Tablebase::HEADER_SIZE;
+    int outcome = (static_cast<unsigned char>(wdl[index / Tablebase::WDL_PER_BYTE]) >>
+        (2 * (index % Tablebase::WDL_PER_BYTE))) & 3;
+    if (outcome == Tablebase::WDL_ILLEGAL) {
+        return false;
+    }
+
+    result.outcome = outcome;
+    result.distance = 0;
+    if (outcome != Tablebase::WDL_DRAW) {
+        uint8_t value = static_cast<uint8_t>(table.dtmFile->getContents()[Tablebase::HEADER_SIZE + index]);
+        result.distance = outcome == Tablebase::WDL_WIN ? value : value - Tablebase::LOSS_BASE;
+    }
+    return true;
+}
+
+//======================================================================
+size_t Tablebases::getTableCount() const
+{
+    return m_tables.size();
+}
@@ -0,0 +1,251 @@
+#include "Uci/UciEngine.h"
+#include "Board/MoveNotation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+
+//======================================================================
+// c-tor, starts from the initial position
+UciEngine::UciEngine(std::istream& input, std::ostream& output)
+    : m_input(input), m_output(output), m_referenceBoard(ChessUtils::START_BOARD),
+    m_recommender(m_referenceBoard, 1), m_board(std::make_unique<Board>(Fen::parse(ChessUtils::START_FEN))),
+    m_stopRequested(false)
+{
+    m_recommender.setRandomnessEnabled(false);
+}
+
+//======================================================================
+// d-tor, a running search must end before the board goes away
+UciEngine::~UciEngine()
+{
+    stopSearch();
+}
+
+//======================================================================
+void UciEngine::setNetwork(std::shared_ptr<const NnueNetwork> network)
+{
+    stopSearch();
+    m_network = network;
+    m_recommender.setNetwork(network);
+    m_board->setNetwork(network);
+}
+
+//======================================================================
+void UciEngine::setTablebases(std::shared_ptr<const Tablebases> tablebases)
+{
+    stopSearch();
+    m_recommender.setTablebases(std::move(tablebases));
+}
+
+//======================================================================
+void UciEngine::run()
+{
+    std::string line;
+    while (std::getline(m_input, line)) {
+        std::istringstream arguments(line);
+        std::string command;
+        arguments >> command;
+
+        if (command == "uci") {
+            send("id name Chess");
+            send("id author Chess project");
+            send("option name Hash type spin default " + std::to_string(ChessUtils::TRANSPOSITION_TABLE_SIZE_MB) +
+                " min 1 max " + std::to_string(ChessUtils::MAX_TRANSPOSITION_TABLE_SIZE_MB));
+            send("option name Threads type spin default 1 min 1 max " + std::to_string(ChessUtils::MAX_THREAD_COUNT));
+            send("option name TablebasePath type string default <empty>");
+            send("uciok");
+        }
+        else if (command == "isready") {
+            send("readyok");
+        }
+        else if (command == "ucinewgame") {
+            stopSearch();
+            m_recommender.clearTranspositionTable();
+        }
+        else if (command == "position") {
+            handlePosition(arguments);
+        }
+        else if (command == "go") {
+            handleGo(arguments);
+        }
+        else if (command == "stop") {
+            stopSearch();
+        }
+        else if (command == "setoption") {
+            handleSetOption(arguments);
+        }
+        else if (command == "quit") {
+            break;
+        }
+    }
+    stopSearch();
+}
+
+//======================================================================
+// position startpos | fen <fields> [moves <move> ...]
+void UciEngine::handlePosition(std::istringstream& arguments)
+{
+    stopSearch();
+
+    std::string token;
+    arguments >> token;
+    std::string fen = ChessUtils::START_FEN;
+    if (token == "fen") {
+        fen.clear();
+        while (arguments >> token && token != "moves") {
+            fen += token + " ";
+        }
+    }
+    else {
+        arguments >> token;
+    }
+
+    try {
+        m_board = std::make_unique<Board>(Fen::parse(fen));
+    }
+    catch (const std::runtime_error& e) {
+        send(std::string("info string ") + e.what());
+        return;
+    }
+    m_board->setNetwork(m_network);
+    if (token != "moves") {
+        return;
+    }
+
+    // Moves are checked against the legal ones, the first bad one ends the list
+    std::vector<BoardMove> legalMoves;
+    while (arguments >> token) {
+        BoardMove move;
+        m_board->generateLegalMoves(legalMoves);
+        bool isLegal = MoveNotation::parse(token, move) &&
+            std::any_of(legalMoves.begin(), legalMoves.end(), [&move](const BoardMove& legal) {
+                return legal == move;
+            });
+        legalMoves.clear();
+        if (!isLegal) {
+            send("info string illegal move " + token);
+            return;
+        }
+        m_board->makeMove(move);
+    }
+}
+
+//======================================================================
+// starts the search thread, which answers with info lines and bestmove
+void UciEngine::handleGo(std::istringstream& arguments)
+{
+    stopSearch();
+
+    m_limits = SearchLimits();
+    std::string token;
+    while (arguments >> token) {
+        if (token == "infinite") {
+            m_limits.isInfinite = true;
+            continue;
+        }
+        int64_t value = 0;
+        if (!(arguments >> value)) {
+            break;
+        }
+        if (token == "wtime") m_limits.whiteTimeMs = value;
+        else if (token == "btime") m_limits.blackTimeMs = value;
+        else if (token == "winc") m_limits.whiteIncrementMs = value;
+        else if (token == "binc") m_limits.blackIncrementMs = value;
+        else if (token == "movetime") m_limits.moveTimeMs = value;
+        else if (token == "nodes") m_limits.nodes = static_cast<uint64_t>(value);
+        else if (token == "depth") m_limits.depth = static_cast<int>(value);
+    }
+
+    m_stopRequested = false;
+    m_limits.stopRequested = &m_stopRequested;
+    m_searchThread = std::thread([this]() {
+        SearchInfo result = m_recommender.search(*m_board, m_limits, [this](const SearchInfo& info) {
+            send(formatInfo(info));
+        });
+
+        // "go infinite" only answers after "stop"
+        while (m_limits.isInfinite && !m_stopRequested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        send("bestmove " + (result.principalVariation.empty() ? std::string("0000") :
+            MoveNotation::format(result.principalVariation.front())));
+    });
+}
+
+//======================================================================
+// setoption name <Hash|Threads> value <number>, setoption name TablebasePath value <directory>
+void UciEngine::handleSetOption(std::istringstream& arguments)
+{
+    std::string token, name;
+    arguments >> token >> name >> token;
+    if (token != "value") {
+        return;
+    }
+
+    stopSearch();
+    if (name == "TablebasePath") {
+        std::string directory;
+        std::getline(arguments >> std::ws, directory);
+        try {
+            m_recommender.setTablebases(directory.empty() || directory == "<empty>" ? nullptr :
+                std::make_shared<const Tablebases>(directory));
+        }
+        catch (const std::runtime_error& e) {
+            send(std::string("info string ") + e.what());
+        }
+        return;
+    }
+
+    int64_t value = 0;
+    arguments >> value;
+    if (name == "Hash") {
+        m_recommender.resizeTranspositionTable(static_cast<size_t>(std::clamp<int64_t>(value, 1,
+            ChessUtils::MAX_TRANSPOSITION_TABLE_SIZE_MB)));
+    }
+    else if (name == "Threads") {
+        m_recommender.setThreadCount(static_cast<size_t>(std::clamp<int64_t>(value, 1, ChessUtils::MAX_THREAD_COUNT)));
+    }
+}
+
+//======================================================================
+// raises the stop flag and waits for the bestmove
+void UciEngine::stopSearch()
+{
+    m_stopRequested = true;
+    if (m_searchThread.joinable()) {
+        m_searchThread.join();
+    }
+}
+
+//======================================================================
+// both threads write lines, one at a time
+void UciEngine::send(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    m_output << line << std::endl;
+}
+
+//======================================================================
+// scores go out in centipawns, or in moves to mate
+std::string UciEngine::formatInfo(const SearchInfo& info) const
+{
+    std::string line = "info depth " + std::to_string(info.depth) + " score ";
+    if (std::abs(info.score) >= ChessUtils::MATE_THRESHOLD) {
+        int plies = ChessUtils::SEARCH_MATE_SCORE - std::abs(info.score);
+        int moves = (plies + 1) / 2;
+        line += "mate " + std::to_string(info.score > 0 ? moves : -moves);
+    }
+    else {
+        line += "cp " + std::to_string(info.score * Nnue::CENTIPAWNS_PER_PAWN /
+            (ChessUtils::PAWN_VALUE * ChessUtils::CAPTURE_MULTIPLIER));
+    }
+
+    int64_t nodesPerSecond = info.elapsedMs > 0 ? static_cast<int64_t>(info.nodes * 1000 / info.elapsedMs) : 0;
+    line += " nodes " + std::to_string(info.nodes) + " nps " + std::to_string(nodesPerSecond) +
+        " time " + std::to_string(info.elapsedMs) + " pv";
+    for (const BoardMove& move : info.principalVariation) {
+        line += " " + MoveNotation::format(move);
+    }
+    return line;
+}
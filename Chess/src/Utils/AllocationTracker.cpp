@@ -0,0 +1,204 @@
+#include "Utils/AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+    // Constant-initialized, so counting never allocates and works before main
+    std::atomic<uint64_t> allocationCounts[Allocations::PHASE_COUNT];
+    std::atomic<uint64_t> allocationBytes[Allocations::PHASE_COUNT];
+    thread_local Allocations::Phase currentPhase = Allocations::Phase::OTHER;
+
+    const char* PHASE_NAMES[] = {
+        "other", "root setup", "tree search", "move generation", "move ordering",
+        "evaluation", "board state", "result queue"
+    };
+}
+
+//======================================================================
+const char* Allocations::getPhaseName(Phase phase)
+{
+    return PHASE_NAMES[static_cast<int>(phase)];
+}
+
+//======================================================================
+uint64_t Allocations::Counters::getTotalAllocations() const
+{
+    uint64_t total = 0;
+    for (uint64_t count : allocations) {
+        total += count;
+    }
+    return total;
+}
+
+//======================================================================
+uint64_t Allocations::Counters::getTotalBytes() const
+{
+    uint64_t total = 0;
+    for (uint64_t count : bytes) {
+        total += count;
+    }
+    return total;
+}
+
+//======================================================================
+Allocations::Counters Allocations::Counters::operator-(const Counters& earlier) const
+{
+    Counters difference;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        difference.allocations[i] = allocations[i] - earlier.allocations[i];
+        difference.bytes[i] = bytes[i] - earlier.bytes[i];
+    }
+    return difference;
+}
+
+//======================================================================
+bool Allocations::isCompiledIn()
+{
+#ifdef CHESS_ALLOCATION_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+//======================================================================
+Allocations::Counters Allocations::snapshot()
+{
+    Counters counters;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        counters.allocations[i] = allocationCounts[i].load(std::memory_order_relaxed);
+        counters.bytes[i] = allocationBytes[i].load(std::memory_order_relaxed);
+    }
+    return counters;
+}
+
+//======================================================================
+void Allocations::recordAllocation(size_t size)
+{
+    int phase = static_cast<int>(currentPhase);
+    allocationCounts[phase].fetch_add(1, std::memory_order_relaxed);
+    allocationBytes[phase].fetch_add(size, std::memory_order_relaxed);
+}
+
+//======================================================================
+Allocations::PhaseScope::PhaseScope(Phase phase)
+    : m_outerPhase(currentPhase)
+{
+    currentPhase = phase;
+}
+
+//======================================================================
+Allocations::PhaseScope::~PhaseScope()
+{
+    currentPhase = m_outerPhase;
+}
+
+//======================================================================
+void printAllocations(std::ostream& os, const Allocations::Counters& counters, uint64_t nodes)
+{
+    std::ios_base::fmtflags flags = os.flags();
+    os << "allocations " << counters.getTotalAllocations() << " (" << counters.getTotalBytes() << " bytes";
+    if (nodes > 0) {
+        os << ", " << std::fixed << std::setprecision(2)
+            << static_cast<double>(counters.getTotalAllocations()) / nodes << " per node";
+    }
+    os << ")";
+    for (int i = 0; i < Allocations::PHASE_COUNT; i++) {
+        if (counters.allocations[i] > 0) {
+            os << " | " << Allocations::getPhaseName(static_cast<Allocations::Phase>(i)) << " "
+                << counters.allocations[i] << "/" << counters.bytes[i] << "B";
+        }
+    }
+    os << std::endl;
+    os.flags(flags);
+}
+
+#ifdef CHESS_ALLOCATION_TRACKING
+// Replaced global allocation functions, every other form of new and delete forwards to these
+
+//======================================================================
+void* operator new(size_t size)
+{
+    Allocations::recordAllocation(size);
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+//======================================================================
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    Allocations::recordAllocation(size);
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size > 0 ? size : 1, align);
+#else
+    // aligned_alloc wants a nonzero multiple of the alignment
+    void* memory = std::aligned_alloc(align, size > 0 ? (size + align - 1) / align * align : align);
+#endif
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+//======================================================================
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+//======================================================================
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+//======================================================================
+// the sized forms, which compilers call when they know the size, ignore it
+void operator delete(void* memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+//======================================================================
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
+
+//======================================================================
+void operator delete[](void* memory) noexcept
+{
+    operator delete(memory);
+}
+
+//======================================================================
+void operator delete[](void* memory, std::align_val_t alignment) noexcept
+{
+    operator delete(memory, alignment);
+}
+
+//======================================================================
+void operator delete[](void* memory, size_t) noexcept
+{
+    operator delete[](memory);
+}
+
+//======================================================================
+void operator delete[](void* memory, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete[](memory, alignment);
+}
+#endif
@@ -0,0 +1,216 @@
+#include "Utils/HardwareCounters.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char* EVENT_NAMES[] = {
+        "task-clock-ns", "cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses"
+    };
+
+#ifdef __linux__
+    // Event type and config of each HardwareEvent
+    struct EventConfig {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    const EventConfig EVENT_CONFIGS[] = {
+        { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    };
+
+    int openEvent(const EventConfig& config, pid_t threadId) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = config.type;
+        attributes.config = config.config;
+        attributes.disabled = 1;
+        attributes.inherit = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, threadId, -1, -1, 0));
+    }
+
+    std::string describeError(int error) {
+        if (error == EACCES || error == EPERM) {
+            return "not permitted (kernel.perf_event_paranoid)";
+        }
+        if (error == ENOENT || error == EOPNOTSUPP || error == ENOSYS) {
+            return "not supported here";
+        }
+        return std::strerror(error);
+    }
+
+    // Ids of the threads of this process
+    std::vector<pid_t> listThreads() {
+        std::vector<pid_t> threads;
+        DIR* directory = ::opendir("/proc/self/task");
+        if (!directory) {
+            threads.push_back(static_cast<pid_t>(::syscall(SYS_gettid)));
+            return threads;
+        }
+        while (dirent* entry = ::readdir(directory)) {
+            if (entry->d_name[0] != '.') {
+                threads.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+            }
+        }
+        ::closedir(directory);
+        return threads;
+    }
+#endif
+}
+
+//======================================================================
+bool HardwareCounts::hasAny() const
+{
+    for (bool isEventAvailable : isAvailable) {
+        if (isEventAvailable) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//======================================================================
+const char* HardwareCounts::getEventName(HardwareEvent event)
+{
+    return EVENT_NAMES[static_cast<int>(event)];
+}
+
+//======================================================================
+HardwareCounters::HardwareCounters()
+{
+}
+
+//======================================================================
+HardwareCounters::~HardwareCounters()
+{
+    closeAll();
+}
+
+//======================================================================
+// an event is kept only when it opens on every thread
+bool HardwareCounters::start()
+{
+    closeAll();
+    m_error.clear();
+#ifdef __linux__
+    std::vector<pid_t> threads = listThreads();
+    bool hasAny = false;
+    for (int event = 0; event < HARDWARE_EVENT_COUNT; event++) {
+        for (pid_t thread : threads) {
+            int descriptor = openEvent(EVENT_CONFIGS[event], thread);
+            if (descriptor < 0) {
+                m_error += (m_error.empty() ? "" : ", ") + std::string(EVENT_NAMES[event]) + " " +
+                    describeError(errno);
+                for (int opened : m_descriptors[event]) {
+                    ::close(opened);
+                }
+                m_descriptors[event].clear();
+                break;
+            }
+            m_descriptors[event].push_back(descriptor);
+        }
+        hasAny |= !m_descriptors[event].empty();
+    }
+
+    for (const std::vector<int>& descriptors : m_descriptors) {
+        for (int descriptor : descriptors) {
+            ::ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    return hasAny;
+#else
+    m_error = "perf_event_open needs Linux";
+    return false;
+#endif
+}
+
+//======================================================================
+// multiplexed counts are scaled to the whole enabled time
+HardwareCounts HardwareCounters::stop()
+{
+    HardwareCounts counts;
+#ifdef __linux__
+    for (int event = 0; event < HARDWARE_EVENT_COUNT; event++) {
+        for (int descriptor : m_descriptors[event]) {
+            ::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running
+            uint64_t values[3] = {};
+            if (::read(descriptor, values, sizeof(values)) != sizeof(values)) {
+                continue;
+            }
+            counts.isAvailable[event] = true;
+            if (values[2] > 0) {
+                counts.values[event] += static_cast<uint64_t>(
+                    static_cast<double>(values[0]) * values[1] / values[2]);
+            }
+        }
+    }
+#endif
+    closeAll();
+    return counts;
+}
+
+//======================================================================
+const std::string& HardwareCounters::getError() const
+{
+    return m_error;
+}
+
+//======================================================================
+void HardwareCounters::closeAll()
+{
+    for (std::vector<int>& descriptors : m_descriptors) {
+#ifdef __linux__
+        for (int descriptor : descriptors) {
+            ::close(descriptor);
+        }
+#endif
+        descriptors.clear();
+    }
+}
+
+//======================================================================
+void printHardwareCounts(std::ostream& os, const HardwareCounts& counts, uint64_t nodes)
+{
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(1) << "counters";
+    for (int event = 0; event < HARDWARE_EVENT_COUNT; event++) {
+        if (!counts.isAvailable[event]) {
+            continue;
+        }
+        os << " | " << EVENT_NAMES[event] << " " << counts.values[event];
+        if (nodes > 0) {
+            os << " (" << static_cast<double>(counts.values[event]) / nodes << "/node)";
+        }
+    }
+    int cycles = static_cast<int>(HardwareEvent::CYCLES);
+    int instructions = static_cast<int>(HardwareEvent::INSTRUCTIONS);
+    if (counts.isAvailable[cycles] && counts.isAvailable[instructions] && counts.values[cycles] > 0) {
+        os << " | IPC " << std::setprecision(2)
+            << static_cast<double>(counts.values[instructions]) / counts.values[cycles];
+    }
+    if (!counts.hasAny()) {
+        os << " unavailable";
+    }
+    os << std::endl;
+    os.flags(flags);
+}
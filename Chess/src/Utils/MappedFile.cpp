@@ -0,0 +1,107 @@
+#include "Utils/MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+//======================================================================
+// c-tor, maps the file, the handles are not needed once the view exists
+MappedFile::MappedFile(const std::string& path, bool isSequential)
+    : m_data(nullptr), m_size(0)
+{
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        isSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Error: file " + path + " not found");
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        throw std::runtime_error("Error: can't read the size of " + path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // An empty file can't be mapped, it simply has no contents
+    if (m_size > 0) {
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping) {
+            ::CloseHandle(mapping);
+        }
+        if (!data) {
+            ::CloseHandle(file);
+            throw std::runtime_error("Error: can't map " + path);
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    ::CloseHandle(file);
+}
+
+//======================================================================
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        ::UnmapViewOfFile(m_data);
+    }
+}
+
+#else
+//======================================================================
+// c-tor, maps the file, the descriptor is not needed once the mapping exists
+MappedFile::MappedFile(const std::string& path, bool isSequential)
+    : m_data(nullptr), m_size(0)
+{
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Error: file " + path + " not found");
+    }
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Error: can't read the size of " + path);
+    }
+    m_size = static_cast<size_t>(status.st_size);
+
+    // An empty file can't be mapped, it simply has no contents
+    if (m_size > 0) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Error: can't map " + path);
+        }
+        ::madvise(data, m_size, isSequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        m_data = static_cast<const char*>(data);
+    }
+    ::close(descriptor);
+}
+
+//======================================================================
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+#endif
+
+//======================================================================
+std::string_view MappedFile::getContents() const
+{
+    return std::string_view(m_data, m_size);
+}
+
+//======================================================================
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
@@ -0,0 +1,108 @@
+#include "Utils/ThreadPool.h"
+#include "Utils/Trace.h"
+#include <algorithm>
+
+//======================================================================
+// c-tor, starts the workers
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_pendingTasks(0), m_isStopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+//======================================================================
+// d-tor, lets the queued tasks finish and joins the workers
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+//======================================================================
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+        m_pendingTasks++;
+    }
+    m_taskAvailable.notify_one();
+}
+
+//======================================================================
+// blocks until the queue is drained, rethrows the first task error
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_allDone.wait(lock, [this]() { return m_pendingTasks == 0; });
+
+    if (m_firstError) {
+        std::exception_ptr error = m_firstError;
+        m_firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+//======================================================================
+// contiguous chunks keep each thread on its own part of the data
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& func)
+{
+    size_t chunkCount = std::min(count, m_workers.size());
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        size_t begin = count * chunk / chunkCount;
+        size_t end = count * (chunk + 1) / chunkCount;
+        submit([&func, begin, end]() { func(begin, end); });
+    }
+    wait();
+}
+
+//======================================================================
+size_t ThreadPool::getThreadCount() const
+{
+    return m_workers.size();
+}
+
+//======================================================================
+// takes tasks until the pool stops and the queue is empty
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_isStopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        try {
+            CHESS_TRACE_SCOPE("ThreadPool::task");
+            task();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_firstError) {
+                m_firstError = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pendingTasks == 0) {
+            m_allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include "Utils/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // Events kept per thread, about 24 MB of address space touched only as it fills
+    const size_t BUFFER_CAPACITY = 1 << 20;
+
+    struct TraceEvent {
+        const char* name;
+        int64_t startNs;
+        int64_t endNs;
+    };
+
+    // Written only by its thread; size is published with release so a reader sees whole events
+    struct ThreadBuffer {
+        int threadId;
+        std::unique_ptr<TraceEvent[]> events;
+        std::atomic<size_t> size;
+        std::atomic<uint64_t> dropped;
+    };
+
+    // The buffers outlive their threads, so the trace keeps events of finished pools
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    // Takes the lock once per thread, at its first event
+    ThreadBuffer& registerThread() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->threadId = static_cast<int>(buffers.size());
+        buffer->events = std::make_unique_for_overwrite<TraceEvent[]>(BUFFER_CAPACITY);
+        buffer->size = 0;
+        buffer->dropped = 0;
+        buffers.push_back(std::move(buffer));
+        return *buffers.back();
+    }
+
+    std::string escapeJson(const char* text) {
+        std::string escaped;
+        for (; *text; text++) {
+            if (*text == '"' || *text == '\\') {
+                escaped += '\\';
+            }
+            escaped += *text;
+        }
+        return escaped;
+    }
+}
+
+//======================================================================
+bool Trace::isCompiledIn()
+{
+#ifdef CHESS_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+//======================================================================
+void Trace::record(const char* name, int64_t startNs, int64_t endNs)
+{
+    thread_local ThreadBuffer& buffer = registerThread();
+    size_t size = buffer.size.load(std::memory_order_relaxed);
+    if (size == BUFFER_CAPACITY) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[size] = { name, startNs, endNs };
+    buffer.size.store(size + 1, std::memory_order_release);
+}
+
+//======================================================================
+// times are microseconds from the earliest start, as the format expects
+void Trace::writeChromeTrace(std::ostream& output)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    int64_t originNs = std::numeric_limits<int64_t>::max();
+    uint64_t dropped = 0;
+    for (const auto& buffer : buffers) {
+        size_t size = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; i++) {
+            originNs = std::min(originNs, buffer->events[i].startNs);
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+
+    std::ios_base::fmtflags flags = output.flags();
+    output << std::fixed << std::setprecision(3) << "{\"traceEvents\": [";
+    bool isFirst = true;
+    for (const auto& buffer : buffers) {
+        output << (isFirst ? "" : ",") << "\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+            << buffer->threadId << ", \"args\": {\"name\": \"thread " << buffer->threadId << "\"}}";
+        isFirst = false;
+
+        size_t size = buffer->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < size; i++) {
+            const TraceEvent& event = buffer->events[i];
+            output << ",\n{\"name\": \"" << escapeJson(event.name) << "\", \"ph\": \"X\", \"ts\": "
+                << (event.startNs - originNs) / 1000.0 << ", \"dur\": " << (event.endNs - event.startNs) / 1000.0
+                << ", \"pid\": 1, \"tid\": " << buffer->threadId << "}";
+        }
+    }
+    output << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+    output.flags(flags);
+}
+
+//======================================================================
+// c-tor, checks the file can be written before the run starts
+TraceSession::TraceSession(const std::string& path)
+    : m_path(path)
+{
+    if (m_path.empty()) {
+        return;
+    }
+    if (!Trace::isCompiledIn()) {
+        throw std::runtime_error("Error: --trace needs a build configured with -DCHESS_ENABLE_TRACING=ON");
+    }
+    if (!std::ofstream(m_path)) {
+        throw std::runtime_error("Error: can't create trace file " + m_path);
+    }
+}
+
+//======================================================================
+// d-tor, writes the trace
+TraceSession::~TraceSession()
+{
+    if (m_path.empty()) {
+        return;
+    }
+    std::ofstream file(m_path);
+    Trace::writeChromeTrace(file);
+}
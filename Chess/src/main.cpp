@@ -1,13 +1,496 @@
 #include "Chess.h"
 #include "Board/Board.h"
 #include "MoveRecommender/MoveRecommender.h"
+#include "Batch/BatchEvaluator.h"
+#include "Replay/GameReplayer.h"
+#include "Epd/EpdRunner.h"
+#include "Match/MatchRunner.h"
+#include "Pgn/PgnReader.h"
+#include "Server/AnalysisServer.h"
+#include "Tablebase/TablebaseGenerator.h"
+#include "Uci/UciEngine.h"
+#include "Utils/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
 
-int main()
+namespace {
+    const int64_t MAX_MATCH_GAMES = 1000000;
+    const double MAX_SPRT_ELO = 1000;
+}
+
+// The whole option value as a number from minimum to maximum, throws std::runtime_error otherwise
+int64_t parseNumber(const string& option, const string& value, int64_t minimum, int64_t maximum)
+{
+    try {
+        size_t length = 0;
+        int64_t number = std::stoll(value, &length);
+        if (length == value.size() && number >= minimum && number <= maximum) {
+            return number;
+        }
+    }
+    catch (const std::logic_error&) {
+    }
+    throw std::runtime_error("Error: " + option + " needs a number from " + std::to_string(minimum) + " to " +
+        std::to_string(maximum) + ", not '" + value + "'");
+}
+
+// The whole option value as a decimal number from minimum to maximum, throws std::runtime_error otherwise
+double parseDecimal(const string& option, const string& value, double minimum, double maximum)
+{
+    try {
+        size_t length = 0;
+        double number = std::stod(value, &length);
+        if (length == value.size() && number >= minimum && number <= maximum) {
+            return number;
+        }
+    }
+    catch (const std::logic_error&) {
+    }
+    std::ostringstream message;
+    message << "Error: " << option << " needs a number from " << minimum << " to " << maximum << ", not '"
+        << value << "'";
+    throw std::runtime_error(message.str());
+}
+
+// Scores every line of a positions file, prints one score per line and the throughput
+int runBatch(const string& path, BatchMode mode, size_t threadCount, const string& networkPath)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: positions file " << path << " not found" << endl;
+        return 1;
+    }
+
+    std::vector<string> positions;
+    string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            positions.push_back(line);
+        }
+    }
+
+    std::vector<int> scores(positions.size());
+    BatchEvaluator evaluator(threadCount);
+    try {
+        if (!networkPath.empty()) {
+            evaluator.setNetwork(std::make_shared<const NnueNetwork>(networkPath));
+        }
+        evaluator.evaluate(positions, scores, mode);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    for (int score : scores) {
+        cout << score << '\n';
+    }
+    std::cerr << positions.size() << " positions, " << evaluator.getThreadCount() << " threads, "
+        << static_cast<long long>(evaluator.getPositionsPerSecond()) << " positions/sec" << endl;
+    return 0;
+}
+
+// Replays the games of a file ("-" for stdin), prints the result codes and the throughput
+int runReplay(const string& path, int recommendDepth)
+{
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file) {
+            std::cerr << "Error: games file " << path << " not found" << endl;
+            return 1;
+        }
+    }
+
+    GameReplayer replayer(cout, recommendDepth);
+    replayer.replay(path == "-" ? std::cin : file);
+    cout.flush();
+    std::cerr << replayer.getGameCount() << " games, " << replayer.getMoveCount() << " moves, "
+        << replayer.getIllegalMoveCount() << " illegal, "
+        << static_cast<long long>(replayer.getMovesPerSecond()) << " moves/sec" << endl;
+    return 0;
+}
+
+// Runs a test suite with a search or perft per position, prints the results and the throughput
+int runEpd(const string& path, EpdMode mode, int depth, size_t threadCount)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: EPD file " << path << " not found" << endl;
+        return 1;
+    }
+
+    EpdRunner runner(cout, threadCount);
+    try {
+        runner.run(file, mode, depth);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    cout.flush();
+    std::cerr << runner.getPositionCount() << " positions, " << runner.getFailureCount() << " failed, "
+        << runner.getThreadCount() << " threads, " << runner.getNodeCount() << " nodes in "
+        << static_cast<long long>(runner.getElapsedSeconds() * 1000) << "ms, "
+        << static_cast<long long>(runner.getNodesPerSecond()) << " nodes/sec" << endl;
+    return runner.getFailureCount() == 0 ? 0 : 1;
+}
+
+// Validates every game of a PGN file, prints the games that don't replay and the throughput
+int runPgn(const string& path, size_t threadCount)
+{
+    PgnReader reader(threadCount);
+    try {
+        reader.read(path);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    for (const PgnError& error : reader.getErrors()) {
+        cout << "game " << error.gameNumber << " (offset " << error.offset << "): ";
+        if (error.ply == 0) {
+            cout << "bad FEN '" << error.token << "'\n";
+        }
+        else {
+            cout << "bad move '" << error.token << "' at ply " << error.ply << '\n';
+        }
+    }
+    cout.flush();
+    std::cerr << reader.getGameCount() << " games, " << reader.getPlyCount() << " plies, "
+        << reader.getErrors().size() << " invalid, " << reader.getThreadCount() << " threads, "
+        << static_cast<long long>(reader.getGamesPerSecond()) << " games/sec, "
+        << static_cast<long long>(reader.getPliesPerSecond()) << " plies/sec" << endl;
+    return reader.getErrors().empty() ? 0 : 1;
+}
+
+// Generates an endgame table and the smaller ones it leads into
+int runTablebaseGeneration(const string& signature, const string& directory, size_t threadCount)
+{
+    TablebaseGenerator generator(std::cerr, threadCount);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        generator.generate(signature, directory);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << generator.getThreadCount() << " threads, " << static_cast<long long>(elapsed.count() * 1000)
+        << "ms" << endl;
+    return 0;
+}
+
+// Plays a self-play match between two engine configurations, prints each game and the Elo/SPRT totals
+int runMatch(const string& firstSpec, const string& secondSpec, const MatchSettings& settings, size_t threadCount)
+{
+    MatchRunner runner(cout, threadCount);
+    try {
+        MatchEngine first = MatchEngine::parse(firstSpec, "engine1");
+        MatchEngine second = MatchEngine::parse(secondSpec, "engine2");
+        runner.run(first, second, settings);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    SprtStatus status = runner.getSprtStatus();
+    std::cerr << runner.getWinCount() << " wins, " << runner.getLossCount() << " losses, "
+        << runner.getDrawCount() << " draws, Elo " << std::fixed << std::setprecision(1) << runner.getElo()
+        << " +/- " << runner.getEloMargin() << ", SPRT [" << settings.sprt.elo0 << ", " << settings.sprt.elo1
+        << "] LLR " << std::setprecision(2) << runner.getLogLikelihoodRatio() << " "
+        << (status == SprtStatus::ACCEPT_H1 ? "H1 accepted" : status == SprtStatus::ACCEPT_H0 ? "H0 accepted" :
+            "undecided") << ", " << runner.getThreadCount() << " threads, "
+        << static_cast<long long>(runner.getGamesPerHour()) << " games/hour" << endl;
+    return 0;
+}
+
+// Maps the tables of --tablebases <directory>, nullptr without the option
+std::shared_ptr<const Tablebases> loadTablebases(int argc, char* argv[])
+{
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--tablebases") {
+            return std::make_shared<const Tablebases>(argv[i + 1]);
+        }
+    }
+    return nullptr;
+}
+
+// Serves analysis requests on a socket until the process ends
+int runServer(const string& address, size_t threadCount, size_t hashMb, int argc, char* argv[])
+{
+#ifdef _WIN32
+    // The server is POSIX only and not part of the Windows build
+    (void)address, (void)threadCount, (void)hashMb, (void)argc, (void)argv;
+    std::cerr << "Error: --server is not supported on Windows" << endl;
+    return 1;
+#else
+    try {
+        AnalysisServer server(std::cerr, threadCount, hashMb);
+        for (int i = 1; i + 1 < argc; i++) {
+            if (string(argv[i]) == "--nnue") {
+                server.setNetwork(std::make_shared<const NnueNetwork>(argv[i + 1]));
+            }
+        }
+        server.setTablebases(loadTablebases(argc, argv));
+        server.listen(address);
+        server.run();
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+#endif
+}
+
+int main(int argc, char* argv[])
 {
-    string board = "RNBQKBNRPPPPPPPP################################pppppppprnbqkbnr";
-    Chess a(board);
+    // Chrome trace of the whole run, written at exit: --trace <file> (CHESS_ENABLE_TRACING builds)
+    string tracePath;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (string(argv[i]) == "--trace") {
+            tracePath = argv[i + 1];
+        }
+    }
+    std::unique_ptr<TraceSession> traceSession;
+    try {
+        traceSession = std::make_unique<TraceSession>(tracePath);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+
+    // UCI mode for tournament managers and GUIs: --uci [--nnue <weights file>]
+    if (std::find(argv + 1, argv + argc, string("--uci")) != argv + argc) {
+        UciEngine engine(std::cin, cout);
+        for (int i = 1; i + 1 < argc; i++) {
+            if (string(argv[i]) == "--nnue") {
+                try {
+                    engine.setNetwork(std::make_shared<const NnueNetwork>(argv[i + 1]));
+                }
+                catch (const std::runtime_error& e) {
+                    std::cerr << e.what() << endl;
+                    return 1;
+                }
+            }
+        }
+        try {
+            engine.setTablebases(loadTablebases(argc, argv));
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+        engine.run();
+        return 0;
+    }
+
+    // Headless mode: --replay <file or -> [--recommend <depth>]
+    string replayPath;
+    int recommendDepth = 0;
+    try {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (string(argv[i]) == "--replay") {
+                replayPath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--recommend") {
+                recommendDepth = static_cast<int>(parseNumber(argv[i], argv[i + 1], 0, ChessUtils::MAX_SEARCH_PLY));
+            }
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+    if (!replayPath.empty()) {
+        return runReplay(replayPath, recommendDepth);
+    }
+
+    // Offline modes: --batch <file> | --batch-search <file> [--nnue <weights file>], --epd <file> [--depth <n> | --perft <n>],
+    // --pgn <file>, --generate-tablebase <signature> [--tablebases <directory>],
+    // --match <games> [--engine1 <spec>] [--engine2 <spec>] [--opening-plies <n>] [--seed <number>]
+    // [--sprt-elo0 <elo>] [--sprt-elo1 <elo>]
+    // --server unix:<path> | tcp:<port> [--hash <MB>] [--nnue <weights file>] [--tablebases <directory>]
+    // --threads <count> applies to the offline modes and to the move recommendations
+    string batchPath;
+    BatchMode batchMode = BatchMode::STATIC;
+    string networkPath;
+    string epdPath;
+    EpdMode epdMode = EpdMode::SEARCH;
+    int epdDepth = 3;
+    string pgnPath;
+    string tablebaseSignature;
+    string tablebaseDirectory = ".";
+    size_t threadCount = 0;
+    MatchSettings matchSettings;
+    string firstEngineSpec;
+    string secondEngineSpec;
+    string serverAddress;
+    size_t hashMb = ChessUtils::TRANSPOSITION_TABLE_SIZE_MB;
+    try {
+        for (int i = 1; i + 1 < argc; i++) {
+            if (string(argv[i]) == "--batch" || string(argv[i]) == "--batch-search") {
+                batchMode = string(argv[i]) == "--batch" ? BatchMode::STATIC : BatchMode::SEARCH;
+                batchPath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--nnue") {
+                networkPath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--epd") {
+                epdPath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--depth" || string(argv[i]) == "--perft") {
+                epdMode = string(argv[i]) == "--depth" ? EpdMode::SEARCH : EpdMode::PERFT;
+                epdDepth = static_cast<int>(parseNumber(argv[i], argv[i + 1], 1, ChessUtils::MAX_SEARCH_PLY));
+            }
+            else if (string(argv[i]) == "--generate-tablebase") {
+                tablebaseSignature = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--tablebases") {
+                tablebaseDirectory = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--pgn") {
+                pgnPath = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--threads") {
+                threadCount = static_cast<size_t>(parseNumber(argv[i], argv[i + 1], 1, ChessUtils::MAX_THREAD_COUNT));
+            }
+            else if (string(argv[i]) == "--server") {
+                serverAddress = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--hash") {
+                hashMb = static_cast<size_t>(parseNumber(argv[i], argv[i + 1], 1,
+                    ChessUtils::MAX_TRANSPOSITION_TABLE_SIZE_MB));
+            }
+            else if (string(argv[i]) == "--match") {
+                matchSettings.gameCount = static_cast<size_t>(parseNumber(argv[i], argv[i + 1], 1, MAX_MATCH_GAMES));
+            }
+            else if (string(argv[i]) == "--engine1" || string(argv[i]) == "--engine2") {
+                (string(argv[i]) == "--engine1" ? firstEngineSpec : secondEngineSpec) = argv[i + 1];
+            }
+            else if (string(argv[i]) == "--opening-plies") {
+                matchSettings.openingPlies = static_cast<int>(parseNumber(argv[i], argv[i + 1], 0,
+                    ChessUtils::MAX_SEARCH_PLY));
+            }
+            else if (string(argv[i]) == "--seed") {
+                matchSettings.seed = static_cast<uint64_t>(parseNumber(argv[i], argv[i + 1], 0, INT64_MAX));
+            }
+            else if (string(argv[i]) == "--sprt-elo0" || string(argv[i]) == "--sprt-elo1") {
+                (string(argv[i]) == "--sprt-elo0" ? matchSettings.sprt.elo0 : matchSettings.sprt.elo1) =
+                    parseDecimal(argv[i], argv[i + 1], -MAX_SPRT_ELO, MAX_SPRT_ELO);
+            }
+        }
+        if (matchSettings.sprt.elo0 >= matchSettings.sprt.elo1) {
+            throw std::runtime_error("Error: --sprt-elo0 must be below --sprt-elo1");
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+    bool isMatch = std::find(argv + 1, argv + argc, string("--match")) != argv + argc;
+    if (!batchPath.empty()) {
+        return runBatch(batchPath, batchMode, threadCount, networkPath);
+    }
+    if (!epdPath.empty()) {
+        return runEpd(epdPath, epdMode, epdDepth, threadCount);
+    }
+    if (!pgnPath.empty()) {
+        return runPgn(pgnPath, threadCount);
+    }
+    if (!tablebaseSignature.empty()) {
+        return runTablebaseGeneration(tablebaseSignature, tablebaseDirectory, threadCount);
+    }
+    if (!serverAddress.empty()) {
+        return runServer(serverAddress, threadCount, hashMb, argc, argv);
+    }
+    if (isMatch) {
+        return runMatch(firstEngineSpec, secondEngineSpec, matchSettings, threadCount);
+    }
+
+    string board = ChessUtils::START_BOARD;
     Board chessBoard(board);
+    Chess a(chessBoard);
     MoveRecommender recommender(chessBoard, 2);
+    if (threadCount > 0) {
+        recommender.setThreadCount(threadCount);
+    }
+
+    // Options: --nnue <weights file>, --seed <number>, --no-random, --stats [--counters],
+    // --book <Polyglot .bin> --book-keys <Random64 table> [--book-best]
+    string bookPath;
+    string bookKeysPath;
+    BookSelection bookSelection = BookSelection::WEIGHTED;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--no-random") {
+            recommender.setRandomnessEnabled(false);
+        }
+        else if (string(argv[i]) == "--stats") {
+            recommender.setStatsPrinted(true);
+        }
+        else if (string(argv[i]) == "--counters") {
+            recommender.setHardwareCountersEnabled(true);
+        }
+        else if (string(argv[i]) == "--seed" && i + 1 < argc) {
+            try {
+                recommender.setSeed(static_cast<uint64_t>(parseNumber(argv[i], argv[i + 1], 0, INT64_MAX)));
+            }
+            catch (const std::runtime_error& e) {
+                std::cerr << e.what() << endl;
+                return 1;
+            }
+        }
+        else if (string(argv[i]) == "--nnue" && i + 1 < argc) {
+            try {
+                recommender.setNetwork(std::make_shared<const NnueNetwork>(argv[i + 1]));
+            }
+            catch (const std::runtime_error& e) {
+                std::cerr << e.what() << endl;
+                return 1;
+            }
+        }
+        else if (string(argv[i]) == "--book" && i + 1 < argc) {
+            bookPath = argv[i + 1];
+        }
+        else if (string(argv[i]) == "--book-keys" && i + 1 < argc) {
+            bookKeysPath = argv[i + 1];
+        }
+        else if (string(argv[i]) == "--book-best") {
+            bookSelection = BookSelection::BEST;
+        }
+    }
+    try {
+        recommender.setTablebases(loadTablebases(argc, argv));
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << endl;
+        return 1;
+    }
+    if (!bookPath.empty()) {
+        if (bookKeysPath.empty()) {
+            std::cerr << "Error: --book needs --book-keys, the Polyglot Random64 table" << endl;
+            return 1;
+        }
+        try {
+            recommender.setOpeningBook(std::make_shared<const OpeningBook>(bookPath, bookKeysPath), bookSelection);
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
     // Get and print the top 3 recommended moves before each turn
     recommender.recommendMoves();
     int codeResponse = 0;
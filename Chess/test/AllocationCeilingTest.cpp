@@ -0,0 +1,61 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include "Utils/AllocationTracker.h"
+#include <iostream>
+#include <string>
+
+namespace {
+    // Opening, middlegame with castling rights, tactical middlegame, pawn endgame
+    const char* POSITIONS[] = {
+        ChessUtils::START_FEN,
+        "r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    const int RECOMMEND_DEPTH = 2;
+    const int SEARCH_DEPTH = 3;
+
+    // Measured at about 1.2-1.6 for recommendMoves and 1.5-2.9 for the alpha-beta
+    // search, lower them as allocations are removed from the search
+    const double MAX_RECOMMEND_ALLOCATIONS_PER_NODE = 2.0;
+    const double MAX_SEARCH_ALLOCATIONS_PER_NODE = 4.0;
+
+    // Prints the allocations of the search, false when they exceed the ceiling
+    bool checkCeiling(const std::string& name, const SearchStats& stats, double maxPerNode) {
+        double perNode = stats.nodes > 0 ? static_cast<double>(stats.allocations.getTotalAllocations()) / stats.nodes : 0;
+        std::cout << name << ": ";
+        printAllocations(std::cout, stats.allocations, stats.nodes);
+        if (stats.nodes == 0 || perNode > maxPerNode) {
+            std::cerr << "Error: " << name << " makes " << perNode << " allocations per node, the ceiling is "
+                << maxPerNode << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+// Searches each position twice and checks the second search, once the caches and threads exist
+int main()
+{
+    bool isPassed = true;
+    for (const char* fen : POSITIONS) {
+        Board board(Fen::parse(fen));
+        MoveRecommender recommender(board, RECOMMEND_DEPTH);
+        recommender.setRandomnessEnabled(false);
+
+        recommender.recommendMoves();
+        recommender.recommendMoves();
+        isPassed &= checkCeiling(std::string("recommendMoves ") + fen, recommender.getSearchStats(),
+            MAX_RECOMMEND_ALLOCATIONS_PER_NODE);
+
+        SearchLimits limits;
+        limits.depth = SEARCH_DEPTH;
+        recommender.search(board, limits);
+        recommender.clearTranspositionTable();
+        recommender.search(board, limits);
+        isPassed &= checkCeiling(std::string("search ") + fen, recommender.getSearchStats(),
+            MAX_SEARCH_ALLOCATIONS_PER_NODE);
+    }
+    return isPassed ? 0 : 1;
+}
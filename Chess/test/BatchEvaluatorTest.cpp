@@ -0,0 +1,72 @@
+#include "Batch/BatchEvaluator.h"
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/MoveRecommender.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // Board strings and FENs with castling rights, en passant squares, pawn structure and exposed kings
+    const std::vector<std::string> POSITIONS = {
+        ChessUtils::START_BOARD,
+        std::string(ChessUtils::START_BOARD) + " b",
+        ChessUtils::START_FEN,
+        "r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 2",
+        "4k3/8/8/3pP3/8/8/8/4K3 w - - 0 2",
+        "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1",
+        "r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1",
+        "6k1/5ppp/8/8/8/1P6/P1PP4/6K1 b - - 0 1"
+    };
+    const int SEARCH_DEPTH = 1;
+
+    // Scores the batch with 3 threads and each position on its own, the two must agree
+    bool checkMode(BatchMode mode, const char* name) {
+        std::vector<int> scores(POSITIONS.size());
+        BatchEvaluator evaluator(3, SEARCH_DEPTH);
+        evaluator.evaluate(POSITIONS, scores, mode);
+
+        Board referenceBoard(ChessUtils::START_BOARD);
+        MoveRecommender reference(referenceBoard, SEARCH_DEPTH);
+        reference.setRandomnessEnabled(false);
+        bool isPassed = true;
+        for (size_t i = 0; i < POSITIONS.size(); i++) {
+            Board board(BatchEvaluator::parsePosition(POSITIONS[i]));
+            int expected = mode == BatchMode::STATIC ? reference.getStaticScore(board) :
+                reference.searchPosition(board, i);
+            if (scores[i] != expected) {
+                std::cerr << "Error: " << name << " batch scores " << POSITIONS[i] << " " << scores[i]
+                    << ", on its own " << expected << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+
+    // The FEN game state reaches the search: taking en passant wins a pawn the position without it can't
+    bool checkGameState() {
+        std::vector<std::string> positions = { POSITIONS[7], POSITIONS[8] };
+        std::vector<int> scores(positions.size());
+        BatchEvaluator evaluator(1, 1);
+        evaluator.evaluate(positions, scores, BatchMode::SEARCH);
+        if (scores[0] <= scores[1]) {
+            std::cerr << "Error: the en passant square is lost, " << scores[0] << " with it, "
+                << scores[1] << " without" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    bool isPassed = checkMode(BatchMode::STATIC, "static");
+    isPassed &= checkMode(BatchMode::SEARCH, "search");
+    isPassed &= checkGameState();
+    std::cout << (isPassed ? "batch scores match" : "batch scores differ") << std::endl;
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include "Core/ChessCoreApi.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Prints the failure, returns 0 */
+static int fail(const char* what)
+{
+    fprintf(stderr, "Error: %s (%s)\n", what, chess_last_error());
+    return 0;
+}
+
+/* Plays 1. e4 e5, rejects an illegal move and searches the position from C */
+static int checkPosition(void)
+{
+    char fen[128];
+    chess_limits limits = { 3, 0, 0 };
+    chess_recommendation recommendation;
+    int isPassed = 1;
+    chess_position* position = chess_position_create(NULL, 0);
+    if (!position) {
+        return fail("chess_position_create");
+    }
+
+    if (chess_position_apply_move(position, "e2e4") != CHESS_OK ||
+        chess_position_apply_move(position, "e7e5") != CHESS_OK) {
+        isPassed = fail("legal moves rejected");
+    }
+    if (chess_position_apply_move(position, "e4e6") != CHESS_ILLEGAL_MOVE) {
+        isPassed = fail("illegal move accepted");
+    }
+    if (chess_position_get_fen(position, fen, sizeof(fen)) != CHESS_OK ||
+        strcmp(fen, "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2") != 0) {
+        isPassed = fail("unexpected FEN");
+    }
+    if (chess_position_get_fen(position, fen, 8) != CHESS_ERROR) {
+        isPassed = fail("FEN written past the buffer size");
+    }
+    if (chess_recommend(position, &limits, &recommendation) != CHESS_OK ||
+        strlen(recommendation.best_move) < 4 || recommendation.depth != 3 || recommendation.nodes == 0) {
+        isPassed = fail("chess_recommend");
+    }
+    else {
+        printf("best move %s, score %d, %llu nodes\n", recommendation.best_move, recommendation.score,
+            (unsigned long long)recommendation.nodes);
+    }
+
+    chess_position_free(position);
+    return isPassed;
+}
+
+/* Mate in one for white, then the mated position without any move */
+static int checkMate(void)
+{
+    chess_limits limits = { 2, 0, 0 };
+    chess_recommendation recommendation;
+    int isPassed = 1;
+    chess_position* position = chess_position_create("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 0);
+    if (!position) {
+        return fail("chess_position_create");
+    }
+
+    if (chess_recommend(position, &limits, &recommendation) != CHESS_OK ||
+        strcmp(recommendation.best_move, "a1a8") != 0 || recommendation.score != CHESS_MATE_SCORE - 1) {
+        isPassed = fail("mate in one not found");
+    }
+    if (chess_position_apply_move(position, "a1a8") != CHESS_OK ||
+        chess_recommend(position, &limits, &recommendation) != CHESS_OK ||
+        recommendation.best_move[0] != '\0') {
+        isPassed = fail("move recommended when mated");
+    }
+
+    chess_position_free(position);
+    return isPassed;
+}
+
+int main(void)
+{
+    int isPassed = 1;
+    if (chess_position_create("not a fen", 0) != NULL || chess_last_error()[0] == '\0') {
+        isPassed = fail("malformed FEN accepted");
+    }
+    isPassed &= checkPosition();
+    isPassed &= checkMate();
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "MoveRecommender/FastRandom.h"
+#include "Nnue/NnueNetwork.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    // Start, Kiwipete (castling, en passant), and promotions for both sides
+    const char* POSITIONS[] = {
+        ChessUtils::START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    const int WALKS_PER_POSITION = 40;
+    const int WALK_LENGTH = 10;
+
+    // Writes a network of small random weights in the format NnueNetwork reads
+    void writeRandomNetwork(const std::string& path) {
+        FastRandom random(7);
+        auto randomValue = [&random](int magnitude) { return random.nextInt(2 * magnitude + 1) - magnitude; };
+        std::ofstream file(path, std::ios::binary);
+        auto write = [&file](auto value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+        file.write("CNUE", 4);
+        for (uint32_t value : { Nnue::FILE_VERSION, static_cast<uint32_t>(Nnue::FEATURE_COUNT),
+            static_cast<uint32_t>(Nnue::ACCUMULATOR_SIZE), static_cast<uint32_t>(Nnue::HIDDEN1_SIZE),
+            static_cast<uint32_t>(Nnue::HIDDEN2_SIZE) }) {
+            write(value);
+        }
+        // The feature biases, then one row of weights per feature
+        std::vector<int16_t> featureWeights(static_cast<size_t>(Nnue::FEATURE_COUNT + 1) * Nnue::ACCUMULATOR_SIZE);
+        std::generate(featureWeights.begin(), featureWeights.end(), [&]() { return static_cast<int16_t>(randomValue(16)); });
+        file.write(reinterpret_cast<const char*>(featureWeights.data()), featureWeights.size() * sizeof(int16_t));
+        for (int i = 0; i < Nnue::HIDDEN1_SIZE; i++) {
+            write(static_cast<int32_t>(randomValue(64)));
+        }
+        for (int i = 0; i < Nnue::HIDDEN1_SIZE * 2 * Nnue::ACCUMULATOR_SIZE; i++) {
+            write(static_cast<int8_t>(randomValue(8)));
+        }
+        for (int i = 0; i < Nnue::HIDDEN2_SIZE; i++) {
+            write(static_cast<int32_t>(randomValue(64)));
+        }
+        for (int i = 0; i < Nnue::HIDDEN2_SIZE * Nnue::HIDDEN1_SIZE; i++) {
+            write(static_cast<int8_t>(randomValue(8)));
+        }
+        write(static_cast<int32_t>(randomValue(64)));
+        for (int i = 0; i < Nnue::HIDDEN2_SIZE; i++) {
+            write(static_cast<int8_t>(randomValue(8)));
+        }
+    }
+
+    // The same position with the ranks flipped and the colors swapped, without castling or en passant
+    std::string mirrorFen(const std::string& fen) {
+        FenPosition position = Fen::parse(fen);
+        FenPosition mirrored;
+        mirrored.boardString.assign(ChessUtils::SQUARE_COUNT, '#');
+        for (int square = 0; square < ChessUtils::SQUARE_COUNT; square++) {
+            char symbol = position.boardString[square];
+            mirrored.boardString[Bitboards::mirrorSquare(square)] = std::isupper(static_cast<unsigned char>(symbol)) ?
+                static_cast<char>(std::tolower(symbol)) : static_cast<char>(std::toupper(symbol));
+        }
+        mirrored.isWhiteTurn = !position.isWhiteTurn;
+        return Fen::format(mirrored);
+    }
+
+    // The incremental accumulator against one rebuilt from the board's FEN
+    bool checkAccumulator(const Board& board, const std::shared_ptr<const NnueNetwork>& network,
+        const std::string& context) {
+        Board refreshed(Fen::parse(board.toFen()));
+        refreshed.setNetwork(network);
+        if (board.getAccumulator().values != refreshed.getAccumulator().values ||
+            board.getNetworkEvaluation() != refreshed.getNetworkEvaluation()) {
+            std::cerr << "Error: accumulator differs from a full refresh after " << context
+                << " at " << board.toFen() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Random legal move sequences, checked after every move and every undo
+    bool checkWalks(const char* fen, const std::shared_ptr<const NnueNetwork>& network, FastRandom& random) {
+        Board board(Fen::parse(fen));
+        board.setNetwork(network);
+        bool isPassed = checkAccumulator(board, network, "setNetwork");
+        std::vector<BoardMove> moves;
+        for (int walk = 0; walk < WALKS_PER_POSITION && isPassed; walk++) {
+            int played = 0;
+            for (; played < WALK_LENGTH && isPassed; played++) {
+                moves.clear();
+                board.generateLegalMoves(moves);
+                if (moves.empty()) {
+                    break;
+                }
+                board.makeMove(moves[random.nextInt(static_cast<int>(moves.size()))]);
+                isPassed = checkAccumulator(board, network, "makeMove");
+            }
+            for (; played > 0 && isPassed; played--) {
+                board.undoMove();
+                isPassed = checkAccumulator(board, network, "undoMove");
+            }
+        }
+        return isPassed;
+    }
+
+    // The network scores for the side to move, so a position and its mirror score the same
+    bool checkSideToMove(const char* fen, const std::shared_ptr<const NnueNetwork>& network) {
+        Board board(Fen::parse(fen));
+        Board mirrored(Fen::parse(mirrorFen(fen)));
+        board.setNetwork(network);
+        mirrored.setNetwork(network);
+        if (board.getNetworkEvaluation() != mirrored.getNetworkEvaluation()) {
+            std::cerr << "Error: " << fen << " scores " << board.getNetworkEvaluation()
+                << " for the side to move, its mirror " << mirrored.getNetworkEvaluation() << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+// Random make/undo walks with a random network must keep the accumulator equal to a full refresh
+int main()
+{
+    std::string path = (std::filesystem::temp_directory_path() / "chess_nnue_accumulator_test.bin").string();
+    writeRandomNetwork(path);
+    auto network = std::make_shared<const NnueNetwork>(path);
+    std::remove(path.c_str());
+
+    FastRandom random(1);
+    bool isPassed = true;
+    for (const char* fen : POSITIONS) {
+        isPassed &= checkWalks(fen, network, random);
+        isPassed &= checkSideToMove(fen, network);
+    }
+    std::cout << (isPassed ? "accumulators match" : "accumulators differ") << std::endl;
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Board/MoveNotation.h"
+#include "Book/OpeningBook.h"
+#include "MoveRecommender/FastRandom.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    using Keys = std::array<uint64_t, Polyglot::KEY_COUNT>;
+
+    struct KeyCase {
+        const char* fen;
+        uint64_t key;
+    };
+
+    // The published Polyglot test positions: 1. e4 d5 2. e5 f5 3. Ke2 Kf7, and 1. a4 b5 2. h4 b4 3. c4 bxc3 4. Ra3
+    const KeyCase PUBLISHED_KEYS[] = {
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9cULL },
+        { "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196ULL },
+        { "rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0ULL },
+        { "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4ULL },
+        { "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78ULL },
+        { "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1ULL },
+        { "rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9ULL },
+        { "rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637ULL },
+        { "rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560ULL }
+    };
+
+    struct BookEntry {
+        const char* fen;
+        const char* move;
+        uint16_t weight;
+    };
+
+    const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const char* CASTLING_FEN = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+    const char* BLACK_CASTLING_FEN = "r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1";
+    const char* PROMOTION_FEN = "7k/4P3/8/8/8/8/8/4K3 w - - 0 1";
+
+    // Moves as Polyglot writes them: castling is the king taking its rook
+    const BookEntry BOOK_ENTRIES[] = {
+        { START_FEN, "d2d4", 1 },
+        { START_FEN, "e2e4", 3 },
+        { CASTLING_FEN, "e1h1", 5 },
+        { CASTLING_FEN, "a1a8", 1 },
+        { BLACK_CASTLING_FEN, "e8a8", 2 },
+        { PROMOTION_FEN, "e7e8q", 1 }
+    };
+
+    struct ProbeCase {
+        const char* fen;
+        BookSelection selection;
+        uint64_t randomValue;
+        // UCI notation of the move, nullptr when the position is out of book
+        const char* expected;
+    };
+
+    // The start position has weights 1 and 3 in that order: draws 0 mod 4 take d2d4, the rest e2e4
+    const ProbeCase PROBE_CASES[] = {
+        { START_FEN, BookSelection::BEST, 0, "e2e4" },
+        { START_FEN, BookSelection::WEIGHTED, 0, "d2d4" },
+        { START_FEN, BookSelection::WEIGHTED, 1, "e2e4" },
+        { START_FEN, BookSelection::WEIGHTED, 3, "e2e4" },
+        { START_FEN, BookSelection::WEIGHTED, 8, "d2d4" },
+        { CASTLING_FEN, BookSelection::BEST, 0, "e1g1" },
+        { CASTLING_FEN, BookSelection::WEIGHTED, 5, "a1a8" },
+        { BLACK_CASTLING_FEN, BookSelection::BEST, 0, "e8c8" },
+        { PROMOTION_FEN, BookSelection::BEST, 0, "e7e8q" },
+        { "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", BookSelection::BEST, 0, nullptr }
+    };
+
+    Keys makeKeys(uint64_t seed) {
+        FastRandom random(seed);
+        Keys keys;
+        for (uint64_t& key : keys) {
+            key = random.next();
+        }
+        return keys;
+    }
+
+    uint64_t getKey(const OpeningBook& book, const char* fen) {
+        return book.getKey(Board(Fen::parse(fen)));
+    }
+
+    // destination file and rank, source file and rank, promotion (none, N, B, R, Q): 3 bits each
+    uint16_t encodeMove(const char* uci) {
+        BoardMove move;
+        if (!MoveNotation::parse(uci, move)) {
+            throw std::runtime_error(std::string("Error: bad test move ") + uci);
+        }
+        const int promotions[] = { ChessUtils::NO_PROMOTION, ChessUtils::KNIGHT_INDEX, ChessUtils::BISHOP_INDEX,
+            ChessUtils::ROOK_INDEX, ChessUtils::QUEEN_INDEX };
+        int promotion = static_cast<int>(std::find(promotions, promotions + 5, move.promotionIndex) - promotions);
+        return static_cast<uint16_t>(move.destCol | (move.destRow << 3) | (move.srcCol << 6) | (move.srcRow << 9) |
+            (promotion << 12));
+    }
+
+    void writeBigEndian(std::ofstream& out, uint64_t value, size_t bytes) {
+        for (size_t i = bytes; i-- > 0;) {
+            out.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    // Entries sorted by key as Polyglot requires, the order within a key is kept
+    void writeBook(const std::filesystem::path& path, const OpeningBook& keyBook) {
+        std::vector<std::pair<uint64_t, const BookEntry*>> entries;
+        for (const BookEntry& entry : BOOK_ENTRIES) {
+            entries.emplace_back(getKey(keyBook, entry.fen), &entry);
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const auto& left, const auto& right) { return left.first < right.first; });
+
+        std::ofstream out(path, std::ios::binary);
+        for (const auto& [key, entry] : entries) {
+            writeBigEndian(out, key, sizeof(uint64_t));
+            writeBigEndian(out, encodeMove(entry->move), sizeof(uint16_t));
+            writeBigEndian(out, entry->weight, sizeof(uint16_t));
+            writeBigEndian(out, 0, sizeof(uint32_t));
+        }
+    }
+
+    bool checkKeyParts(const OpeningBook& book, const Keys& keys) {
+        struct KeyPart {
+            const char* fen;
+            const char* otherFen;
+            // The key that tells the two positions apart, 0 when they hash the same
+            uint64_t difference;
+        };
+        const KeyPart parts[] = {
+            // Piece kinds alternate black and white, squares count from a1: white king 11, black king 10, white knight 3
+            { "4k3/8/8/8/8/8/8/4K3 b - - 0 1", "4k3/8/8/8/8/8/8/3K4 b - - 0 1",
+                keys[11 * ChessUtils::SQUARE_COUNT + 4] ^ keys[11 * ChessUtils::SQUARE_COUNT + 3] },
+            { "4k3/8/8/8/8/8/8/4K3 b - - 0 1", "3k4/8/8/8/8/8/8/4K3 b - - 0 1",
+                keys[10 * ChessUtils::SQUARE_COUNT + 60] ^ keys[10 * ChessUtils::SQUARE_COUNT + 59] },
+            { "4k3/8/8/8/8/8/8/1N2K3 b - - 0 1", "4k3/8/8/8/8/8/8/4K3 b - - 0 1", keys[3 * ChessUtils::SQUARE_COUNT + 1] },
+            { START_FEN, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1", keys[Polyglot::TURN_KEY] },
+            // Losing each castling right: white short, white long, black short, black long
+            { START_FEN, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Qkq - 0 1", keys[Polyglot::CASTLING_KEYS] },
+            { START_FEN, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Kkq - 0 1", keys[Polyglot::CASTLING_KEYS + 1] },
+            { START_FEN, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQq - 0 1", keys[Polyglot::CASTLING_KEYS + 2] },
+            { START_FEN, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQk - 0 1", keys[Polyglot::CASTLING_KEYS + 3] },
+            // The en passant file counts only when a pawn can take: not after 1. e4, but after 2... f5
+            { "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+                "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1", 0 },
+            { "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+                "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3", keys[Polyglot::EN_PASSANT_KEYS + 5] }
+        };
+
+        bool isPassed = true;
+        for (const KeyPart& part : parts) {
+            uint64_t difference = getKey(book, part.fen) ^ getKey(book, part.otherFen);
+            if (difference != part.difference) {
+                std::cerr << "Error: " << part.fen << " and " << part.otherFen << " differ by " << std::hex
+                    << difference << ", expected " << part.difference << std::dec << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+
+    bool checkProbes(const OpeningBook& book) {
+        bool isPassed = book.getEntryCount() == std::size(BOOK_ENTRIES);
+        if (!isPassed) {
+            std::cerr << "Error: the book has " << book.getEntryCount() << " entries, expected "
+                << std::size(BOOK_ENTRIES) << std::endl;
+        }
+        for (const ProbeCase& probeCase : PROBE_CASES) {
+            BoardMove move;
+            bool isFound = book.probe(Board(Fen::parse(probeCase.fen)), probeCase.selection, probeCase.randomValue,
+                move);
+            BoardMove expected;
+            bool isExpected = probeCase.expected && MoveNotation::parse(probeCase.expected, expected);
+            if (isFound != isExpected || (isFound && move != expected)) {
+                std::cerr << "Error: " << probeCase.fen << " draw " << probeCase.randomValue << " probes as "
+                    << (isFound ? MoveNotation::format(move) : std::string("nothing")) << ", expected "
+                    << (probeCase.expected ? probeCase.expected : "nothing") << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+
+    // Only a real Random64 table passes, so a made up one must be refused
+    bool checkKeysFileRefused(const std::filesystem::path& path, const Keys& keys) {
+        {
+            std::ofstream out(path);
+            for (uint64_t key : keys) {
+                out << "0x" << std::hex << key << ",\n";
+            }
+        }
+        try {
+            OpeningBook::readKeys(path.string());
+        }
+        catch (const std::runtime_error&) {
+            return true;
+        }
+        std::cerr << "Error: a random key table was taken for the Random64 one" << std::endl;
+        return false;
+    }
+
+    // The table itself is not shipped, CHESS_POLYGLOT_KEYS names a copy of it
+    bool checkPublishedKeys(const std::filesystem::path& emptyBook) {
+        const char* keysPath = std::getenv("CHESS_POLYGLOT_KEYS");
+        if (!keysPath) {
+            std::cout << "CHESS_POLYGLOT_KEYS is not set, the published hashes are not checked" << std::endl;
+            return true;
+        }
+        OpeningBook book(emptyBook.string(), keysPath);
+        bool isPassed = true;
+        for (const KeyCase& keyCase : PUBLISHED_KEYS) {
+            uint64_t key = getKey(book, keyCase.fen);
+            if (key != keyCase.key) {
+                std::cerr << "Error: " << keyCase.fen << " hashes to " << std::hex << key << ", expected "
+                    << keyCase.key << std::dec << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+}
+
+// Hashes and probes a book written here with a random key table, and the published hashes when the real table is given
+int main()
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_opening_book_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::filesystem::path emptyBook = directory / "empty.bin";
+    std::ofstream(emptyBook, std::ios::binary).close();
+
+    bool isPassed = true;
+    try {
+        Keys keys = makeKeys(781);
+        OpeningBook keyBook(emptyBook.string(), keys);
+        isPassed &= checkKeyParts(keyBook, keys);
+
+        writeBook(directory / "book.bin", keyBook);
+        OpeningBook book((directory / "book.bin").string(), keys);
+        isPassed &= checkProbes(book);
+
+        isPassed &= checkKeysFileRefused(directory / "keys.txt", keys);
+        isPassed &= checkPublishedKeys(emptyBook);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        isPassed = false;
+    }
+    std::filesystem::remove_all(directory);
+
+    std::cout << (isPassed ? "book probes match" : "book probes differ") << std::endl;
+    return isPassed ? 0 : 1;
+}
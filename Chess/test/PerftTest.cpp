@@ -0,0 +1,112 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Board/MoveNotation.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+namespace {
+    struct PerftCase {
+        const char* fen;
+        int depth;
+        uint64_t leafCount;
+    };
+
+    // The standard perft positions: start, Kiwipete and positions 3 to 5 of the chessprogramming wiki
+    const PerftCase PERFT_CASES[] = {
+        { ChessUtils::START_FEN, 4, 197281 },
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+        { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238 },
+        { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467 },
+        { "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 3, 9467 },
+        { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379 }
+    };
+
+    // FENs that must come back unchanged, every field set
+    const char* ROUND_TRIP_FENS[] = {
+        ChessUtils::START_FEN,
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b Kq - 3 17",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "4k3/8/8/8/8/8/8/4K3 b - - 99 120"
+    };
+
+    bool checkPerft(const PerftCase& perftCase) {
+        Board board(Fen::parse(perftCase.fen));
+        auto start = std::chrono::steady_clock::now();
+        uint64_t leafCount = board.perft(perftCase.depth);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "perft " << perftCase.depth << " " << perftCase.fen << ": " << leafCount << " ("
+            << static_cast<long long>(elapsed.count() * 1000) << "ms)" << std::endl;
+
+        if (leafCount != perftCase.leafCount) {
+            std::cerr << "Error: expected " << perftCase.leafCount << " leaves" << std::endl;
+            return false;
+        }
+        // Every move made during the count must have been taken back
+        if (board.toFen() != Fen::format(Fen::parse(perftCase.fen))) {
+            std::cerr << "Error: perft left the board at " << board.toFen() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool checkRoundTrip(const std::string& fen) {
+        std::string formatted = Fen::format(Fen::parse(fen));
+        std::string fromBoard = Board(Fen::parse(fen)).toFen();
+        if (formatted != fen || fromBoard != fen) {
+            std::cerr << "Error: " << fen << " comes back as " << formatted << " (Fen::format) and "
+                << fromBoard << " (Board::toFen)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // The game state fields follow the moves: en passant square, castling rights and both clocks
+    bool checkMoveState() {
+        Board board(Fen::parse("r3k2r/8/8/8/4p3/8/3P4/R3K2R w KQkq - 5 10"));
+        const char* moves[] = { "d2d4", "e4d3", "a1a2", "h8h2" };
+        const char* expected[] = {
+            "r3k2r/8/8/8/3Pp3/8/8/R3K2R b KQkq d3 0 10",
+            "r3k2r/8/8/8/8/3p4/8/R3K2R w KQkq - 0 11",
+            "r3k2r/8/8/8/8/3p4/R7/4K2R b Kkq - 1 11",
+            "r3k3/8/8/8/8/3p4/R6r/4K2R w Kq - 2 12"
+        };
+        bool isPassed = true;
+        for (size_t i = 0; i < std::size(moves); i++) {
+            BoardMove move;
+            MoveNotation::parse(moves[i], move);
+            board.makeMove(move);
+            if (board.toFen() != expected[i]) {
+                std::cerr << "Error: after " << moves[i] << " the FEN is "
+                    << board.toFen() << ", expected " << expected[i] << std::endl;
+                isPassed = false;
+            }
+        }
+        for (size_t i = 0; i < std::size(moves); i++) {
+            board.undoMove();
+        }
+        if (board.toFen() != "r3k2r/8/8/8/4p3/8/3P4/R3K2R w KQkq - 5 10") {
+            std::cerr << "Error: undoing every move gives " << board.toFen() << std::endl;
+            isPassed = false;
+        }
+        return isPassed;
+    }
+}
+
+// Locks down move generation with the known perft counts and FEN import/export with round trips
+int main()
+{
+    bool isPassed = true;
+    for (const PerftCase& perftCase : PERFT_CASES) {
+        isPassed &= checkPerft(perftCase);
+    }
+    for (const char* fen : ROUND_TRIP_FENS) {
+        isPassed &= checkRoundTrip(fen);
+    }
+    isPassed &= checkMoveState();
+    return isPassed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Board/MoveNotation.h"
+#include "Pgn/PgnReader.h"
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+    struct SanCase {
+        const char* fen;
+        const char* san;
+        // UCI notation of the move it names, nullptr when it names none or more than one
+        const char* expected;
+    };
+
+    const char* KNIGHTS_FEN = "7k/8/8/8/8/8/8/1N3N1K w - - 0 1";
+    const char* ROOKS_FEN = "7k/4P3/8/R7/8/8/8/R3K3 w - - 0 1";
+    const char* PROMOTION_FEN = "3r3k/4P3/8/8/8/8/8/7K w - - 0 1";
+    const char* CASTLING_FEN = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+
+    const SanCase SAN_CASES[] = {
+        { KNIGHTS_FEN, "Nd2", nullptr },
+        { KNIGHTS_FEN, "Nbd2", "b1d2" },
+        { KNIGHTS_FEN, "Nfd2", "f1d2" },
+        { KNIGHTS_FEN, "Nfd2!?", "f1d2" },
+        { ROOKS_FEN, "Ra3", nullptr },
+        { ROOKS_FEN, "R1a3", "a1a3" },
+        { ROOKS_FEN, "R5a3", "a5a3" },
+        { ROOKS_FEN, "Ra7", "a5a7" },
+        { ROOKS_FEN, "Ra5a7", "a5a7" },
+        { ROOKS_FEN, "Rf1", nullptr },
+        { PROMOTION_FEN, "e8=Q+", "e7e8q" },
+        { PROMOTION_FEN, "e8R+", "e7e8r" },
+        { PROMOTION_FEN, "e8", "e7e8q" },
+        { PROMOTION_FEN, "exd8=N", "e7d8n" },
+        { PROMOTION_FEN, "exd8=B", "e7d8b" },
+        { PROMOTION_FEN, "Kg2", "h1g2" },
+        { PROMOTION_FEN, "Kg2=Q", nullptr },
+        { CASTLING_FEN, "O-O", "e1g1" },
+        { CASTLING_FEN, "0-0-0", "e1c1" },
+        { CASTLING_FEN, "O-O-O+", "e1c1" },
+        { CASTLING_FEN, "Rxa8+", "a1a8" },
+        { CASTLING_FEN, "Rxh8#", "h1h8" }
+    };
+
+    // Games 1 and 2 and games 3 and 4 have no blank line between them, game 2 has a
+    // comment line that starts like a tag, game 4 CRLF line ends and game 5 an illegal
+    // third move
+    const std::string ARCHIVE =
+        "\xEF\xBB\xBF[Event \"Scholar\"]\n"
+        "[Result \"1-0\"]\n"
+        "\n"
+        "1. e4 e5 2. Bc4 Nc6 3. Qh5 Nf6?? 4. Qxf7# 1-0\n"
+        "[Event \"Disambiguation\"]\n"
+        "[Result \"*\"]\n"
+        "1. Nf3 Nf6 2. Nc3 Nc6 3. Nd4 Nd5 4. Ndb5 Ndb4 5. a3 a6 {a wrapped\n"
+        "[%clk 0:01:00] [comment]} 6. axb4 axb5 (6... Nxc2+ 7. Kd1) 7. Nxb5 Rxa1 *\n"
+        "\n"
+        "[Event \"Promotion\"]\n"
+        "[FEN \"" + std::string(ROOKS_FEN) + "\"]\n"
+        "\n"
+        "1. R1a3 Kg7 2. e8=N+ Kf8 3. Nd6 Kg7 4. Ra7+ Kg6 *\n"
+        "[Event \"Castling\"]\r\n"
+        "[Result \"1/2-1/2\"]\r\n"
+        "\r\n"
+        "1. d4 d5 2. Nc3 Nc6 3. Bf4 Bf5 4. Qd2 Qd7 5. O-O-O O-O-O 1/2-1/2\r\n"
+        "\r\n"
+        "[Event \"Bad\"]\n"
+        "1. e4 e5 2. Ke3 Nc6 *\n";
+    const uint64_t GAME_COUNT = 5;
+    const uint64_t PLY_COUNT = 7 + 14 + 8 + 10 + 2;
+
+    bool checkSan() {
+        bool isPassed = true;
+        for (const SanCase& sanCase : SAN_CASES) {
+            Board board(Fen::parse(sanCase.fen));
+            BoardMove move;
+            bool isParsed = PgnReader::parseSan(board, sanCase.san, move);
+            BoardMove expected;
+            bool isExpected = sanCase.expected && MoveNotation::parse(sanCase.expected, expected);
+            if (isParsed != isExpected || (isParsed && move != expected)) {
+                std::cerr << "Error: " << sanCase.san << " in " << sanCase.fen << " reads as "
+                    << (isParsed ? MoveNotation::format(move) : std::string("nothing")) << ", expected "
+                    << (sanCase.expected ? sanCase.expected : "nothing") << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+
+    // The split into games and the error must not depend on how the archive is cut into chunks
+    bool checkArchive(size_t threadCount) {
+        PgnReader reader(threadCount);
+        reader.read(std::string_view(ARCHIVE));
+        bool isPassed = reader.getGameCount() == GAME_COUNT && reader.getPlyCount() == PLY_COUNT;
+        if (!isPassed) {
+            std::cerr << "Error: " << threadCount << " threads read " << reader.getGameCount() << " games and "
+                << reader.getPlyCount() << " plies, expected " << GAME_COUNT << " and " << PLY_COUNT << std::endl;
+        }
+
+        const std::vector<PgnError>& errors = reader.getErrors();
+        size_t badOffset = ARCHIVE.find("[Event \"Bad\"]");
+        if (errors.size() != 1 || errors[0].gameNumber != GAME_COUNT || errors[0].offset != badOffset ||
+            errors[0].ply != 3 || errors[0].token != "Ke3") {
+            std::cerr << "Error: " << threadCount << " threads report " << errors.size() << " errors";
+            for (const PgnError& error : errors) {
+                std::cerr << ", game " << error.gameNumber << " offset " << error.offset << " ply " << error.ply
+                    << " " << error.token;
+            }
+            std::cerr << "; expected game " << GAME_COUNT << " offset " << badOffset << " ply 3 Ke3" << std::endl;
+            isPassed = false;
+        }
+        return isPassed;
+    }
+}
+
+int main()
+{
+    bool isPassed = checkSan();
+    isPassed &= checkArchive(1);
+    isPassed &= checkArchive(3);
+    std::cout << (isPassed ? "pgn games replay" : "pgn games differ") << std::endl;
+    return isPassed ? 0 : 1;
+}
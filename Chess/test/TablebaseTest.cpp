@@ -0,0 +1,125 @@
+#include "Board/Board.h"
+#include "Board/Fen.h"
+#include "Tablebase/TablebaseGenerator.h"
+#include "Tablebase/TablebaseLayout.h"
+#include "Tablebase/Tablebases.h"
+#include "Utils/MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+    struct LongestMate {
+        const char* signature;
+        int distance;
+    };
+
+    // Longest mates in plies, the side to move losing: KQK mates in 10 moves, KRK in 16 and KPK in 28
+    const LongestMate LONGEST_MATES[] = {
+        { "KQK", 20 },
+        { "KRK", 32 },
+        { "KBK", 0 },
+        { "KNK", 0 },
+        { "KPK", 56 }
+    };
+
+    struct ProbeCase {
+        const char* fen;
+        int outcome;
+        int distance;
+    };
+
+    const ProbeCase PROBE_CASES[] = {
+        // Rh8#, and the position after it
+        { "k7/8/1K6/8/8/8/8/7R w - - 0 1", Tablebase::WDL_WIN, 1 },
+        { "k6R/8/1K6/8/8/8/8/8 b - - 0 1", Tablebase::WDL_LOSS, 0 },
+        // The same with the colors swapped, black is the stronger side
+        { "K7/8/1k6/8/8/8/8/7r b - - 0 1", Tablebase::WDL_WIN, 1 },
+        // Stalemates
+        { "k7/1R6/1K6/8/8/8/8/8 b - - 0 1", Tablebase::WDL_DRAW, 0 },
+        { "4k3/4P3/4K3/8/8/8/8/8 b - - 0 1", Tablebase::WDL_DRAW, 0 },
+        // c8=Q#, the promotion leads into KQK
+        { "k7/2P5/1K6/8/8/8/8/8 w - - 0 1", Tablebase::WDL_WIN, 1 },
+        { "k1Q5/8/1K6/8/8/8/8/8 b - - 0 1", Tablebase::WDL_LOSS, 0 }
+    };
+
+    // Largest distance in a .dtm file, read back as Tablebases would
+    int readLongestMate(const std::string& path) {
+        MappedFile file(path);
+        std::string_view values = file.getContents().substr(Tablebase::HEADER_SIZE);
+        int longest = 0;
+        for (char symbol : values) {
+            uint8_t value = static_cast<uint8_t>(symbol);
+            if (Tablebase::isWin(value)) {
+                longest = std::max<int>(longest, value);
+            }
+            else if (Tablebase::isLoss(value)) {
+                longest = std::max<int>(longest, value - Tablebase::LOSS_BASE);
+            }
+        }
+        return longest;
+    }
+
+    bool checkLongestMates(const std::filesystem::path& directory) {
+        bool isPassed = true;
+        for (const LongestMate& mate : LONGEST_MATES) {
+            int longest = readLongestMate((directory / (std::string(mate.signature) + ".dtm")).string());
+            if (longest != mate.distance) {
+                std::cerr << "Error: the longest " << mate.signature << " mate is " << longest << " plies, expected "
+                    << mate.distance << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+
+    bool checkProbes(const Tablebases& tablebases) {
+        bool isPassed = true;
+        for (const ProbeCase& probeCase : PROBE_CASES) {
+            Board board(Fen::parse(probeCase.fen));
+            TablebaseResult result;
+            if (!tablebases.probe(board, result)) {
+                std::cerr << "Error: no table covers " << probeCase.fen << std::endl;
+                isPassed = false;
+            }
+            else if (result.outcome != probeCase.outcome || result.distance != probeCase.distance) {
+                std::cerr << "Error: " << probeCase.fen << " probes as outcome " << result.outcome << " in "
+                    << result.distance << " plies, expected " << probeCase.outcome << " in " << probeCase.distance
+                    << std::endl;
+                isPassed = false;
+            }
+        }
+        return isPassed;
+    }
+}
+
+// Generates KPK and the tables it leads into, then checks the known longest mates and a few probes
+int main()
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_tablebase_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    bool isPassed = true;
+    try {
+        std::ostringstream log;
+        TablebaseGenerator generator(log, 2);
+        generator.generate("KPK", directory.string());
+        isPassed &= checkLongestMates(directory);
+        Tablebases tablebases(directory.string());
+        isPassed &= checkProbes(tablebases);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        isPassed = false;
+    }
+    std::filesystem::remove_all(directory);
+
+    std::cout << (isPassed ? "tablebases match" : "tablebases differ") << std::endl;
+    return isPassed ? 0 : 1;
+}